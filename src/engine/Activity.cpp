@@ -0,0 +1,126 @@
+#include "Activity.h"
+#include "Renderer2D.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Erlik {
+
+    void ActivityMap::clear()
+    {
+        m_cols = m_rows = 0;
+        m_roomCount = 0;
+        m_cellRegion.clear(); m_rooms.clear();
+        m_awake.clear(); m_stamp.clear(); m_sleptAt.clear();
+        m_awakeList.clear(); m_next.clear(); m_woke.clear(); m_slept.clear();
+        ++m_version;
+    }
+
+    void ActivityMap::build(float worldW, float worldH, const std::vector<ActivityRoom>& rooms, float cellPx)
+    {
+        clear();
+        m_cell = std::max(32.f, cellPx);
+        m_cols = std::max(1, (int)std::ceil(worldW / m_cell));
+        m_rows = std::max(1, (int)std::ceil(worldH / m_cell));
+        m_cellRegion.assign((size_t)m_cols * m_rows, -1);
+
+        for (const ActivityRoom& r : rooms)
+            if (r.w > 0.f && r.h > 0.f) m_rooms.push_back(r);
+        m_roomCount = (int)m_rooms.size();
+
+        // Hucre merkezi ilk kapsayan odaya; merkez yakalamayan kucuk odalar kendi merkez hucresini alir
+        for (int cy = 0; cy < m_rows; ++cy)
+            for (int cx = 0; cx < m_cols; ++cx) {
+                const float px = (cx + 0.5f) * m_cell, py = (cy + 0.5f) * m_cell;
+                for (int k = 0; k < m_roomCount; ++k) {
+                    const ActivityRoom& r = m_rooms[k];
+                    if (px >= r.x && px < r.x + r.w && py >= r.y && py < r.y + r.h) {
+                        m_cellRegion[(size_t)cy * m_cols + cx] = k; break;
+                    }
+                }
+            }
+        for (int k = 0; k < m_roomCount; ++k) {
+            const ActivityRoom& r = m_rooms[k];
+            const int cx = std::clamp((int)((r.x + r.w * 0.5f) / m_cell), 0, m_cols - 1);
+            const int cy = std::clamp((int)((r.y + r.h * 0.5f) / m_cell), 0, m_rows - 1);
+            int& c = m_cellRegion[(size_t)cy * m_cols + cx];
+            if (c < 0) c = k;
+        }
+        int next = m_roomCount;
+        for (int& c : m_cellRegion) if (c < 0) c = next++;
+
+        // Baslangicta her sey uyur; ilk update kameranin cevresini sifir uyku suresiyle uyandirir
+        m_awake.assign(next, 0);
+        m_stamp.assign(next, 0);
+        m_sleptAt.assign(next, m_now);
+        m_frame = 0;
+    }
+
+    void ActivityMap::adopt(ActivityMap&& built)
+    {
+        const uint32_t version = m_version;
+        const double now = m_now;
+        *this = std::move(built);
+        m_version = version + 1;
+        m_now = now;
+        std::fill(m_sleptAt.begin(), m_sleptAt.end(), now);
+    }
+
+    int ActivityMap::regionAt(float x, float y) const
+    {
+        if (m_cellRegion.empty()) return -1;
+        const int cx = std::clamp((int)std::floor(x / m_cell), 0, m_cols - 1);
+        const int cy = std::clamp((int)std::floor(y / m_cell), 0, m_rows - 1);
+        return m_cellRegion[(size_t)cy * m_cols + cx];
+    }
+
+    void ActivityMap::update(float x0, float y0, float x1, float y1, double now)
+    {
+        m_now = now;
+        m_woke.clear(); m_slept.clear();
+        if (m_cellRegion.empty()) return;
+
+        if (++m_frame == 0) { std::fill(m_stamp.begin(), m_stamp.end(), 0u); m_frame = 1; }
+        const int cx0 = std::clamp((int)std::floor(x0 / m_cell), 0, m_cols - 1);
+        const int cy0 = std::clamp((int)std::floor(y0 / m_cell), 0, m_rows - 1);
+        const int cx1 = std::clamp((int)std::floor(x1 / m_cell), 0, m_cols - 1);
+        const int cy1 = std::clamp((int)std::floor(y1 / m_cell), 0, m_rows - 1);
+
+        m_next.clear();
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const int r = m_cellRegion[(size_t)cy * m_cols + cx];
+                if (m_stamp[r] == m_frame) continue;
+                m_stamp[r] = m_frame;
+                m_next.push_back(r);
+                if (!m_awake[r]) { m_awake[r] = 1; m_woke.push_back(r); }
+            }
+        for (int r : m_awakeList)
+            if (m_stamp[r] != m_frame) { m_awake[r] = 0; m_sleptAt[r] = now; m_slept.push_back(r); }
+        m_awakeList.swap(m_next);
+    }
+
+    void ActivityMap::drawDebug(Renderer2D& r2d) const
+    {
+        if (m_cellRegion.empty()) return;
+        int vw, vh; r2d.outputSize(vw, vh);
+        const Camera2D& cam = r2d.camera();
+        const int cx0 = std::clamp((int)std::floor(cam.x / m_cell), 0, m_cols - 1);
+        const int cy0 = std::clamp((int)std::floor(cam.y / m_cell), 0, m_rows - 1);
+        const int cx1 = std::clamp((int)std::floor((cam.x + vw / cam.zoom) / m_cell), 0, m_cols - 1);
+        const int cy1 = std::clamp((int)std::floor((cam.y + vh / cam.zoom) / m_cell), 0, m_rows - 1);
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const int r = m_cellRegion[(size_t)cy * m_cols + cx];
+                const SDL_Color c = m_awake[r] ? SDL_Color{ 60,200,90,28 } : SDL_Color{ 90,90,120,28 };
+                r2d.fillRect(cx * m_cell + 2.f, cy * m_cell + 2.f, m_cell - 4.f, m_cell - 4.f, c);
+            }
+        for (const ActivityRoom& r : m_rooms) {
+            const SDL_Color c{ 240,200,80,160 };
+            r2d.fillRect(r.x, r.y, r.w, 2.f, c);
+            r2d.fillRect(r.x, r.y + r.h - 2.f, r.w, 2.f, c);
+            r2d.fillRect(r.x, r.y, 2.f, r.h, c);
+            r2d.fillRect(r.x + r.w - 2.f, r.y, 2.f, r.h, c);
+        }
+    }
+
+} // namespace Erlik
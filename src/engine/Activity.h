@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace Erlik {
+
+    // Uyku bolgesi olarak kullanilacak dikdortgen (TMJ "rooms" katmani; world px)
+    struct ActivityRoom {
+        float x = 0.f, y = 0.f, w = 0.f, h = 0.f;
+    };
+
+    // Aktivite bolgeleri: dunya kaba hucrelere bolunur; merkezi bir odaya dusen hucreler o
+    // odanin bolgesi olur (oda tek parca uyanir/uyur), kalan her hucre kendi bolgesidir.
+    // update() kameraya (+pay) degen bolgeleri uyanik isaretler ve bu karede uyanan/uyuyan
+    // bolgeleri listeler. Maliyet dunya boyutuna degil, kutuya degen hucre ve uyanik bolge
+    // sayisina baglidir; sistemler (PhysicsWorld, ...) sadece woke()/slept() uzerinden calisir.
+    class ActivityMap {
+    public:
+        void build(float worldW, float worldH, const std::vector<ActivityRoom>& rooms, float cellPx = 512.f);
+        void clear();
+        // Baska thread'de build edilmis haritayi devralir (hot reload): surum bu haritanin
+        // uzerinden artar, uyku zamanlari bu haritanin saatine tasinir
+        void adopt(ActivityMap&& built);
+
+        // Yeniden kurulumda artar: sistemler eski bolge id'lerine bagli durumu birakir
+        uint32_t version() const { return m_version; }
+        int  regionCount() const { return (int)m_awake.size(); }
+        int  roomCount() const { return m_roomCount; }
+
+        // Kutu [x0,x1]x[y0,y1]'e degen bolgeler uyanik; now: saniye (uyku suresi icin)
+        void update(float x0, float y0, float x1, float y1, double now);
+
+        // Dunya disi noktalar en yakin kenar hucresine kenetlenir; harita yoksa -1
+        int  regionAt(float x, float y) const;
+        bool awake(int region) const { return region < 0 || m_awake[region] != 0; }
+        // Son update'te uyanan bolgenin ne kadar uyudugu (s)
+        float sleptFor(int region) const { return (float)(m_now - m_sleptAt[region]); }
+
+        const std::vector<int>& awakeRegions() const { return m_awakeList; }
+        const std::vector<int>& woke() const { return m_woke; }
+        const std::vector<int>& slept() const { return m_slept; }
+
+        // Debug: uyanik bolgelerin hucreleri (yesil) + oda sinirlari
+        void drawDebug(class Renderer2D& r2d) const;
+
+    private:
+        float m_cell = 512.f;
+        int   m_cols = 0, m_rows = 0;
+        int   m_roomCount = 0;
+        std::vector<int> m_cellRegion;     // cols*rows -> bolge id
+        std::vector<ActivityRoom> m_rooms; // debug cizimi
+
+        std::vector<uint8_t>  m_awake;     // bolge -> 0/1
+        std::vector<uint32_t> m_stamp;     // update icinde tekrar eklemeyi engeller
+        std::vector<double>   m_sleptAt;
+        std::vector<int> m_awakeList, m_next, m_woke, m_slept;
+        uint32_t m_frame = 0, m_version = 0;
+        double   m_now = 0.0;
+    };
+
+} // namespace Erlik
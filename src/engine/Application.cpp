@@ -100,79 +100,79 @@ namespace Erlik {
             SDL_Log("[audio] init failed");
         }
 
-        // World setup (TMJ)
+        // --- Asenkron yukleme: decode'lar AssetLoader worker'larinda, ana thread'de yalnizca upload ---
+        // Atlas, SFX ve muzikler once kuyruga girer; TMJ okunurken ve font acilirken decode olurlar.
+        const AssetLoader::Handle atlasJob = m_assets.loadTexture("assets/atlas8x1.png");
+        m_assets.preloadSfx("jump", "assets/audio/jump.wav");
+        m_assets.preloadSfx("land", "assets/audio/land.wav");
+        m_assets.preloadSfx("step", "assets/audio/step.wav");
+        // Kapı/teleport için bir efekt. Dosya ismini kendine göre ayarlayabilirsin:
+        m_assets.preloadSfx("door", "assets/audio/door.wav");   // ör: assets/audio/door.wav
+        m_assets.preloadSfx("locked", "assets/audio/locked.wav"); // opsiyonel dosya; yoksa fallback çalışır
+        m_assets.preloadSfx("key", "assets/audio/key.wav");    // anahtar toplama
+        const AssetLoader::Handle bgmJob = m_assets.loadMusic("bgm", "assets/audio/level.ogg");
+        m_assets.preloadMusic("bgm_forest", "assets/audio/forest.ogg");
+
+        // World setup (TMJ): harita okunur, tileset decode'u worker'a gider
         m_tmjPath = "assets/level_city.tmj";
-        if (m_tmj.load(m_renderer, m_tmjPath)) {
+        bool tmjOK = m_tmj.beginLoad(m_tmjPath, m_assets);
+
+        // Font ana thread'de (FreeType kutuphanesi thread-safe degil); bu sirada decode'lar suruyor
+        // renderer kurulumundan sonra (TTF init): tek çağrı + fallback
+        bool fontOK = m_text.init(m_renderer, m_fontPath, 14);
+        if (!fontOK) {
+            // Windows klasik fontu + muhtemel asset yollarını dene
+            const char* fallbacks[] = {
+                "C:/Windows/Fonts/arial.ttf",
+                "assets/DejaVuSans.ttf",
+                "assets/fonts/DejaVuSans.ttf"
+            };
+            for (const char* fb : fallbacks) {
+                if (m_text.init(m_renderer, fb, 14)) {
+                    std::fprintf(stderr, "[dbg] TTF fallback loaded: %s\n", fb);
+                    fontOK = true;
+                    break;
+                }
+            }
+            if (!fontOK) {
+                std::fprintf(stderr, "[dbg] TTF load failed (tried %s and fallbacks)\n", m_fontPath);
+            }
+        }
+
+        if (tmjOK) tmjOK = m_tmj.endLoad(m_renderer, m_assets);
+        if (tmjOK) {
             std::fprintf(stderr, "[info] TMJ loaded: %s\n", m_tmjPath.c_str());
             m_tmj.buildCollision(m_map, "collision", "oneway");
             m_worldW = static_cast<float>(m_tmj.cols() * m_tmj.tileW());
             m_worldH = static_cast<float>(m_tmj.rows() * m_tmj.tileH());
+            rebuildLights();
+            rebuildPlatforms();
+            rebuildNav();
+            rebuildActivity();
+            m_minimap.build(m_renderer, m_tmj, m_map);
+            m_decals.init(m_renderer, (int)m_worldW, (int)m_worldH);
 
             {
                 std::unordered_set<std::string> names;
-                for (const auto& tr : m_tmj.triggers()) {
-                    if (!tr.music.empty())     names.insert(tr.music);
-                    if (!tr.exitMusic.empty()) names.insert(tr.exitMusic);
+                for (int i = 0; i < (int)m_tmj.triggers().size(); ++i) {
+                    const TriggerProps& tp = m_tmj.triggerProps(i);
+                    if (tp.music > 0)     names.insert(m_tmj.symbols().str(tp.music));
+                    if (tp.exitMusic > 0) names.insert(m_tmj.symbols().str(tp.exitMusic));
 
                 }
                 for (const auto& nm : names) {
                     if (!Audio::hasMusic(nm)) {
                         // Konvansiyon: assets/audio/<name>.ogg
                         std::string path = "assets/audio/" + nm + ".ogg";
-                        Audio::loadMusic(nm, path);
+                        m_assets.preloadMusic(nm, path);
                         SDL_Log("[preload] music: %s (%s)", nm.c_str(), path.c_str());
                     }
                 }
             }
 
             // --- Hot Reload: TMJ dosyasını izle
-            m_res.track(m_tmjPath, [this]() {
-                if (m_tmj.load(m_renderer, m_tmjPath)) {
-                    std::fprintf(stderr, "[hotreload] TMJ reloaded: %s\n", m_tmjPath.c_str());
-                    m_tmj.buildCollision(m_map, "collision", "oneway");
-                    m_worldW = static_cast<float>(m_tmj.cols() * m_tmj.tileW());
-                    m_worldH = static_cast<float>(m_tmj.rows() * m_tmj.tileH());
-
-                    // --- PRELOAD: Region trigger'larında referans verilen müzikleri baştan yükle ---
-                    {
-                        std::unordered_set<std::string> names;
-                        for (const auto& tr : m_tmj.triggers()) {
-                            if (!tr.music.empty())     names.insert(tr.music);
-                            if (!tr.exitMusic.empty()) names.insert(tr.exitMusic);
-                            
-                        }
-                        for (const auto& nm : names) {
-                            if (!Audio::hasMusic(nm)) {
-                            // Konvansiyon: assets/audio/<name>.ogg
-                                    std::string path = "assets/audio/" + nm + ".ogg";
-                                Audio::loadMusic(nm, path);
-                                SDL_Log("[preload] music: %s (%s)", nm.c_str(), path.c_str());
-                            }
-                        }
-                    }
-                    notifyHUD("Reload OK (TMJ)", SDL_Color{ 40,200, 90,255 }, 1.5f);
-
-                    // Region müziklerini tekrar preload et (yeni/degisen olabilir)
-                    {
-                        std::unordered_set<std::string> names;
-                        for (const auto& tr : m_tmj.triggers()) {
-                            if (!tr.music.empty())     names.insert(tr.music);
-                            if (!tr.exitMusic.empty()) names.insert(tr.exitMusic);
-                        }
-                        for (const auto& nm : names) {
-                            if (!Audio::hasMusic(nm)) {
-                                std::string path = "assets/audio/" + nm + ".ogg";
-                                Audio::loadMusic(nm, path);
-                                SDL_Log("[preload] music (reload): %s (%s)", nm.c_str(), path.c_str());
-                            }
-                        }
-                    }
-                }
-                else {
-                    std::fprintf(stderr, "[hotreload] TMJ reload FAILED: %s\n", m_tmjPath.c_str());
-                    notifyHUD("Reload FAIL (TMJ)", SDL_Color{ 220, 60, 60,255 }, 2.0f);
-                }
-                });
+            // Yeni harita arka planda ikinci TMJMap/Tilemap'e hazirlanir; pollTmjReload kare basinda takas eder
+            m_res.track(m_tmjPath, [this]() { startTmjReload(); });
         }
         else {
             std::fprintf(stderr, "[warn] TMJ load FAILED, fallback CSV\n");
@@ -180,57 +180,31 @@ namespace Erlik {
             m_map.loadTileset(m_renderer, "assets/tileset32.png", 32);
             m_worldW = static_cast<float>(m_map.cols() * m_map.tileSize());
             m_worldH = static_cast<float>(m_map.rows() * m_map.tileSize());
+            rebuildLights();
+            rebuildPlatforms();
+            rebuildNav();
+            rebuildActivity();
+            m_minimap.build(m_renderer, m_tmj, m_map);
+            m_decals.init(m_renderer, (int)m_worldW, (int)m_worldH);
         }
 
-        // --- SFX ve müzikleri yükle ---
-        Audio::loadSfx("jump", "assets/audio/jump.wav");
-        Audio::loadSfx("land", "assets/audio/land.wav");
-        Audio::loadSfx("step", "assets/audio/step.wav");
-        // Kapı/teleport için bir efekt. Dosya ismini kendine göre ayarlayabilirsin:
-        Audio::loadSfx("door", "assets/audio/door.wav");   // ör: assets/audio/door.wav
-        Audio::loadSfx("locked", "assets/audio/locked.wav"); // opsiyonel dosya; yoksa fallback çalışır
-        Audio::loadSfx("key", "assets/audio/key.wav");    // anahtar toplama
-        Audio::loadMusic("bgm", "assets/audio/level.ogg");
-        Audio::loadMusic("bgm_forest", "assets/audio/forest.ogg");
-        Audio::playMusic("bgm", -1, 0.60f); // oyun açılır açılmaz çalsın
-        m_musicCurrent = "bgm";
-
-       
-        // renderer kurulumundan sonra (TTF init): tek çağrı + fallback
-        bool fontOK = m_text.init(m_renderer, m_fontPath, 14);
-        if (!fontOK) {
-            // Windows klasik fontu + muhtemel asset yollarını dene
-            const char* fallbacks[] = {
-                "C:/Windows/Fonts/arial.ttf",
-                "assets/DejaVuSans.ttf",
-                "assets/fonts/DejaVuSans.ttf"
-            };
-            for (const char* fb : fallbacks) {
-                if (m_text.init(m_renderer, fb, 14)) {
-                    std::fprintf(stderr, "[dbg] TTF fallback loaded: %s\n", fb);
-                    fontOK = true;
-                    break;
-                }
-            }
-            if (!fontOK) {
-                std::fprintf(stderr, "[dbg] TTF load failed (tried %s and fallbacks)\n", m_fontPath);
-            }
-        }
+        // Partikul izleri kalici decal katmanina
+        m_fx.init(2048);
+        m_fx.setDecals(&m_decals);
+        m_fx.setCollision(&m_map);   // toz zeminde kayar, duvardan gecmez
 
-        // SDL/renderer sonrası, harita yüklemeden sonra uygun bir yere:
-        Platform p;
-        p.w = 96; p.h = 16;
-        p.y = 32.f * 17.f;        // 17. satır hizası
-        p.minX = 32.f * 18.f;     // soldaki sınır (tile 18)
-        p.maxX = 32.f * 28.f;     // sağdaki sınır (tile 28)
-        p.x = p.minX;             // başlangıç
-        p.vx = 80.f;              // px/s sağa
-        m_platforms.push_back(p);
+        // SFX/muzik decode'lari TMJ ve font ile paralel ilerledi; bgm hemen calsin diye onu bekle
+        if (m_assets.wait(bgmJob, m_renderer) == AssetLoader::State::Ready)
+            Audio::playMusic("bgm", -1, 0.60f); // oyun açılır açılmaz çalsın
+        m_assets.release(bgmJob);
+        m_musicCurrent = m_tmj.symbols().intern("bgm");
 
         // Player start
         m_player.x = 64.f; m_player.y = 64.f; m_player.vx = 0.f; m_player.vy = 0.f; m_player.onGround = false;
         m_spawnX = m_player.x;
         m_spawnY = m_player.y;
+        m_playerBody = m_world.addBody(m_player.x, m_player.y, m_player.halfW, m_player.halfH);
+        m_world.setKeepAwake(m_playerBody, true);
 
         // Diskten checkpoint yükle (aktif slottan; varsa oradan başla)
         {
@@ -245,7 +219,11 @@ namespace Erlik {
          }
 
         // Visual sprite / anim clips
-        if (m_atlas.loadGrid(m_renderer, "assets/atlas8x1.png", 32, 32, 0, 0)) {
+        Texture atlasTex;
+        m_assets.wait(atlasJob, m_renderer);
+        const bool atlasOK = m_assets.takeTexture(atlasJob, atlasTex);
+        if (!atlasOK) m_assets.release(atlasJob);
+        if (atlasOK && m_atlas.loadGrid(std::move(atlasTex), 32, 32, 0, 0)) {
             int total = m_atlas.frameCount();
             m_anim.setTotalFrames(total);
             std::fprintf(stderr, "[atlas] frames=%d\n", total);
@@ -265,10 +243,15 @@ namespace Erlik {
             std::fprintf(stderr, "[warn] Atlas not found: assets/atlas8x1.png\n");
         }
 
+        // Kalan isler (bolge muzikleri, SFX) burada biter; ilk kareden itibaren hepsi hazir
+        m_assets.finish(m_renderer);
         return true;
     }
 
     void Application::shutdown() {
+        m_tmjRetired.reset(); m_mapRetired.reset();
+        m_assets.shutdown();   // worker'lar + teslim edilmemis chunk/surface (Mix_Quit'ten once)
+        m_tmjJob = -1; m_tmjNext.reset(); m_mapNext.reset(); // worker durduktan sonra
         delete m_r2d; m_r2d = nullptr;
 
         Audio::shutdown();
@@ -329,12 +312,182 @@ namespace Erlik {
             m_dbgShowCol = !m_dbgShowCol;
             notifyHUD(m_dbgShowCol ? "COL ON" : "COL OFF", SDL_Color{ 200,120,60,255 }, 0.8f);
         }
+        if (Input::keyPressed(SDL_SCANCODE_L)) {
+            m_lighting = !m_lighting && m_lights.ready();
+            notifyHUD(m_lighting ? "LIGHT ON" : "LIGHT OFF", SDL_Color{ 240,200,120,255 }, 0.8f);
+        }
+        if (Input::keyPressed(SDL_SCANCODE_M)) {
+            m_showMinimap = !m_showMinimap;
+            notifyHUD(m_showMinimap ? "MAP ON" : "MAP OFF", SDL_Color{ 180,180,180,255 }, 0.8f);
+        }
+        if (Input::keyPressed(SDL_SCANCODE_V)) {
+            m_pipEnabled = !m_pipEnabled;
+            notifyHUD(m_pipEnabled ? "PIP ON" : "PIP OFF", SDL_Color{ 180,180,180,255 }, 0.8f);
+        }
+        if (Input::keyPressed(SDL_SCANCODE_B)) {
+            spawnSwarm(100);
+            notifyHUD("SWARM +100", SDL_Color{ 220,120,120,255 }, 0.8f);
+        }
+        if (Input::keyPressed(SDL_SCANCODE_E)) {
+            const int n = breakTilesAhead();
+            if (n > 0) notifyHUD("BREAK", SDL_Color{ 220,180,120,255 }, 0.5f);
+        }
+    }
+
+    // Debug: oyuncunun cevresindeki bos hucrelere dolasan govdeler ekle (fizik + temas testi)
+    void Application::spawnSwarm(int count) {
+        m_world.setContactsEnabled(true);
+        const int tile = m_map.tileSize();
+        const int ptx = (int)std::floor(m_player.x / tile), pty = (int)std::floor(m_player.y / tile);
+        for (int tries = 0; count > 0 && tries < count * 20; ++tries) {
+            const int tx = ptx + std::rand() % 25 - 12;
+            const int ty = pty + std::rand() % 13 - 6;
+            if (tx < 0 || ty < 0 || tx >= m_map.cols() || ty >= m_map.rows()) continue;
+            if (m_map.get(tx, ty) >= 0) continue;
+            m_swarm.push_back(m_world.addBody((tx + 0.5f) * tile, (ty + 0.5f) * tile, 8.f, 10.f));
+            --count;
+        }
+    }
+
+    // Debug: oyuncunun baktigi yondeki solid hucreleri kir (tum katmanlardan sil).
+    // Collision aninda yamalanir; cizim/cache/minimap kare sonunda toplu yenilenir.
+    int Application::breakTilesAhead() {
+        const int tile = m_map.tileSize();
+        const float ahead = (m_faceRight ? 1.f : -1.f) * (m_player.halfW + tile * 0.5f);
+        const int tx = (int)std::floor((m_player.x + ahead) / tile);
+        const int ty0 = (int)std::floor((m_player.y - m_player.halfH) / tile);
+        const int ty1 = (int)std::floor((m_player.y + m_player.halfH - 1.f) / tile);
+        int broken = 0;
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            if (!m_map.solidAtTile(tx, ty)) continue;
+            for (int l = 0; l < m_tmj.layerCount(); ++l) m_tmj.setTile(l, tx, ty, 0u, &m_map);
+            m_minimap.updateCell(m_tmj, m_map, tx, ty);
+            m_lights.invalidateTiles(tx, ty, tx, ty, tile);
+            ++broken;
+        }
+        if (broken > 0) m_nav.patch(m_map, tx, ty0, tx, ty1);
+        return broken;
+    }
+
+    // Yukleme ve hot reload worker'i ortak: GPU'suz, sadece verilen nesnelere dokunur
+    static void buildNavGraph(NavGraph& nav, const Tilemap& map, const PhysicsParams& pp, float halfW, float halfH) {
+        const Uint64 t0 = SDL_GetPerformanceCounter();
+        nav.build(map, pp, halfW, halfH);
+        const double ms = (double)(SDL_GetPerformanceCounter() - t0) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+        SDL_Log("[nav] %d surfaces, %d edges (%.1f ms)", nav.surfaceCount(), nav.edgeCount(), ms);
+    }
+
+    static void buildActivityMap(ActivityMap& act, const TMJMap& tmj, float worldW, float worldH) {
+        std::vector<ActivityRoom> rooms;
+        for (const auto& d : tmj.rooms()) rooms.push_back(ActivityRoom{ d.x, d.y, d.w, d.h });
+        act.build(worldW, worldH, rooms, 512.f);
+        SDL_Log("[activity] %d region(s), %d room(s)", act.regionCount(), act.roomCount());
+    }
+
+    // Canli haritaya dokunmadan: parse + tileset decode + draw list + collision + nav/aktivite/
+    // minimap texel'leri AssetLoader worker'inda
+    void Application::startTmjReload() {
+        if (m_tmjJob >= 0) { m_tmjReloadAgain = true; return; } // suren hazirlik bitince yeniden
+        m_tmjNext = std::make_unique<TMJMap>();
+        m_mapNext = std::make_unique<Tilemap>();
+        m_navNext = std::make_unique<NavGraph>();
+        m_activityNext = std::make_unique<ActivityMap>();
+        m_tmjNext->inheritState(m_tmj);
+        TMJMap* next = m_tmjNext.get();
+        Tilemap* col = m_mapNext.get();
+        NavGraph* nav = m_navNext.get();
+        ActivityMap* act = m_activityNext.get();
+        std::vector<Uint32>* mini = &m_minimapNext;
+        m_tmjJob = m_assets.run([next, col, nav, act, mini, path = m_tmjPath, pp = m_pp,
+                                 halfW = m_player.halfW, halfH = m_player.halfH]() {
+            if (!next->prepare(path)) return false;
+            next->buildCollision(*col, "collision", "oneway");
+            buildNavGraph(*nav, *col, pp, halfW, halfH);
+            buildActivityMap(*act, *next, (float)(next->cols() * next->tileW()), (float)(next->rows() * next->tileH()));
+            Minimap::colorize(*next, *col, *mini);
+            return true;
+        });
+        if (m_tmjJob < 0) { m_tmjNext.reset(); m_mapNext.reset(); m_navNext.reset(); m_activityNext.reset(); }
+    }
+
+    // Kare basinda: hazirlik bittiyse takas (GPU kismi: tileset upload + static cache burada).
+    // Basarisiz reload canli haritayi hic degistirmez.
+    void Application::pollTmjReload() {
+        m_tmjRetired.reset();   // onceki karede takas edilen eski harita
+        m_mapRetired.reset();
+        if (m_tmjJob < 0 || m_assets.state(m_tmjJob) == AssetLoader::State::Pending) return;
+
+        const bool prepared = m_assets.state(m_tmjJob) == AssetLoader::State::Ready;
+        m_assets.release(m_tmjJob);
+        m_tmjJob = -1;
+        if (prepared && !m_tmjNext->inheritsFrom(m_tmj)) {
+            // Hazirlik sirasinda canli symbol tablosu buyudu: id'ler kaymasin diye bastan hazirla
+            SDL_Log("[hotreload] symbol table changed during reload, retrying");
+            m_tmjReloadAgain = true;
+        }
+        else if (prepared && m_tmjNext->finishPrepared(m_renderer, m_tmj)) {
+            // Icerik takasi: m_tmj/m_map adresleri sabit (fx, fizik, nav referanslari gecerli kalir)
+            std::swap(m_tmj, *m_tmjNext);
+            std::swap(m_map, *m_mapNext);
+            std::swap(m_nav, *m_navNext);            // worker'da m_mapNext uzerine kuruldu
+            m_activity.adopt(std::move(*m_activityNext));
+            m_tmjRetired = std::move(m_tmjNext);
+            m_mapRetired = std::move(m_mapNext);
+            m_navNext.reset();
+            m_activityNext.reset();
+
+            std::fprintf(stderr, "[hotreload] TMJ reloaded: %s\n", m_tmjPath.c_str());
+            m_worldW = static_cast<float>(m_tmj.cols() * m_tmj.tileW());
+            m_worldH = static_cast<float>(m_tmj.rows() * m_tmj.tileH());
+            rebuildLights();
+            rebuildPlatforms();
+            m_decals.init(m_renderer, (int)m_worldW, (int)m_worldH); // tile'lar degismis olabilir
+            {
+                const int changed = m_minimap.refresh(m_renderer, m_map.cols(), m_map.rows(), m_map.tileSize(), m_minimapNext);
+                SDL_Log("[hotreload] minimap cells updated: %d", changed);
+            }
+
+            // --- PRELOAD: Region trigger'larında referans verilen müzikleri baştan yükle ---
+            {
+                std::unordered_set<std::string> names;
+                for (int i = 0; i < (int)m_tmj.triggers().size(); ++i) {
+                    const TriggerProps& tp = m_tmj.triggerProps(i);
+                    if (tp.music > 0)     names.insert(m_tmj.symbols().str(tp.music));
+                    if (tp.exitMusic > 0) names.insert(m_tmj.symbols().str(tp.exitMusic));
+                }
+                for (const auto& nm : names) {
+                    if (!Audio::hasMusic(nm)) {
+                        // Konvansiyon: assets/audio/<name>.ogg
+                        std::string path = "assets/audio/" + nm + ".ogg";
+                        m_assets.preloadMusic(nm, path); // decode worker'da; update() pump eder
+                        SDL_Log("[preload] music: %s (%s)", nm.c_str(), path.c_str());
+                    }
+                }
+            }
+            notifyHUD("Reload OK (TMJ)", SDL_Color{ 40,200, 90,255 }, 1.5f);
+        }
+        else {
+            m_tmjNext.reset();
+            m_mapNext.reset();
+            m_navNext.reset();
+            m_activityNext.reset();
+            std::fprintf(stderr, "[hotreload] TMJ reload FAILED: %s\n", m_tmjPath.c_str());
+            notifyHUD("Reload FAIL (TMJ)", SDL_Color{ 220, 60, 60,255 }, 2.0f);
+        }
+
+        if (m_tmjReloadAgain) {
+            m_tmjReloadAgain = false;
+            startTmjReload();
+        }
     }
 
     void Application::update(double dt) {
         
         // Crossfade durum makinesi her kare ilerlesin (pause olsa bile)
         Audio::tick();
+        // Hot reload'da istenen asset'ler: decode worker'da, upload kare basina en fazla ~2 ms
+        m_assets.pump(m_renderer, 2.0);
+        pollTmjReload();   // hazir bekleyen harita varsa simulasyondan once takas
 
         if (!m_paused) {
             bool left = Input::keyDown(SDL_SCANCODE_A) || Input::keyDown(SDL_SCANCODE_LEFT);
@@ -435,8 +588,45 @@ namespace Erlik {
                 prevDbg = m_dbgOverlay;
             }
 
-            // Fizik çağrısı (YENİ imza!)
-            integrate(m_player, m_map, m_pp, (float)dt, left, right, jumpPressed, jumpHeld, dropRequest);
+            // Fizik: oyuncu PhysicsWorld'deki govdelerden biri. Oyun kodu (respawn, kapi,
+            // platform) m_player'a yazar; adimdan once dunyaya, sonra geri kopyalanir.
+            m_world.setBody(m_playerBody, m_player);
+            m_world.setInput(m_playerBody, (uint8_t)(
+                (left ? IN_LEFT : 0) | (right ? IN_RIGHT : 0) |
+                (jumpPressed ? IN_JUMP_PRESSED : 0) | (jumpHeld ? IN_JUMP_HELD : 0) |
+                (dropRequest ? IN_DROP : 0)));
+            // Aktivite: gorus kutusu + pay disindaki bolgeler uyur (govdeler, partikuller).
+            // Kamera bu karenin sonunda guncellenir; bir karelik gecikme payin icinde kalir.
+            {
+                int vw, vh; m_r2d->outputSize(vw, vh);
+                const float ax0 = m_cam.x - m_activityMargin, ay0 = m_cam.y - m_activityMargin;
+                const float ax1 = m_cam.x + vw / m_cam.zoom + m_activityMargin;
+                const float ay1 = m_cam.y + vh / m_cam.zoom + m_activityMargin;
+                m_activity.update(ax0, ay0, ax1, ay1, m_time);
+                m_world.syncActivity(m_activity, m_map, m_pp);
+                m_fx.setActiveRect(ax0, ay0, ax1, ay1);
+            }
+            // Swarm AI (sadece uyanik govdeler): ~2 sn'de bir yon degistir, arada zipla
+            for (int k = 0; k < m_world.activeCount(); ++k) {
+                const int id = m_world.activeId(k);
+                if (id == m_playerBody) continue;
+                const bool goRight = (((int)(m_time * 0.5) + id) & 1) != 0;
+                uint8_t in = goRight ? IN_RIGHT : IN_LEFT;
+                if ((std::rand() & 127) == 0) in |= IN_JUMP_PRESSED | IN_JUMP_HELD;
+                m_world.setInput(id, in);
+            }
+            m_world.step(m_map, m_pp, (float)dt, &m_jobs);
+            m_player = m_world.body(m_playerBody);
+
+            // Govde temaslari: oyuncuya yeni degen her govde kucuk bir itme alir
+            for (const BodyPair& bp : m_world.contacts().entered()) {
+                if (bp.a != m_playerBody && bp.b != m_playerBody) continue;
+                const int other = (bp.a == m_playerBody) ? bp.b : bp.a;
+                Player o = m_world.body(other);
+                o.vx += (o.x < m_player.x ? -1.f : 1.f) * 240.f;
+                o.vy = std::min(o.vy, -280.f);
+                m_world.setBody(other, o);
+            }
 
             // Listener = oyuncu (her kare güncel tut)
             Audio::setListener(m_player.x, m_player.y);
@@ -454,18 +644,35 @@ namespace Erlik {
             float pax = m_player.prevX - m_player.halfW;
             float pay = m_player.prevY - m_player.halfH;
 
-            for (const auto& tr : m_tmj.triggers()) {
-                if (tr.once && m_triggersFired.count(tr.id)) continue;
-
-                bool now = overlap(ax, ay, aw, ah, tr.x, tr.y, tr.w, tr.h);
-                bool prev = overlap(pax, pay, aw, ah, tr.x, tr.y, tr.w, tr.h);
-
-                if (now && !prev) {
+            // Sadece onceki ya da simdiki kutuya degen triggerlar (enter/exit ancak bunlarda olur).
+            // Iki kutu tek toplu sorgu; birlesim harita sirasinda ve tekrarsiz.
+            {
+                const TMJMap::TriggerBox boxes[2] = {
+                    { ax, ay, ax + aw, ay + ah }, { pax, pay, pax + aw, pay + ah } };
+                m_tmj.queryTriggers(boxes, 2, m_trigHits, m_trigStart);
+                if (m_trigStart[1] > 0 && m_trigStart[2] > m_trigStart[1]) {
+                    std::sort(m_trigHits.begin(), m_trigHits.end());
+                    m_trigHits.erase(std::unique(m_trigHits.begin(), m_trigHits.end()), m_trigHits.end());
+                }
+            }
+            const SymbolTable& syms = m_tmj.symbols();
+            for (int ti : m_trigHits) {
+                const Trigger& tr = m_tmj.triggers()[ti];
+                if (tr.flags & TRIG_FIRED) continue;
+
+                const bool now = overlap(ax, ay, aw, ah, tr.x, tr.y, tr.w, tr.h);
+                const bool prev = overlap(pax, pay, aw, ah, tr.x, tr.y, tr.w, tr.h);
+                if (now == prev) continue;
+
+                const TriggerProps& tp = m_tmj.triggerProps(ti);
+                const float tcx = tr.x + tr.w * 0.5f, tcy = tr.y + tr.h * 0.5f;
+                if (now) {
                     // === ENTER ===
-                    if (tr.type == "checkpoint") {
-                        m_spawnX = tr.x + tr.w * 0.5f;
-                        m_spawnY = tr.y + tr.h * 0.5f;
-                        SDL_Log("TRIGGER checkpoint: id=%d name=%s", tr.id, tr.name.c_str());
+                    switch (tr.type) {
+                    case TriggerType::Checkpoint: {
+                        m_spawnX = tcx;
+                        m_spawnY = tcy;
+                        SDL_Log("TRIGGER checkpoint: id=%d name=%s", tr.id, syms.str(tp.name).c_str());
                         SDL_SetWindowTitle(m_window, "Checkpoint!");
                         pushToast("Checkpoint!", 1.6f);
 
@@ -480,119 +687,125 @@ namespace Erlik {
                             Input::rumble(12000, 22000, 120);
                         }
 
-                        if (tr.once) m_triggersFired.insert(tr.id);
+                        if (tr.flags & TRIG_ONCE) m_tmj.markFired(ti);
+                        break;
                     }
-                    else if (tr.type == "key" || !tr.giveKey.empty()) {
-                        std::string k = tr.giveKey.empty() ? tr.name : tr.giveKey;
-                        for (auto& c : k) c = (char)std::tolower((unsigned char)c);
-                        if (!k.empty()) {
-                            m_keys.insert(k);
-                            SDL_Log("PICKUP key: %s (id=%d)", k.c_str(), tr.id);
-                            pushToast(tr.message.empty() ? ("Anahtar aldın: " + k) : tr.message, 1.6f);
-                            Audio::playSfxAt(tr.sfx.empty() ? "key" : tr.sfx,
-                                tr.x + tr.w * 0.5f, tr.y + tr.h * 0.5f, 900.f);
-                            if (tr.once) m_triggersFired.insert(tr.id);
-                        }
+                    case TriggerType::Key: {
+                        if (tp.giveKey <= 0) break;
+                        if ((size_t)tp.giveKey >= m_keyHeld.size()) m_keyHeld.resize(syms.size(), 0);
+                        m_keyHeld[tp.giveKey] = 1;
+                        const std::string& k = syms.str(tp.giveKey);
+                        const std::string& msg = m_tmj.triggerText(ti).message;
+                        SDL_Log("PICKUP key: %s (id=%d)", k.c_str(), tr.id);
+                        pushToast(msg.empty() ? ("Anahtar aldın: " + k) : msg, 1.6f);
+                        Audio::playSfxAt(syms.str(tp.sfx), tcx, tcy, 900.f);
+                        if (tr.flags & TRIG_ONCE) m_tmj.markFired(ti);
+                        break;
                     }
-                    else if (tr.type == "door") {
+                    case TriggerType::Door: {
                         // --- LOCK CHECK ---
-                        std::string need = tr.requiresKey;
-                        for (auto& c : need) c = (char)std::tolower((unsigned char)c);
-                        const bool hasKey = need.empty() || (m_keys.find(need) != m_keys.end());
+                        const Sym need = tp.requiresKey;
+                        const bool hasKey = need == 0 || ((size_t)need < m_keyHeld.size() && m_keyHeld[need]);
+                        const TriggerText& tt = m_tmj.triggerText(ti);
 
                         if (!hasKey) {
-                            const std::string msg = tr.lockedMsg.empty()
-                                ? (need.empty() ? "Kapı kilitli" : ("Kapı kilitli: " + need))
-                                : tr.lockedMsg;
-                            pushToast(msg, 1.4f);
-                            Audio::playSfxAt(tr.lockedSfx.empty() ? "locked" : tr.lockedSfx,
-                                tr.x + tr.w * 0.5f, tr.y + tr.h * 0.5f, 900.f);
+                            pushToast(tt.lockedMsg.empty() ? ("Kapı kilitli: " + syms.str(need)) : tt.lockedMsg, 1.4f);
+                            Audio::playSfxAt(syms.str(tp.lockedSfx), tcx, tcy, 900.f);
                             m_shake = std::min(1.0f, m_shake + 0.15f);
                             Input::rumble(9000, 16000, 60);
                             // kilitliyken teleport AKIŞINA GİRME
-                            continue;
+                            break;
                         }
 
                         // anahtar varsa (gerekliyse tüket)
-                        if (!need.empty() && tr.consumeKey) m_keys.erase(need);
-                        if (!tr.unlockMsg.empty()) pushToast(tr.unlockMsg, 1.2f);
-
-                        // hedefi bul
-                        const auto* dst = m_tmj.findTriggerByName(tr.target);
-                        if (!dst) {
-                            SDL_Log("WARN: door target not found: %s", tr.target.c_str());
-                            continue;
+                        if (need > 0 && (tr.flags & TRIG_CONSUME_KEY)) m_keyHeld[need] = 0;
+                        if (!tt.unlockMsg.empty()) pushToast(tt.unlockMsg, 1.2f);
+
+                        // hedef yuklemede cozuldu
+                        if (tp.target < 0) {
+                            SDL_Log("WARN: door target not found: %s", syms.str(tp.targetName).c_str());
+                            break;
                         }
+                        const Trigger& dst = m_tmj.triggers()[tp.target];
 
                         // teleport parametreleri
-                        m_doorTeleportX = dst->x + dst->w * 0.5f;
-                        m_doorTeleportY = dst->y + dst->h * 0.5f;
+                        m_doorTeleportX = dst.x + dst.w * 0.5f;
+                        m_doorTeleportY = dst.y + dst.h * 0.5f;
                         m_doorTeleportPending = true;
 
                         // SFX (unlockSfx > sfx > door > step)
-                        float sx = tr.x + tr.w * 0.5f, sy = tr.y + tr.h * 0.5f;
                         int ch = -1;
-                        if (!tr.unlockSfx.empty()) ch = Audio::playSfxAt(tr.unlockSfx, sx, sy, 900.f);
-                        else if (!tr.sfx.empty())  ch = Audio::playSfxAt(tr.sfx, sx, sy, 900.f);
-                        if (ch < 0) ch = Audio::playSfxAt("door", sx, sy, 900.f);
-                        if (ch < 0) ch = Audio::playSfxAt("step", sx, sy, 900.f);
+                        if (tp.unlockSfx > 0) ch = Audio::playSfxAt(syms.str(tp.unlockSfx), tcx, tcy, 900.f);
+                        else if (tp.sfx > 0)  ch = Audio::playSfxAt(syms.str(tp.sfx), tcx, tcy, 900.f);
+                        if (ch < 0) ch = Audio::playSfxAt("door", tcx, tcy, 900.f);
+                        if (ch < 0) ch = Audio::playSfxAt("step", tcx, tcy, 900.f);
 
                         // Shake + Fade
-                        const float shakeK = (tr.shake > 0.f) ? std::clamp(tr.shake, 0.f, 1.f) : 0.5f;
+                        const float shakeK = (tp.shake > 0.f) ? std::clamp(tp.shake, 0.f, 1.f) : 0.5f;
                         m_shake = std::min(1.0f, m_shake + shakeK);
                         Input::rumble(14000, 26000, (Uint32)(80 + 60 * shakeK));
 
-                        m_doorFadeIn = (tr.fadeInMs > 0.f ? tr.fadeInMs : 120.f) / 1000.f;
-                        m_doorFadeOut = (tr.fadeOutMs > 0.f ? tr.fadeOutMs : 140.f) / 1000.f;
+                        m_doorFadeIn = (tp.fadeInMs > 0.f ? tp.fadeInMs : 120.f) / 1000.f;
+                        m_doorFadeOut = (tp.fadeOutMs > 0.f ? tp.fadeOutMs : 140.f) / 1000.f;
                         m_doorFxActive = true; m_doorFxPhase = 1; m_doorFxT = 0.f; m_doorAlpha = 0.f;
 
-                        pushToast("Door: " + tr.name + " -> " + tr.target, 1.2f);
-                        if (tr.once) m_triggersFired.insert(tr.id);
+                        pushToast("Door: " + syms.str(tp.name) + " -> " + syms.str(tp.targetName), 1.2f);
+                        if (tr.flags & TRIG_ONCE) m_tmj.markFired(ti);
+                        break;
                     }
-                    else { // "region" ve diğer custom türler
-                        if (!tr.message.empty()) pushToast(tr.message, 2.2f);
-                        if (tr.zoom > 0.0f) m_cam.zoom = std::clamp(tr.zoom, 0.25f, 3.0f);
+                    case TriggerType::Region:
+                    case TriggerType::Custom: {
+                        const std::string& msg = m_tmj.triggerText(ti).message;
+                        if (!msg.empty()) pushToast(msg, 2.2f);
+                        if (tp.zoom > 0.0f) m_cam.zoom = std::clamp(tp.zoom, 0.25f, 3.0f);
 
                         // Music region: ENTER → crossfade
-                        if (!tr.music.empty()) {
-                            if (tr.music != m_musicCurrent) {
+                        if (tp.music > 0) {
+                            if (tp.music != m_musicCurrent) {
                                 m_musicBeforeRegion = m_musicCurrent;
-                                const float vol = std::clamp(tr.musicVol, 0.0f, 1.0f);
-                                const int fin = (tr.musicFadeInMs > 0.f) ? (int)tr.musicFadeInMs
-                                    : (tr.musicFadeMs > 0.f) ? (int)tr.musicFadeMs : 400;
-                                const int fout = (tr.musicFadeOutMs > 0.f) ? (int)tr.musicFadeOutMs
-                                    : (tr.musicFadeMs > 0.f) ? (int)tr.musicFadeMs : 250;
-                                Audio::crossfadeTo(tr.music, -1, fout, fin, vol);
-                                m_musicCurrent = tr.music;
+                                Audio::crossfadeTo(syms.str(tp.music), -1, tp.musicFadeOutMs, tp.musicFadeInMs, tp.musicVol);
+                                m_musicCurrent = tp.music;
                             }
                             m_activeMusicRegionId = tr.id;
                         }
 
-                        if (tr.once) m_triggersFired.insert(tr.id);
+                        if (tr.flags & TRIG_ONCE) m_tmj.markFired(ti);
+                        break;
+                    }
                     }
                 }
-                else if (!now && prev) {
+                else if (tr.type == TriggerType::Region && tr.id == m_activeMusicRegionId) {
                     // === EXIT ===
-                    if (tr.type == "region") {
-                        if (tr.id == m_activeMusicRegionId) {
-                            std::string next = !tr.exitMusic.empty() ? tr.exitMusic : m_musicBeforeRegion;
-                            const int fin = (tr.musicFadeInMs > 0.f) ? (int)tr.musicFadeInMs
-                                : (tr.musicFadeMs > 0.f) ? (int)tr.musicFadeMs : 400;
-                            const int fout = (tr.musicFadeOutMs > 0.f) ? (int)tr.musicFadeOutMs
-                                : (tr.musicFadeMs > 0.f) ? (int)tr.musicFadeMs : 250;
-
-                            if (!next.empty() && next != m_musicCurrent) {
-                                Audio::crossfadeTo(next, -1, fout, fin, 1.0f);
-                                m_musicCurrent = next;
-                            }
-                            else if (next.empty()) {
-                                Audio::stopMusic(fout);
-                                m_musicCurrent.clear();
-                            }
-                            m_activeMusicRegionId = -1;
-                            SDL_Log("MUSIC EXIT region=%s -> next=%s", tr.name.c_str(), m_musicCurrent.c_str());
-                        }
+                    const Sym next = tp.exitMusic > 0 ? tp.exitMusic : m_musicBeforeRegion;
+                    if (next > 0 && next != m_musicCurrent) {
+                        Audio::crossfadeTo(syms.str(next), -1, tp.musicFadeOutMs, tp.musicFadeInMs, 1.0f);
+                        m_musicCurrent = next;
                     }
+                    else if (next == 0) {
+                        Audio::stopMusic(tp.musicFadeOutMs);
+                        m_musicCurrent = 0;
+                    }
+                    m_activeMusicRegionId = -1;
+                    SDL_Log("MUSIC EXIT region=%s -> next=%s", syms.str(tp.name).c_str(), syms.str(m_musicCurrent).c_str());
+                }
+            }
+
+            // --- PiP: kapinin onundeyken hedef odayi ikinci viewport'ta goster
+            m_pipActive = false;
+            if (m_pipEnabled) {
+                m_tmj.queryTriggers(ax, ay, ax + aw, ay + ah, m_trigHits);
+                for (int ti : m_trigHits) {
+                    const Trigger& tr = m_tmj.triggers()[ti];
+                    if (tr.type != TriggerType::Door) continue;
+                    if (!overlap(ax, ay, aw, ah, tr.x, tr.y, tr.w, tr.h)) continue;
+                    const int t = m_tmj.triggerProps(ti).target;
+                    if (t < 0) continue;
+                    const Trigger* dst = &m_tmj.triggers()[t];
+                    m_pipCam.zoom = 0.5f;
+                    m_pipCam.x = dst->x + dst->w * 0.5f - PIP_W * 0.5f / m_pipCam.zoom;
+                    m_pipCam.y = dst->y + dst->h * 0.5f - PIP_H * 0.5f / m_pipCam.zoom;
+                    m_pipActive = true;
+                    break;
                 }
             }
 
@@ -641,36 +854,6 @@ namespace Erlik {
                 m_hudTimer = std::max(0.f, m_hudTimer - (float)dt);
             }
 
-            // 1) Platformları hareket ettir
-            for (auto& pl : m_platforms) {
-                pl.x += pl.vx * (float)dt;
-                if (pl.x < pl.minX) { pl.x = pl.minX; pl.vx = -pl.vx; }
-                if (pl.x + pl.w > pl.maxX) { pl.x = pl.maxX - pl.w; pl.vx = -pl.vx; }
-            }
-
-            // 2) Üstten temas varsa “carry” uygula
-            for (auto& pl : m_platforms) {
-                const float px0 = m_player.x - m_player.halfW;
-                const float px1 = m_player.x + m_player.halfW;
-                const float py1 = m_player.y + m_player.halfH;
-                const float prevBottom = m_player.prevY + m_player.halfH;
-
-                const bool overlapX = (px1 > pl.x) && (px0 < pl.x + pl.w);
-                const bool comingDownFromAbove = (m_player.vy >= 0.f) && (prevBottom <= pl.y);
-
-                if (overlapX && comingDownFromAbove && py1 >= pl.y && py1 <= pl.y + 20.f) {
-                    // üstüne bin
-                    m_player.y = pl.y - m_player.halfH;
-                    m_player.vy = 0.f;
-                    m_player.onGround = true;
-
-                    // carry gücü: input yoksa 1.0, varsa 0.3
-                    bool hasInput = left || right;
-                    float carryStrength = hasInput ? 0.3f : 1.0f;
-                    m_player.x += pl.vx * (float)dt * carryStrength;
-                }
-            }
-
             // --- RUN FOOT DUST (yer + yeterli hız) ---
             if (m_player.onGround) {
                 float speed = std::fabs(m_player.vx);
@@ -715,8 +898,14 @@ namespace Erlik {
                 int   each = std::max(1, total / 2);
                 float baseV = 90.f + 140.f * impact;
 
-                m_fx.emitDust(fx, fy, each, +1.f, baseV);
-                m_fx.emitDust(fx, fy, each, -1.f, baseV);
+                m_fx.emitDust(fx, fy, each, +1.f, baseV, 0.5f, ParticleHit::Slide);
+                m_fx.emitDust(fx, fy, each, -1.f, baseV, 0.5f, ParticleHit::Slide);
+
+                // Sert iniste zemine kalici surtme izi (dogrudan stamp)
+                if (impact > 0.5f) {
+                    const float w = m_player.halfW * (2.f + 2.f * impact);
+                    m_decals.stamp(fx - w * 0.5f, fy, w, 3.f, SDL_Color{ 40, 36, 32, (Uint8)(60 + 80 * impact) });
+                }
 
                 m_fx.emitFootDust(fx, fy, 1, +1.f);
                 m_fx.emitFootDust(fx, fy, 1, -1.f);
@@ -728,6 +917,16 @@ namespace Erlik {
             m_fx.update((float)dt);
             m_wasGround = m_player.onGround;
 
+            // Lightmap: sadece hareket eden isiklar (oyuncu feneri) yeniden hesaplanir
+            if (m_lighting) {
+                m_lights.moveLight(m_playerLight, m_player.x, m_player.y);
+                m_lights.update(m_map);
+            }
+
+            // Runtime tile edit'leri: kirli chunk / static cache hucreleri / rect'ler kare basina bir kez
+            m_tmj.flushEdits(m_renderer, &m_map);
+            m_minimap.flush();
+
             m_res.check(false);    // hot-reload dosya izleme
         }
 
@@ -823,12 +1022,11 @@ namespace Erlik {
         m_time += dt;
     }
 
-    void Application::render() {
-        m_r2d->beginFrame();
-        m_r2d->setCamera(m_cam);
-        m_r2d->clear(12, 12, 16, 255);
-
+    // Dunya katmanlari + oyuncu + efektler; aktif kamera/viewport ile cizer
+    // (ana ekran ve PiP ayni yolu kullanir).
+    void Application::renderWorld() {
         if (m_dbgShowBG) m_tmj.drawBelowPlayer(*m_r2d);
+        m_decals.draw(*m_r2d);
 
         // Player
         if (const SDL_Rect* fr = m_atlas.frame(m_anim.index())) {
@@ -837,16 +1035,65 @@ namespace Erlik {
         }
         else {
             const int rectW = 24, rectH = 32;
-            SDL_FRect r{ (m_player.x - m_cam.x) * m_cam.zoom - rectW * 0.5f,
-                         (m_player.y - m_cam.y) * m_cam.zoom - rectH * 0.5f,
-                         (float)rectW, (float)rectH };
-            SDL_SetRenderDrawColor(m_renderer, 200, 200, 220, 255);
-            SDL_RenderFillRectF(m_renderer, &r);
+            const Camera2D& cam = m_r2d->camera();
+            const SDL_FRect r{ (m_player.x - cam.x) * cam.zoom - rectW * 0.5f,
+                               (m_player.y - cam.y) * cam.zoom - rectH * 0.5f,
+                               (float)rectW, (float)rectH };
+            m_r2d->fillRectScreen(r, SDL_Color{ 200,200,220,255 });
         }
         m_fx.draw(*m_r2d);
 
+        // Swarm govdeleri (temastayken kirmizi)
+        for (int id : m_swarm) {
+            const Player b = m_world.body(id);
+            const SDL_Color c = m_world.contacts().overlapping(id) ? SDL_Color{ 230,80,80,255 } : SDL_Color{ 120,200,140,255 };
+            m_r2d->fillRect(b.x - b.halfW, b.y - b.halfH, b.halfW * 2.f, b.halfH * 2.f, c);
+        }
+
+        // Kinematik platformlar: sadece gorunur alandakiler (PlatformSet grid sorgusu)
+        {
+            const PlatformSet& ps = m_world.platforms();
+            const Camera2D& cam = m_r2d->camera();
+            int vw, vh; m_r2d->outputSize(vw, vh);
+            ps.query(cam.x, cam.y, cam.x + vw / cam.zoom, cam.y + vh / cam.zoom, m_platVis);
+            for (int id : m_platVis) {
+                const KinematicPlatform& d = ps.get(id);
+                float x, y; ps.positionAt(id, ps.time(), x, y);
+                const SDL_Color c = d.oneWay ? SDL_Color{ 180,140,80,255 } : SDL_Color{ 140,120,100,255 };
+                m_r2d->fillRect(x, y, d.w, d.h, c);
+            }
+        }
+
         if (m_dbgShowFG) m_tmj.drawAbovePlayer(*m_r2d);
 
+        // Lighting: lightmap'i world'un ustune tek MOD blit
+        if (m_lighting) m_lights.draw(*m_r2d);
+    }
+
+    void Application::render() {
+        // Bekleyen decal stamp'lerini pisir (render target degisimi: viewport'lardan once)
+        m_decals.flush();
+
+        m_r2d->beginFrame();
+        m_r2d->setCamera(m_cam);
+        m_r2d->clear(12, 12, 16, 255);
+
+        renderWorld();
+        m_dcMain = m_r2d->drawCalls();
+
+        // PiP: ayni layer cache / draw list'leri ikinci kamera ile ciz
+        m_dcPip = 0;
+        if (m_pipActive) {
+            int vw, vh; m_r2d->outputSize(vw, vh);
+            const SDL_Rect vp{ 10, vh - PIP_H - 10, PIP_W, PIP_H };
+            m_r2d->beginViewport(vp, m_pipCam);
+            m_r2d->fillRect(m_pipCam.x, m_pipCam.y, PIP_W / m_pipCam.zoom, PIP_H / m_pipCam.zoom,
+                SDL_Color{ 12,12,16,255 });
+            renderWorld();
+            m_r2d->endViewport();
+            m_dcPip = m_r2d->drawCalls() - m_dcMain;
+        }
+
         if (m_dbgOverlay) {
             int vw, vh; m_r2d->outputSize(vw, vh);
 
@@ -854,17 +1101,17 @@ namespace Erlik {
             const int lh = 18;
             const int colW = 160;
             const int cols = 2;
-            const int rows = 5;
+            const int rows = 7;
             const int panelW = pad * (cols + 1) + colW * cols;
             const int panelH = pad * 2 + lh * rows;
 
-            SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
-            SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 160);
-            SDL_FRect bg{ (float)(vw - panelW - 10), 10.f, (float)panelW, (float)panelH };
-            SDL_RenderFillRectF(m_renderer, &bg);
-            SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
+            const SDL_FRect bg{ (float)(vw - panelW - 10), 10.f, (float)panelW, (float)panelH };
+            m_r2d->fillRectScreen(bg, SDL_Color{ 0,0,0,160 });
 
             if (m_dbgShowCol) {
+                m_map.drawCollisionDebug(*m_r2d);
+                m_nav.drawDebug(*m_r2d);
+                m_activity.drawDebug(*m_r2d);
                 m_tmj.drawTriggersDebug(*m_r2d);
             }
 
@@ -885,7 +1132,7 @@ namespace Erlik {
                 std::snprintf(line, sizeof(line), "FPS: %.1f", m_currentFPS);
                 m_text.draw(line, xL, yL, cWhite, 1.0f);  yL += dy;
 
-                std::snprintf(line, sizeof(line), "DrawCalls: %d", m_r2d->drawCalls());
+                std::snprintf(line, sizeof(line), "DrawCalls: %d (pip %d)", m_dcMain, m_dcPip);
                 m_text.draw(line, xL, yL, cGreen, 1.0f);  yL += dy;
 
                 std::snprintf(line, sizeof(line), "Player");
@@ -897,6 +1144,10 @@ namespace Erlik {
                 std::snprintf(line, sizeof(line), "y=%.1f", m_player.y);
                 m_text.draw(line, xL, yL, cYellow, 1.0f); yL += dy;
 
+                std::snprintf(line, sizeof(line), "Decals: %d (%zuKB)",
+                    m_decals.liveChunks(), m_decals.bytesUsed() / 1024);
+                m_text.draw(line, xL, yL, cWhite, 1.0f); yL += dy;
+
                 std::snprintf(line, sizeof(line), "Zoom: %.2f", m_cam.zoom);
                 m_text.draw(line, xR, yR, cWhite, 1.0f);  yR += dy;
 
@@ -906,9 +1157,10 @@ namespace Erlik {
                 m_text.draw(line, xR, yR, cGreen, 1.0f);  yR += dy;
 
                 std::string keyList;
-                for (auto it = m_keys.begin(); it != m_keys.end(); ++it) {
-                    if (it != m_keys.begin()) keyList += ",";
-                    keyList += *it;
+                for (Sym k = 1; k < (Sym)m_keyHeld.size(); ++k) {
+                    if (!m_keyHeld[k]) continue;
+                    if (!keyList.empty()) keyList += ",";
+                    keyList += m_tmj.symbols().str(k);
                 }
                 std::snprintf(line, sizeof(line), "Keys: %s", keyList.empty() ? "-" : keyList.c_str());
                 m_text.draw(line, xR, yR, cYellow, 1.0f);  yR += dy;
@@ -917,6 +1169,15 @@ namespace Erlik {
 
                 std::snprintf(line, sizeof(line), "COL/Triggers: %s", m_dbgShowCol ? "on" : "off");
                 m_text.draw(line, xR, yR, cYellow, 1.0f); yR += dy;
+
+                std::snprintf(line, sizeof(line), "Light: %s n=%d upd=%d",
+                    m_lighting ? "on" : "off", m_lights.lightCount(), m_lights.lastRebuiltLights());
+                m_text.draw(line, xR, yR, cWhite, 1.0f); yR += dy;
+
+                std::snprintf(line, sizeof(line), "Bodies: %d/%d awake pairs=%d +%d/-%d",
+                    m_world.activeCount(), m_world.bodyCount(), (int)m_world.contacts().pairs().size(),
+                    (int)m_world.contacts().entered().size(), (int)m_world.contacts().exited().size());
+                m_text.draw(line, xR, yR, cGreen, 1.0f); yR += dy;
             }
             else {
                 char title[128];
@@ -942,17 +1203,6 @@ namespace Erlik {
             m_text.draw(tt.text.c_str(), x, y + (int)i * 18, SDL_Color{ 255,255,255,aText }, 1.0f);
         }
 
-        // platform debug çizimi
-        for (auto& pl : m_platforms) {
-            SDL_FRect r{
-                (pl.x - m_cam.x) * m_cam.zoom,
-                (pl.y - m_cam.y) * m_cam.zoom,
-                pl.w * m_cam.zoom, pl.h * m_cam.zoom
-            };
-            SDL_SetRenderDrawColor(m_renderer, 180, 140, 80, 255);
-            SDL_RenderFillRectF(m_renderer, &r);
-        }
-
         // HUD title
         static double accum = 0.0; static int frames = 0;
         int tile = m_map.tileSize();
@@ -989,29 +1239,25 @@ namespace Erlik {
 
             Uint8 alpha = (Uint8)std::round(220.f * a);
 
-            SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
-            SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, (Uint8)(140 * a));
-            SDL_FRect bg{ 10.f, 10.f, (float)std::min(vw - 20, 420), 28.f };
-            SDL_RenderFillRectF(m_renderer, &bg);
+            const SDL_FRect bg{ 10.f, 10.f, (float)std::min(vw - 20, 420), 28.f };
+            m_r2d->fillRectScreen(bg, SDL_Color{ 0,0,0,(Uint8)(140 * a) });
 
-            SDL_SetRenderDrawColor(m_renderer, m_hudColor.r, m_hudColor.g, m_hudColor.b, alpha);
-            SDL_FRect bar{ bg.x + 4.f, bg.y + 4.f, 8.f, bg.h - 8.f };
-            SDL_RenderFillRectF(m_renderer, &bar);
-
-            SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
+            const SDL_FRect bar{ bg.x + 4.f, bg.y + 4.f, 8.f, bg.h - 8.f };
+            m_r2d->fillRectScreen(bar, SDL_Color{ m_hudColor.r, m_hudColor.g, m_hudColor.b, alpha });
+        }
+        // Minimap (sag alt kose): tek blit + marker'lar
+        if (m_showMinimap && m_minimap.ready()) {
+            int vw, vh; m_r2d->outputSize(vw, vh);
+            const float mw = 260.f, mh = 160.f;
+            m_minimap.draw(*m_r2d, (float)vw - mw - 10.f, (float)vh - mh - 10.f, mw, mh,
+                m_player.x, m_player.y, m_tmj.triggers());
         }
+
         // --- Door Fade Overlay (ekran üstü) ---
         if (m_doorFxActive && m_doorAlpha > 0.f) {
             int vw, vh; m_r2d->outputSize(vw, vh);
-            SDL_BlendMode prev;
-            SDL_GetRenderDrawBlendMode(m_renderer, &prev);
-            SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
-            Uint8 a = (Uint8)std::clamp(m_doorAlpha * 255.f, 0.f, 255.f);
-            SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, a);
-            SDL_FRect full{ 0.f, 0.f, (float)vw, (float)vh };
-            SDL_RenderFillRectF(m_renderer, &full);
-            SDL_SetRenderDrawBlendMode(m_renderer, prev);
-            
+            const Uint8 a = (Uint8)std::clamp(m_doorAlpha * 255.f, 0.f, 255.f);
+            m_r2d->fillRectScreen(SDL_FRect{ 0.f, 0.f, (float)vw, (float)vh }, SDL_Color{ 0,0,0,a });
         }
 
         m_r2d->present();
@@ -1054,4 +1300,73 @@ namespace Erlik {
         m_toasts.push_back(std::move(t));
     }
 
+    void Application::rebuildLights() {
+        m_playerLight = -1;
+        if (!m_lights.init(m_renderer, (int)m_worldW, (int)m_worldH, 8)) {
+            m_lighting = false;
+            return;
+        }
+
+        uint8_t ar = 48, ag = 48, ab = 64;
+        const bool mapAmbient = m_tmj.ambient(ar, ag, ab);
+        m_lights.setAmbient(ar, ag, ab);
+
+        for (const auto& d : m_tmj.lights()) {
+            PointLight l;
+            l.x = d.x; l.y = d.y; l.radius = d.radius;
+            l.r = d.r; l.g = d.g; l.b = d.b;
+            l.intensity = d.intensity; l.shadows = d.shadows;
+            m_lights.addLight(l);
+        }
+        // Kapilarin ustune sicak bir lamba
+        for (const auto& tr : m_tmj.triggers()) {
+            if (tr.type != TriggerType::Door) continue;
+            PointLight l;
+            l.x = tr.x + tr.w * 0.5f; l.y = tr.y + 8.f;
+            l.radius = 140.f; l.r = 255; l.g = 190; l.b = 120;
+            m_lights.addLight(l);
+        }
+        // Oyuncu feneri (her kare tasinir)
+        {
+            PointLight l;
+            l.x = m_player.x; l.y = m_player.y;
+            l.radius = 180.f; l.r = 255; l.g = 235; l.b = 200; l.intensity = 0.9f;
+            m_playerLight = m_lights.addLight(l);
+        }
+
+        // Harita isik/ambient tanimliyorsa varsayilan acik
+        m_lighting = mapAmbient || !m_tmj.lights().empty();
+    }
+
+    void Application::rebuildPlatforms() {
+        PlatformSet& ps = m_world.platforms();
+        ps.clear();
+        for (const auto& d : m_tmj.platforms()) {
+            KinematicPlatform k;
+            k.x = d.x; k.y = d.y; k.w = d.w; k.h = d.h;
+            k.toX = d.x + d.dx; k.toY = d.y + d.dy;
+            k.speed = d.speed; k.phase = d.phase; k.oneWay = d.oneWay;
+            ps.add(k);
+        }
+        // Haritada "platforms" katmani yoksa eski demo platformu (tile 18..28 arasi, 17. satir)
+        if (ps.count() == 0) {
+            KinematicPlatform k;
+            k.w = 96.f; k.h = 16.f;
+            k.x = 32.f * 18.f;           k.y = 32.f * 17.f;
+            k.toX = 32.f * 28.f - k.w;  k.toY = k.y;
+            k.speed = 80.f;
+            ps.add(k);
+        }
+        ps.build();
+        SDL_Log("[platforms] %d kinematic platform(s)", ps.count());
+    }
+
+    void Application::rebuildActivity() {
+        buildActivityMap(m_activity, m_tmj, m_worldW, m_worldH);
+    }
+
+    void Application::rebuildNav() {
+        buildNavGraph(m_nav, m_map, m_pp, m_player.halfW, m_player.halfH);
+    }
+
 } // namespace Erlik
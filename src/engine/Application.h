@@ -13,8 +13,17 @@
 #include "TextRenderer.h"
 #include "AnimatorController.h"
 #include "Particles.h"
+#include "Lighting.h"
+#include "Minimap.h"
+#include "Decals.h"
+#include "Jobs.h"
+#include "AssetLoader.h"
+#include "PhysicsWorld.h"
+#include "NavGraph.h"
+#include "Activity.h"
 #include <unordered_set>
 #include <deque>
+#include <memory>
 
 
 struct SDL_Window;
@@ -22,12 +31,6 @@ struct SDL_Renderer;
 
 namespace Erlik {
 
-    struct Platform {
-        float x = 0.f, y = 0.f, w = 96.f, h = 16.f;
-        float vx = 0.f, vy = 0.f;
-        float minX = 0.f, maxX = 0.f; // yatay salnm snrlar
-    };
-
     class Application {
     public:
         int run();
@@ -68,6 +71,19 @@ namespace Erlik {
 
         // Kaynak & hot reload
         ResourceManager m_res;
+        AssetLoader     m_assets;  // off-thread decode; upload update()'te butceli pump
+
+        // TMJ hot reload (cift tampon): yeni harita arka planda hazirlanir, kare basinda takas
+        std::unique_ptr<TMJMap>  m_tmjNext, m_tmjRetired;   // retired: bir sonraki karede birakilir
+        std::unique_ptr<Tilemap> m_mapNext, m_mapRetired;
+        // Tilemap'e bagli CPU isleri de worker'da m_mapNext uzerine kurulur; takas karesinde GPU kalir
+        std::unique_ptr<NavGraph>    m_navNext;
+        std::unique_ptr<ActivityMap> m_activityNext;
+        std::vector<Uint32>          m_minimapNext; // Minimap::colorize ciktisi
+        AssetLoader::Handle      m_tmjJob = -1;
+        bool                     m_tmjReloadAgain = false; // hazirlik surerken dosya yine degisti
+        void startTmjReload();
+        void pollTmjReload();
         std::string     m_tmjPath; // izlediimiz tmj dosyas
         
         // --- HUD: HotReload bildirimi ---
@@ -95,6 +111,30 @@ namespace Erlik {
         //Particles
         Erlik::ParticleSystem m_fx;
 
+        // 2D lighting (CPU lightmap, MOD blit)
+        LightMap m_lights;
+        bool     m_lighting = false;  // L ile ac/kapa
+        int      m_playerLight = -1;
+        void     rebuildLights();     // harita yuklenince / hot reload
+        void     rebuildPlatforms();  // TMJ "platforms" -> m_world (harita yuklenince / hot reload)
+        void     rebuildNav();        // AI navigasyon grafi (collision + m_pp); tile edit'lerinde patch
+        void     rebuildActivity();   // TMJ "rooms" (yoksa kaba grid) -> uyku bolgeleri
+
+        // Minimap (tile basina 1 texel, incremental update)
+        Minimap  m_minimap;
+        bool     m_showMinimap = true; // M ile ac/kapa
+
+        // Kalici decal katmani (partikul izleri, stamp'ler)
+        DecalLayer m_decals;
+
+        // Picture-in-picture: kapi hedefini ikinci viewport'ta goster (V ile ac/kapa)
+        static constexpr int PIP_W = 320, PIP_H = 180;
+        bool     m_pipEnabled = true;
+        bool     m_pipActive = false;
+        Camera2D m_pipCam;
+        int      m_dcMain = 0, m_dcPip = 0; // son karedeki draw call'lar
+        void     renderWorld();
+
         // Visuals
         SpriteAtlas m_atlas;
         Animator    m_anim;
@@ -110,8 +150,17 @@ namespace Erlik {
         bool  m_follow = true;
         double m_time = 0.0;
 
-        // Platforms
-        std::vector<Platform> m_platforms;
+        // Fizik dunyasi (SoA govdeler, paralel integrate); oyuncu da bir govde
+        JobPool      m_jobs;
+        PhysicsWorld m_world;
+        NavGraph     m_nav;
+        ActivityMap  m_activity;          // kameraya yakin bolgeler uyanik; digerleri uyur
+        float        m_activityMargin = 384.f; // gorus kutusuna eklenen pay (px)
+        int          m_playerBody = -1;
+        std::vector<int> m_swarm;         // B ile eklenen debug govdeleri
+        std::vector<int> m_platVis;       // renderWorld: PlatformSet::query scratch
+        void         spawnSwarm(int count);
+        int          breakTilesAhead();   // E: bakilan yondeki solid hucreleri kir
 
         //Cam Lerp
         float m_camLerp = 0.15f;     // 0..1  (takip hz)
@@ -142,17 +191,17 @@ namespace Erlik {
         float m_runDustMinSpd = 35.0f; // tetik eii (px/s)
 
         // Trigger state
-        std::unordered_set<int> m_triggersFired; // once=true olanlar iin
+        std::vector<int> m_trigHits, m_trigStart; // TMJMap::queryTriggers scratch (kare basina)
         float m_spawnX = 0.f, m_spawnY = 0.f;    // checkpoint noktas
         int   m_saveSlot = 1;                    // aktif kayt slotu (1..3)
 
         // Inventory: anahtarlar
-        std::unordered_set<std::string> m_keys;
+        std::vector<uint8_t> m_keyHeld;  // Sym (m_tmj.symbols()) -> anahtar var mi
 
         // Music region state
         int         m_activeMusicRegionId = -1;
-        std::string m_musicCurrent;      // u an alan (biz takip ediyoruz)
-        std::string m_musicBeforeRegion; // regiona girmeden nce alan
+        Sym         m_musicCurrent = 0;      // su an calan (biz takip ediyoruz; 0 = yok)
+        Sym         m_musicBeforeRegion = 0; // region'a girmeden once calan
 
 
     };
@@ -0,0 +1,305 @@
+#include "AssetLoader.h"
+#include "Audio.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+
+namespace Erlik {
+
+    AssetLoader::AssetLoader(int threads)
+    {
+        if (threads < 1) threads = 1;
+        m_threads.reserve(threads);
+        for (int i = 0; i < threads; ++i)
+            m_threads.emplace_back([this] { workerLoop(); });
+    }
+
+    AssetLoader::~AssetLoader() { shutdown(); }
+
+    void AssetLoader::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            if (m_quit && m_threads.empty()) return;
+            m_quit = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads) t.join();
+        m_threads.clear();
+
+        // Decode edilmis ama teslim alinmamis kaynaklar (Mix_Quit'ten once birakilmali)
+        for (Slot& s : m_slots) release(s);
+        m_queue.clear(); m_done.clear(); m_uploads.clear();
+        m_pendingSfx.clear(); m_pendingMusic.clear();
+        m_pending = 0;
+    }
+
+    AssetLoader::Handle AssetLoader::submit(Kind k, const std::string& name, const std::string& path, const std::string& fallback,
+        std::function<bool()> task)
+    {
+        // Ayni isimle bekleyen ses isi varsa onu dondur: ilk istek kazanir, cift decode olmaz
+        const bool audio = k == Kind::Sfx || k == Kind::Music;
+        if (audio) {
+            const auto it = pendingAudio(k).find(name);
+            if (it != pendingAudio(k).end()) {
+                ++slotOf(it->second)->refs;
+                return it->second;
+            }
+        }
+
+        std::lock_guard<std::mutex> lk(m_mx);
+        if (m_quit) return -1;
+        Slot* s = nullptr;
+        if (!m_freeSlots.empty()) {
+            s = &m_slots[m_freeSlots.back()];
+            m_freeSlots.pop_back();
+        }
+        else {
+            if ((int)m_slots.size() > INDEX_MASK) { SDL_Log("[assets] too many live handles"); return -1; }
+            s = &m_slots.emplace_back();
+            s->index = (int)m_slots.size() - 1;
+        }
+        s->kind = k; s->name = name; s->path = path; s->fallback = fallback;
+        s->task = std::move(task);
+        s->state = State::Pending;
+        s->ok = false;
+        s->refs = 1;
+        m_queue.push_back(s);
+        ++m_pending;
+        m_wake.notify_one();
+        const Handle h = handleOf(*s);
+        if (audio) pendingAudio(k)[name] = h;
+        return h;
+    }
+
+    AssetLoader::Slot* AssetLoader::slotOf(Handle h)
+    {
+        if (h < 0 || (h & INDEX_MASK) >= (int)m_slots.size()) return nullptr;
+        Slot& s = m_slots[h & INDEX_MASK];
+        return s.gen == (h >> INDEX_BITS) ? &s : nullptr;
+    }
+
+    const AssetLoader::Slot* AssetLoader::slotOf(Handle h) const
+    {
+        return const_cast<AssetLoader*>(this)->slotOf(h);
+    }
+
+    AssetLoader::Handle AssetLoader::handleOf(const Slot& s) const
+    {
+        return ((Handle)s.gen << INDEX_BITS) | s.index;
+    }
+
+    // Nesil hemen artar: elde kalan eski handle'lar artik bu slotu gormez
+    void AssetLoader::recycle(Slot& s)
+    {
+        release(s);
+        s.task = nullptr;
+        s.path.clear(); s.fallback.clear(); s.name.clear();
+        s.gen = (uint16_t)((s.gen + 1) & GEN_MASK);
+        m_freeSlots.push_back(s.index);
+    }
+
+    void AssetLoader::release(Handle h)
+    {
+        Slot* s = slotOf(h);
+        if (!s || s->refs <= 0) return;
+        if (--s->refs == 0 && s->state != State::Pending) recycle(*s);
+    }
+
+    AssetLoader::Handle AssetLoader::loadTexture(const std::string& path, const std::string& fallback)
+    {
+        return submit(Kind::Texture, std::string(), path, fallback == path ? std::string() : fallback);
+    }
+
+    AssetLoader::Handle AssetLoader::loadSfx(const std::string& name, const std::string& path)
+    {
+        return submit(Kind::Sfx, name, path, std::string());
+    }
+
+    AssetLoader::Handle AssetLoader::loadMusic(const std::string& name, const std::string& path)
+    {
+        return submit(Kind::Music, name, path, std::string());
+    }
+
+    AssetLoader::Handle AssetLoader::run(std::function<bool()> job)
+    {
+        return submit(Kind::Task, std::string(), std::string(), std::string(), std::move(job));
+    }
+
+    void AssetLoader::workerLoop()
+    {
+        for (;;) {
+            Slot* s = nullptr;
+            {
+                std::unique_lock<std::mutex> lk(m_mx);
+                m_wake.wait(lk, [this] { return m_quit || !m_queue.empty(); });
+                if (m_quit) return;
+                s = m_queue.front();
+                m_queue.pop_front();
+            }
+            decode(*s);
+            {
+                std::lock_guard<std::mutex> lk(m_mx);
+                m_done.push_back(s);
+            }
+            m_doneCv.notify_one();
+        }
+    }
+
+    // Worker thread: yalnizca thread-safe cagrilar (dosya + decode + format donusumu)
+    void AssetLoader::decode(Slot& s)
+    {
+        switch (s.kind) {
+        case Kind::Texture: {
+            std::string used;
+            s.surf = decodeImage(s.path, s.fallback, &used);
+            if (s.surf) s.path.swap(used);
+            s.ok = s.surf != nullptr;
+            break;
+        }
+        case Kind::Sfx:
+            s.chunk = Mix_LoadWAV(s.path.c_str());
+            if (!s.chunk) SDL_Log("[audio] SFX load failed '%s': %s", s.path.c_str(), Mix_GetError());
+            s.ok = s.chunk != nullptr;
+            break;
+        case Kind::Music:
+            s.music = Mix_LoadMUS(s.path.c_str());
+            if (!s.music) SDL_Log("[audio] Music load failed '%s': %s", s.path.c_str(), Mix_GetError());
+            s.ok = s.music != nullptr;
+            break;
+        case Kind::Task:
+            try {
+                s.ok = s.task && s.task();
+            }
+            catch (...) {
+                SDL_Log("[assets] background job threw");
+                s.ok = false;
+            }
+            break;
+        }
+    }
+
+    SDL_Surface* AssetLoader::decodeImage(const std::string& path, const std::string& fallback, std::string* used)
+    {
+        const std::string* from = &path;
+        SDL_Surface* surf = IMG_Load(path.c_str());
+        if (!surf && !fallback.empty() && fallback != path) {
+            surf = IMG_Load(fallback.c_str());
+            from = &fallback;
+        }
+        if (!surf) { SDL_Log("[assets] image load failed '%s': %s", path.c_str(), IMG_GetError()); return nullptr; }
+        // Renderer'in dogal formatina burada cevir: ana thread'de SDL_CreateTextureFromSurface
+        // yalnizca kopyalar (palet/colorkey/24-bit donusumu worker'da kalir)
+        if (surf->format->format != SDL_PIXELFORMAT_ARGB8888) {
+            SDL_Surface* conv = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0);
+            if (conv) { SDL_FreeSurface(surf); surf = conv; }
+        }
+        if (used) *used = *from;
+        return surf;
+    }
+
+    bool AssetLoader::complete(Slot& s, SDL_Renderer* r)
+    {
+        switch (s.kind) {
+        case Kind::Texture:
+            if (s.surf) s.ok = s.tex.createFromSurface(r, s.surf);
+            break;
+        case Kind::Sfx:
+            if (s.chunk) { s.ok = Audio::adoptSfx(s.name, s.chunk); s.chunk = nullptr; }
+            break;
+        case Kind::Music:
+            if (s.music) { s.ok = Audio::adoptMusic(s.name, s.music); s.music = nullptr; }
+            break;
+        case Kind::Task:
+            s.task = nullptr;   // yakalanan veriler ana thread'de birakilir
+            break;
+        }
+        if (s.surf) { SDL_FreeSurface(s.surf); s.surf = nullptr; }
+        s.state = s.ok ? State::Ready : State::Failed;
+        if (s.kind == Kind::Sfx || s.kind == Kind::Music) {
+            auto& pend = pendingAudio(s.kind);
+            const auto it = pend.find(s.name);
+            if (it != pend.end() && it->second == handleOf(s)) pend.erase(it);
+        }
+        const bool ok = s.ok;
+        if (s.refs == 0) recycle(s); // sonucu bekleyen yok (preload)
+        return ok;
+    }
+
+    void AssetLoader::release(Slot& s)
+    {
+        if (s.surf)  { SDL_FreeSurface(s.surf); s.surf = nullptr; }
+        if (s.chunk) { Mix_FreeChunk(s.chunk); s.chunk = nullptr; }
+        if (s.music) { Mix_FreeMusic(s.music); s.music = nullptr; }
+        s.tex.destroy();
+    }
+
+    int AssetLoader::pump(SDL_Renderer* r, double budgetMs)
+    {
+        if (m_pending == 0) return 0;
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_uploads.insert(m_uploads.end(), m_done.begin(), m_done.end());
+            m_done.clear();
+        }
+
+        const Uint64 t0 = SDL_GetPerformanceCounter();
+        const double toMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+        int finished = 0;
+        while (!m_uploads.empty()) {
+            Slot* s = m_uploads.front();
+            m_uploads.pop_front();
+            complete(*s, r);
+            ++finished; --m_pending;
+            if (budgetMs > 0.0 && (double)(SDL_GetPerformanceCounter() - t0) * toMs >= budgetMs) break;
+        }
+        return finished;
+    }
+
+    AssetLoader::State AssetLoader::wait(Handle h, SDL_Renderer* r)
+    {
+        while (state(h) == State::Pending) {
+            pump(r, 0.0);
+            if (state(h) != State::Pending) break;
+            std::unique_lock<std::mutex> lk(m_mx);
+            m_doneCv.wait(lk, [this] { return !m_done.empty() || m_quit; });
+            if (m_quit) break;
+        }
+        return state(h);
+    }
+
+    void AssetLoader::finish(SDL_Renderer* r)
+    {
+        while (m_pending > 0) {
+            pump(r, 0.0);
+            if (m_pending == 0) break;
+            std::unique_lock<std::mutex> lk(m_mx);
+            m_doneCv.wait(lk, [this] { return !m_done.empty() || m_quit; });
+            if (m_quit) break;
+        }
+    }
+
+    AssetLoader::State AssetLoader::state(Handle h) const
+    {
+        const Slot* s = slotOf(h);
+        return s ? s->state : State::Failed;
+    }
+
+    bool AssetLoader::takeTexture(Handle h, Texture& out)
+    {
+        Slot* s = slotOf(h);
+        if (!s || s->state != State::Ready || s->kind != Kind::Texture) return false;
+        out = std::move(s->tex);
+        release(h);
+        return out.sdl() != nullptr;
+    }
+
+    const std::string& AssetLoader::path(Handle h) const
+    {
+        static const std::string empty;
+        const Slot* s = slotOf(h);
+        if (!s || s->state != State::Ready) return empty;
+        return s->path;
+    }
+
+} // namespace Erlik
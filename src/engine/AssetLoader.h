@@ -0,0 +1,123 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Texture.h"
+
+struct SDL_Surface;
+struct SDL_Renderer;
+struct Mix_Chunk;
+typedef struct _Mix_Music Mix_Music;
+
+namespace Erlik {
+
+    // Asenkron asset yukleyici. Dosya okuma + decode (IMG_Load, Mix_LoadWAV, Mix_LoadMUS)
+    // worker thread'lerde yapilir; ana thread'e yalnizca texture upload (SDL renderer
+    // thread-safe degil) ve ses kaydi kalir, o da pump() ile kare basina butceli.
+    // IMG_Init ve Audio::init worker'lar is almadan once ana thread'de cagrilmis olmali.
+    // Handle = slot indeksi + nesil: sonuc release()/takeTexture'a kadar tutulur, sonra slot
+    // yeniden kullanilir; eski handle'lar Failed gorur (oturum boyunca buyume yok).
+    class AssetLoader {
+    public:
+        using Handle = int;                 // -1: gecersiz
+        enum class State : uint8_t { Pending, Ready, Failed };
+
+        // threads: decode worker sayisi (disk + decode; 2 genelde yeterli)
+        explicit AssetLoader(int threads = 2);
+        ~AssetLoader();
+        AssetLoader(const AssetLoader&) = delete;
+        AssetLoader& operator=(const AssetLoader&) = delete;
+
+        // Is kuyruga girer, hemen doner. fallback: ilk yol acilmazsa denenecek ikinci yol
+        Handle loadTexture(const std::string& path, const std::string& fallback = {});
+        // Hazir oldugunda Audio'ya 'name' ile kaydedilir (Audio::adoptSfx/adoptMusic).
+        // Ayni isimde bekleyen is varsa yeni is acilmaz, onun handle'i doner (ikisi de release eder).
+        Handle loadSfx(const std::string& name, const std::string& path);
+        Handle loadMusic(const std::string& name, const std::string& path);
+        // Sonucu beklenmeyen ses yuklemeleri: handle hemen birakilir, slot bitince geri doner
+        void   preloadSfx(const std::string& name, const std::string& path) { release(loadSfx(name, path)); }
+        void   preloadMusic(const std::string& name, const std::string& path) { release(loadMusic(name, path)); }
+        // Genel arka plan isi (ornek: hot reload'da harita hazirligi). job worker'da calisir;
+        // donus degeri Ready/Failed olur. job yalnizca kendine ait veriye dokunmali.
+        Handle run(std::function<bool()> job);
+
+        // Thread-safe decode (worker'lar ve run() isleri icin): IMG_Load (+fallback) ve
+        // renderer'in dogal formatina donusum. used: basarili olan yol. Hata: nullptr
+        static SDL_Surface* decodeImage(const std::string& path, const std::string& fallback, std::string* used = nullptr);
+
+        // Ana thread: biten decode'lari teslim alir; texture upload'lari budgetMs dolana
+        // kadar yapar (en az bir tane). Donus: bu cagride Ready/Failed olan is sayisi.
+        int  pump(SDL_Renderer* r, double budgetMs = 2.0);
+        // Ana thread: h bitene kadar pump eder (butcesiz); kalan isler de ilerler
+        State wait(Handle h, SDL_Renderer* r);
+        // Ana thread: kuyruk bosalana kadar pump eder
+        void finish(SDL_Renderer* r);
+
+        State state(Handle h) const;
+        bool  ready(Handle h) const { return state(h) == State::Ready; }
+        int   pendingCount() const { return m_pending; }
+        // Ready texture'u out'a tasir ve handle'i birakir. Ready degilse false (handle durur)
+        bool  takeTexture(Handle h, Texture& out);
+        const std::string& path(Handle h) const; // basarili yuklenen yol (fallback olabilir)
+        // Handle ile isi biten cagiran birakir; bekleyen is bitince slot geri doner. Eski
+        // handle ile cagri etkisiz
+        void  release(Handle h);
+
+        // Worker'lari durdurur, teslim edilmemis surface/chunk'lari birakir.
+        // Audio::shutdown / SDL_Quit'ten once cagrilmali; ikinci cagri etkisiz.
+        void shutdown();
+
+    private:
+        enum class Kind : uint8_t { Texture, Sfx, Music, Task };
+        struct Slot {
+            Kind        kind = Kind::Texture;
+            State       state = State::Pending;  // yalnizca ana thread yazar (pump)
+            uint16_t    gen = 0;                 // handle nesli: slot her geri donuste artar
+            int         index = 0;               // m_slots icindeki yeri (handle'in alt bitleri)
+            int         refs = 0;                // handle tutan cagiran sayisi (0 + bitti: bos)
+            std::string path, fallback, name;
+            // Worker ciktisi (m_done'a girene kadar yalnizca worker'a ait)
+            SDL_Surface* surf = nullptr;
+            Mix_Chunk*   chunk = nullptr;
+            Mix_Music*   music = nullptr;
+            bool         ok = false;
+            Texture      tex;
+            std::function<bool()> task;
+        };
+
+        Handle submit(Kind k, const std::string& name, const std::string& path, const std::string& fallback,
+            std::function<bool()> task = {});
+        void   workerLoop();
+        void   decode(Slot& s);
+        bool   complete(Slot& s, SDL_Renderer* r); // ana thread: upload/kayit
+        void   release(Slot& s);
+        Slot*  slotOf(Handle h);                   // gecerli nesil degilse nullptr
+        const Slot* slotOf(Handle h) const;
+        Handle handleOf(const Slot& s) const;
+        void   recycle(Slot& s);                   // biten + birakilan slotu bos listeye
+        std::unordered_map<std::string, Handle>& pendingAudio(Kind k) { return k == Kind::Sfx ? m_pendingSfx : m_pendingMusic; }
+
+        // Handle: dusuk INDEX_BITS slot indeksi, ustu nesil (negatif olmaz)
+        static constexpr int INDEX_BITS = 20;
+        static constexpr int INDEX_MASK = (1 << INDEX_BITS) - 1;
+        static constexpr int GEN_MASK = (1 << (31 - INDEX_BITS)) - 1;
+
+        std::deque<Slot>         m_slots;   // deque: push_back referanslari bozmaz
+        std::vector<int>         m_freeSlots; // geri donen slot indeksleri (ana thread)
+        std::unordered_map<std::string, Handle> m_pendingSfx, m_pendingMusic; // isim -> bekleyen is
+        std::vector<std::thread> m_threads;
+        std::mutex               m_mx;
+        std::condition_variable  m_wake, m_doneCv;
+        std::deque<Slot*>        m_queue;   // decode bekleyen
+        std::vector<Slot*>       m_done;    // decode bitti, ana thread bekliyor
+        std::deque<Slot*>        m_uploads; // ana thread: butce yuzunden sonraki kareye kalan
+        int                      m_pending = 0; // ana thread sayaci (submit - tamamlanan)
+        bool                     m_quit = false;
+    };
+
+} // namespace Erlik
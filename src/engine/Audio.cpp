@@ -72,6 +72,24 @@ namespace Erlik {
             return true;
         }
 
+        bool adoptSfx(const std::string& name, Mix_Chunk* chunk) {
+            if (!chunk) return false;
+            if (!g_ready) { Mix_FreeChunk(chunk); return false; }
+            Mix_Chunk*& slot = g_sfx[name];
+            if (slot && slot != chunk) Mix_FreeChunk(slot);
+            slot = chunk;
+            return true;
+        }
+
+        bool adoptMusic(const std::string& name, Mix_Music* music) {
+            if (!music) return false;
+            if (!g_ready) { Mix_FreeMusic(music); return false; }
+            Mix_Music*& slot = g_music[name];
+            if (slot && slot != music) Mix_FreeMusic(slot); // caliyorsa Mix_FreeMusic durdurur
+            slot = music;
+            return true;
+        }
+
         bool hasMusic(const std::string& name) {
             return g_music.find(name) != g_music.end();
             
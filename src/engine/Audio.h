@@ -1,6 +1,9 @@
 ﻿#pragma once
 #include <string>
 
+struct Mix_Chunk;
+typedef struct _Mix_Music Mix_Music;
+
 namespace Erlik {
     namespace Audio {
         // Yaşam döngüsü
@@ -11,6 +14,10 @@ namespace Erlik {
         bool loadSfx(const std::string& name, const std::string& path);
         bool loadMusic(const std::string& name, const std::string& path);
         bool hasMusic(const std::string& name);
+        // Baska yerde (AssetLoader worker'i) decode edilmis kaynagi sahiplenir; ayni isimdeki
+        // eskisi serbest birakilir. Yalnizca ana thread.
+        bool adoptSfx(const std::string& name, Mix_Chunk* chunk);
+        bool adoptMusic(const std::string& name, Mix_Music* music);
 
         // Çalma (klasik)
         int  playSfx(const std::string& name, int loops = 0, int channel = -1, int volume = -1);
@@ -0,0 +1,648 @@
+#include "Bench.h"
+#include "Broadphase.h"
+#include "Jobs.h"
+#include "LayerCodec.h"
+#include "NavGraph.h"
+#include "Particles.h"
+#include "PhysicsWorld.h"
+#include "Renderer2D.h"
+#include "TMJMap.h"
+#include "Tilemap.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Erlik {
+
+    namespace {
+
+        // Asset yuklemek icin pencere-siz software renderer
+        struct HeadlessSDL {
+            SDL_Surface*  surf = nullptr;
+            SDL_Renderer* r = nullptr;
+
+            bool init() {
+                if (SDL_Init(0) != 0) { std::fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError()); return false; }
+                IMG_Init(IMG_INIT_PNG);
+                surf = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_RGBA8888);
+                if (surf) r = SDL_CreateSoftwareRenderer(surf);
+                if (!r) { std::fprintf(stderr, "software renderer failed: %s\n", SDL_GetError()); return false; }
+                return true;
+            }
+            ~HeadlessSDL() {
+                if (r) SDL_DestroyRenderer(r);
+                if (surf) SDL_FreeSurface(surf);
+                IMG_Quit(); SDL_Quit();
+            }
+        };
+
+        // erlik --bench render [map.tmj] [frames] [--expect <hash>]
+        // Kamera haritayi deterministik bir yolda tarar; null backend komutlari kaydeder.
+        // Frame hash'leri birlestirilip yazdirilir: culling/batching degisikliklerinin
+        // cizilen seyi degistirmedigini CI'da --expect ile dogrula.
+        int benchRender(int argc, char** argv) {
+            std::string path = "assets/level_city.tmj";
+            int frames = 600;
+            const char* expect = nullptr;
+            int pos = 0;
+            for (int i = 0; i < argc; ++i) {
+                if (std::strcmp(argv[i], "--expect") == 0 && i + 1 < argc) { expect = argv[++i]; continue; }
+                if (pos == 0) path = argv[i];
+                else if (pos == 1) frames = std::max(1, std::atoi(argv[i]));
+                pos++;
+            }
+
+            HeadlessSDL sdl;
+            if (!sdl.init()) return 2;
+
+            TMJMap map;
+            if (!map.load(sdl.r, path)) { std::fprintf(stderr, "bench: TMJ load failed: %s\n", path.c_str()); return 2; }
+
+            const int W = 1280, H = 720;
+            Renderer2D r2d(W, H);   // null backend
+            const float mapW = (float)(map.cols() * map.tileW());
+            const float mapH = (float)(map.rows() * map.tileH());
+
+            uint64_t hash = 1469598103934665603ull;
+            size_t   cmds = 0;
+            double   secs = 0.0;
+            const double freq = (double)SDL_GetPerformanceFrequency();
+
+            for (int f = 0; f < frames; ++f) {
+                const float t = (frames > 1) ? (float)f / (float)(frames - 1) : 0.f;
+                Camera2D cam;
+                cam.zoom = 1.0f;
+                cam.x = std::max(0.f, mapW - W) * t;
+                cam.y = std::max(0.f, mapH - H) * (0.5f + 0.5f * std::sin(t * 6.2831853f));
+
+                const Uint64 t0 = SDL_GetPerformanceCounter();
+                r2d.beginFrame();
+                r2d.setCamera(cam);
+                r2d.clear(12, 12, 16, 255);
+                map.drawBelowPlayer(r2d);
+                map.drawAbovePlayer(r2d);
+                secs += (double)(SDL_GetPerformanceCounter() - t0) / freq;
+
+                cmds += r2d.commands().size();
+                hash = (hash ^ r2d.frameHash()) * 1099511628211ull;
+            }
+
+            std::printf("bench render: map=%s frames=%d cmds/frame=%.1f cpu=%.2f us/frame hash=%016llx\n",
+                path.c_str(), frames, (double)cmds / frames, secs * 1e6 / frames, (unsigned long long)hash);
+
+            if (expect) {
+                const unsigned long long want = std::strtoull(expect, nullptr, 16);
+                if (want != (unsigned long long)hash) {
+                    std::fprintf(stderr, "bench render: hash MISMATCH (expected %016llx)\n", want);
+                    return 1;
+                }
+            }
+            return 0;
+        }
+
+        // Deterministik xorshift (bench'ler arasi tekrarlanabilir)
+        struct Rng {
+            uint32_t s = 0x9E3779B9u;
+            uint32_t next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+            float    unit() { return (next() & 0xFFFFFF) / 16777216.f; }
+        };
+
+        // erlik --bench physics [bodies] [frames] [map.tmj] [--threads N] [--strict]
+        // Haritanin bos hucrelerine govde serpistirir, basit AI girdisiyle 60 Hz adimlar.
+        // Once tek thread, sonra JobPool ile; kare basina ms ve 16.6 ms butcesini raporlar.
+        int benchPhysics(int argc, char** argv) {
+            int bodies = 10000, frames = 600, threads = -1;
+            std::string path = "assets/level_city.tmj";
+            bool strict = false;
+            int pos = 0;
+            for (int i = 0; i < argc; ++i) {
+                if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) { threads = std::atoi(argv[++i]); continue; }
+                if (std::strcmp(argv[i], "--strict") == 0) { strict = true; continue; }
+                if (pos == 0) bodies = std::max(1, std::atoi(argv[i]));
+                else if (pos == 1) frames = std::max(1, std::atoi(argv[i]));
+                else if (pos == 2) path = argv[i];
+                pos++;
+            }
+
+            HeadlessSDL sdl;
+            if (!sdl.init()) return 2;
+            TMJMap tmj;
+            Tilemap map;
+            if (!tmj.load(sdl.r, path) || !tmj.buildCollision(map, "collision", "oneway")) {
+                std::fprintf(stderr, "bench: collision load failed: %s\n", path.c_str());
+                return 2;
+            }
+
+            // Govdeler sadece bos hucrelere: liste bir kez, dolu haritada sonsuz dongu yok
+            std::vector<std::pair<int, int>> empty;
+            for (int ty = 0; ty < map.rows(); ++ty)
+                for (int tx = 0; tx < map.cols(); ++tx)
+                    if (map.get(tx, ty) < 0) empty.emplace_back(tx, ty);
+            if (empty.empty()) {
+                std::fprintf(stderr, "bench physics: map has no empty cell to spawn bodies: %s\n", path.c_str());
+                return 2;
+            }
+
+            PhysicsParams pp;
+            const float tile = (float)map.tileSize();
+            const double freq = (double)SDL_GetPerformanceFrequency();
+            const float dt = 1.f / 60.f;
+
+            auto runOnce = [&](JobPool* pool, double& msPerFrame) -> uint64_t {
+                PhysicsWorld world;
+                Rng rng;
+                std::vector<int> ids;
+                ids.reserve(bodies);
+                while ((int)ids.size() < bodies) {
+                    const auto [tx, ty] = empty[rng.next() % (uint32_t)empty.size()];
+                    ids.push_back(world.addBody((tx + 0.5f) * tile, (ty + 0.5f) * tile, 12.f, 16.f));
+                }
+
+                double secs = 0.0;
+                for (int f = 0; f < frames; ++f) {
+                    // AI: ~2 sn'de bir yon degistir, arada zipla (girdi uretimi olcume dahil degil)
+                    for (size_t k = 0; k < ids.size(); ++k) {
+                        const bool right = (((uint32_t)f / 120u + (uint32_t)k) & 1u) != 0;
+                        uint8_t in = right ? IN_RIGHT : IN_LEFT;
+                        if ((rng.next() & 63u) == 0) in |= IN_JUMP_PRESSED | IN_JUMP_HELD;
+                        world.setInput(ids[k], in);
+                    }
+                    const Uint64 t0 = SDL_GetPerformanceCounter();
+                    world.step(map, pp, dt, pool);
+                    secs += (double)(SDL_GetPerformanceCounter() - t0) / freq;
+                }
+                msPerFrame = secs * 1000.0 / frames;
+
+                // Sonuc ozeti: paralel ve tek thread ayni sonucu vermeli
+                uint64_t h = 1469598103934665603ull;
+                for (int id : ids) {
+                    const float v[2] = { world.x(id), world.y(id) };
+                    const unsigned char* b = reinterpret_cast<const unsigned char*>(v);
+                    for (size_t i = 0; i < sizeof(v); ++i) { h ^= b[i]; h *= 1099511628211ull; }
+                }
+                return h;
+            };
+
+            double msSingle = 0.0, msPool = 0.0;
+            const uint64_t hSingle = runOnce(nullptr, msSingle);
+            JobPool pool(threads);
+            const uint64_t hPool = runOnce(&pool, msPool);
+
+            const double budget = 1000.0 / 60.0;
+            std::printf("bench physics: bodies=%d frames=%d single=%.3f ms/frame pool(%d+1)=%.3f ms/frame (%.2fx) %s\n",
+                bodies, frames, msSingle, pool.workerCount(), msPool,
+                msPool > 0.0 ? msSingle / msPool : 0.0, msPool <= budget ? "OK (<16.6ms)" : "OVER BUDGET");
+            if (hSingle != hPool) {
+                std::fprintf(stderr, "bench physics: parallel result differs from single-thread!\n");
+                return 1;
+            }
+            return (strict && msPool > budget) ? 1 : 0;
+        }
+
+        // erlik --bench broadphase [bodies] [frames]
+        // Kutular genis bir alanda yavas hareket eder (temporal coherence); update() suresi,
+        // ortalama cift ve insertion-sort hareketi raporlanir. Ilk kare O(n^2) ile dogrulanir.
+        int benchBroadphase(int argc, char** argv) {
+            int bodies = 5000, frames = 600;
+            if (argc > 0) bodies = std::max(2, std::atoi(argv[0]));
+            if (argc > 1) frames = std::max(1, std::atoi(argv[1]));
+
+            const float W = 6400.f, H = 1600.f;
+            Rng rng;
+            std::vector<float> x(bodies), y(bodies), vx(bodies), vy(bodies), hw(bodies), hh(bodies);
+            for (int i = 0; i < bodies; ++i) {
+                x[i] = rng.unit() * W;  y[i] = rng.unit() * H;
+                vx[i] = (rng.unit() - 0.5f) * 240.f; vy[i] = (rng.unit() - 0.5f) * 240.f;
+                hw[i] = 6.f + rng.unit() * 10.f; hh[i] = 8.f + rng.unit() * 10.f;
+            }
+
+            Broadphase bp;
+            const double freq = (double)SDL_GetPerformanceFrequency();
+            double secs = 0.0;
+            size_t pairs = 0, events = 0, swaps = 0;
+            const float dt = 1.f / 60.f;
+
+            for (int f = 0; f < frames; ++f) {
+                for (int i = 0; i < bodies; ++i) {
+                    x[i] += vx[i] * dt; y[i] += vy[i] * dt;
+                    if (x[i] < 0.f || x[i] > W) vx[i] = -vx[i];
+                    if (y[i] < 0.f || y[i] > H) vy[i] = -vy[i];
+                }
+                const Uint64 t0 = SDL_GetPerformanceCounter();
+                for (int i = 0; i < bodies; ++i)
+                    bp.set(i, x[i] - hw[i], y[i] - hh[i], x[i] + hw[i], y[i] + hh[i]);
+                bp.update();
+                secs += (double)(SDL_GetPerformanceCounter() - t0) / freq;
+
+                pairs += bp.pairs().size();
+                events += bp.entered().size() + bp.exited().size();
+                if (f > 0) swaps += bp.lastSwaps();   // ilk kare tam siralama
+
+                if (f == 0 && bodies <= 20000) {
+                    size_t brute = 0;
+                    for (int i = 0; i < bodies; ++i)
+                        for (int j = i + 1; j < bodies; ++j)
+                            if (x[i] - hw[i] <= x[j] + hw[j] && x[j] - hw[j] <= x[i] + hw[i] &&
+                                y[i] - hh[i] <= y[j] + hh[j] && y[j] - hh[j] <= y[i] + hh[i]) ++brute;
+                    if (brute != bp.pairs().size()) {
+                        std::fprintf(stderr, "bench broadphase: pair MISMATCH (sap=%zu brute=%zu)\n", bp.pairs().size(), brute);
+                        return 1;
+                    }
+                }
+            }
+
+            // Ayni karede remove + ayni id ile set (PhysicsWorld m_freeIds'i hemen geri verir):
+            // eski cift exit, yeni govdenin cifti enter olmali
+            if (!bp.pairs().empty()) {
+                const BodyPair pr = bp.pairs()[0];
+                const int i = pr.a;
+                bp.remove(i);
+                bp.set(i, x[i] - hw[i], y[i] - hh[i], x[i] + hw[i], y[i] + hh[i]);
+                bp.update();
+                auto has = [&](const std::vector<BodyPair>& v) {
+                    return std::any_of(v.begin(), v.end(), [&](const BodyPair& q) { return q.a == pr.a && q.b == pr.b; });
+                };
+                if (!has(bp.exited()) || !has(bp.entered())) {
+                    std::fprintf(stderr, "bench broadphase: reused id %d kept pair (%d,%d) without exit/enter\n", i, pr.a, pr.b);
+                    return 1;
+                }
+            }
+
+            std::printf("bench broadphase: bodies=%d frames=%d update=%.3f ms/frame pairs=%.1f events=%.1f swaps=%.1f /frame\n",
+                bodies, frames, secs * 1000.0 / frames, (double)pairs / frames, (double)events / frames,
+                frames > 1 ? (double)swaps / (frames - 1) : 0.0);
+            return 0;
+        }
+
+        // erlik --bench rays [rays] [map.tmj]
+        // Bos hucrelerden rastgele yonlu isinlar (maxDist 1000 px): raycast ve ayni sayida
+        // boxcast (24x32 kutu, 200 px); isin/sn raporlanir.
+        int benchRays(int argc, char** argv) {
+            int count = 200000;
+            std::string path = "assets/level_city.tmj";
+            if (argc > 0) count = std::max(1, std::atoi(argv[0]));
+            if (argc > 1) path = argv[1];
+
+            HeadlessSDL sdl;
+            if (!sdl.init()) return 2;
+            TMJMap tmj;
+            Tilemap map;
+            if (!tmj.load(sdl.r, path) || !tmj.buildCollision(map, "collision", "oneway")) {
+                std::fprintf(stderr, "bench: collision load failed: %s\n", path.c_str());
+                return 2;
+            }
+
+            const float tile = (float)map.tileSize();
+            Rng rng;
+            std::vector<Tilemap::Ray> rays;
+            rays.reserve(count);
+            while ((int)rays.size() < count) {
+                const int tx = (int)(rng.next() % (uint32_t)map.cols());
+                const int ty = (int)(rng.next() % (uint32_t)map.rows());
+                if (map.get(tx, ty) >= 0) continue;
+                const float a = rng.unit() * 6.2831853f;
+                rays.push_back(Tilemap::Ray{ (tx + rng.unit()) * tile, (ty + rng.unit()) * tile,
+                    std::cos(a), std::sin(a), 1000.f });
+            }
+
+            const double freq = (double)SDL_GetPerformanceFrequency();
+            std::vector<Tilemap::RayHit> single(count);
+
+            Uint64 t0 = SDL_GetPerformanceCounter();
+            for (int i = 0; i < count; ++i) {
+                const Tilemap::Ray& r = rays[i];
+                map.raycast(r.x, r.y, r.dx, r.dy, r.maxDist, Tilemap::MASK_ANY, single[i]);
+            }
+            const double sSingle = (double)(SDL_GetPerformanceCounter() - t0) / freq;
+
+            int hits = 0;
+            for (int i = 0; i < count; ++i) hits += single[i].hit ? 1 : 0;
+
+            int boxHits = 0;
+            t0 = SDL_GetPerformanceCounter();
+            for (int i = 0; i < count; ++i) {
+                const Tilemap::Ray& r = rays[i];
+                Tilemap::RayHit h;
+                boxHits += map.boxcast(r.x, r.y, 12.f, 16.f, r.dx * 200.f, r.dy * 200.f, Tilemap::MASK_ANY, h) ? 1 : 0;
+            }
+            const double sBox = (double)(SDL_GetPerformanceCounter() - t0) / freq;
+
+            std::printf("bench rays: map=%s rays=%d hit=%.1f%% raycast=%.2f Mrays/s boxcast=%.2f M/s (hit %.1f%%)\n",
+                path.c_str(), count, 100.0 * hits / count,
+                count / sSingle * 1e-6, count / sBox * 1e-6, 100.0 * boxHits / count);
+            return 0;
+        }
+
+        // erlik --bench nav [queries] [map.tmj]
+        // Graf kurulum suresi, rastgele yuzey ciftleri arasi toplu yol sorgusu (findPaths) ve
+        // tek hucre edit'i sonrasi patch vs tam yeniden kurulum karsilastirilir.
+        int benchNav(int argc, char** argv) {
+            int count = 20000;
+            std::string path = "assets/level_city.tmj";
+            if (argc > 0) count = std::max(1, std::atoi(argv[0]));
+            if (argc > 1) path = argv[1];
+
+            HeadlessSDL sdl;
+            if (!sdl.init()) return 2;
+            TMJMap tmj;
+            Tilemap map;
+            if (!tmj.load(sdl.r, path) || !tmj.buildCollision(map, "collision", "oneway")) {
+                std::fprintf(stderr, "bench: collision load failed: %s\n", path.c_str());
+                return 2;
+            }
+
+            const double freq = (double)SDL_GetPerformanceFrequency();
+            const PhysicsParams pp;
+            NavGraph nav;
+            Uint64 t0 = SDL_GetPerformanceCounter();
+            nav.build(map, pp);
+            const double sBuild = (double)(SDL_GetPerformanceCounter() - t0) / freq;
+            if (nav.surfaceCount() == 0) { std::fprintf(stderr, "bench nav: no walkable surfaces\n"); return 1; }
+
+            std::vector<int> alive;
+            for (int s = 0; s < nav.surfaceSlots(); ++s) if (nav.surface(s).alive) alive.push_back(s);
+            const float tile = (float)map.tileSize();
+            Rng rng;
+            auto randomFoot = [&](float& x, float& y) {
+                const NavSurface& S = nav.surface(alive[rng.next() % (uint32_t)alive.size()]);
+                x = (S.tx0 + (int)(rng.next() % (uint32_t)(S.tx1 - S.tx0 + 1)) + 0.5f) * tile;
+                y = (S.row + 1) * tile;
+            };
+            std::vector<NavGraph::Query> q(count);
+            for (NavGraph::Query& e : q) { randomFoot(e.fromX, e.fromY); randomFoot(e.toX, e.toY); }
+            std::vector<std::vector<NavStep>> paths(count);
+
+            t0 = SDL_GetPerformanceCounter();
+            const int found = nav.findPaths(q.data(), count, paths.data());
+            const double sQuery = (double)(SDL_GetPerformanceCounter() - t0) / freq;
+            size_t steps = 0;
+            for (const auto& p : paths) steps += p.size();
+
+            // Bir yuzeyin altindaki zemini kir: patch vs build
+            double sPatch = 0.0, sRebuild = 0.0;
+            for (int s : alive) {
+                const NavSurface& S = nav.surface(s);
+                const int tx = (S.tx0 + S.tx1) / 2, ty = S.row + 1;
+                if (!map.solidAtTile(tx, ty)) continue;
+                map.setCell(tx, ty, -1);
+                t0 = SDL_GetPerformanceCounter();
+                nav.patch(map, tx, ty, tx, ty);
+                sPatch = (double)(SDL_GetPerformanceCounter() - t0) / freq;
+                NavGraph ref;
+                t0 = SDL_GetPerformanceCounter();
+                ref.build(map, pp);
+                sRebuild = (double)(SDL_GetPerformanceCounter() - t0) / freq;
+                if (ref.surfaceCount() != nav.surfaceCount() || ref.edgeCount() != nav.edgeCount()) {
+                    std::fprintf(stderr, "bench nav: patch MISMATCH (surfaces %d/%d edges %d/%d)\n",
+                        nav.surfaceCount(), ref.surfaceCount(), nav.edgeCount(), ref.edgeCount());
+                    return 1;
+                }
+                break;
+            }
+
+            std::printf("bench nav: map=%s surfaces=%d edges=%d build=%.1f ms queries=%d found=%.1f%% "
+                "%.2f us/query steps=%.1f patch=%.2f ms (rebuild %.1f ms)\n",
+                path.c_str(), nav.surfaceCount(), nav.edgeCount(), sBuild * 1000.0, count,
+                100.0 * found / count, sQuery * 1e6 / count, found ? (double)steps / found : 0.0,
+                sPatch * 1000.0, sRebuild * 1000.0);
+            return 0;
+        }
+
+        // erlik --bench particles [count] [frames] [map.tmj]
+        // Bos hucrelerden patlayan toz (Bounce/Slide/Die karisik); emisyon ~0.4 sn omurle havuzu
+        // dolu tutar. Ayni tohumla carpismasiz ve carpismali update() suresi karsilastirilir.
+        int benchParticles(int argc, char** argv) {
+            int count = 50000, frames = 600;
+            std::string path = "assets/level_city.tmj";
+            if (argc > 0) count = std::max(1, std::atoi(argv[0]));
+            if (argc > 1) frames = std::max(1, std::atoi(argv[1]));
+            if (argc > 2) path = argv[2];
+
+            HeadlessSDL sdl;
+            if (!sdl.init()) return 2;
+            TMJMap tmj;
+            Tilemap map;
+            if (!tmj.load(sdl.r, path) || !tmj.buildCollision(map, "collision", "oneway")) {
+                std::fprintf(stderr, "bench: collision load failed: %s\n", path.c_str());
+                return 2;
+            }
+
+            const double freq = (double)SDL_GetPerformanceFrequency();
+            const float tile = (float)map.tileSize();
+            const float dt = 1.f / 60.f;
+            auto run = [&](bool collide, int& alive) {
+                std::srand(7);
+                Rng rng;
+                ParticleSystem ps;
+                ps.init(count);
+                ps.setCollision(collide ? &map : nullptr);
+                double secs = 0.0;
+                for (int f = 0; f < frames; ++f) {
+                    for (int e = 0; e < std::max(1, count / (24 * 16)); ++e) {
+                        const int tx = (int)(rng.next() % (uint32_t)map.cols());
+                        const int ty = (int)(rng.next() % (uint32_t)map.rows());
+                        if (map.get(tx, ty) >= 0) continue;
+                        const ParticleHit hit = (ParticleHit)(1 + rng.next() % 3);
+                        ps.emitDust((tx + 0.5f) * tile, (ty + 0.5f) * tile, 16, (e & 1) ? 1.f : -1.f, 160.f, 0.f, hit);
+                    }
+                    const Uint64 t0 = SDL_GetPerformanceCounter();
+                    ps.update(dt);
+                    secs += (double)(SDL_GetPerformanceCounter() - t0) / freq;
+                }
+                alive = ps.aliveCount();
+                return secs;
+            };
+
+            int aliveOff = 0, aliveOn = 0;
+            const double sOff = run(false, aliveOff);
+            const double sOn = run(true, aliveOn);
+            std::printf("bench particles: map=%s cap=%d frames=%d update=%.3f ms/frame (no collision %.3f) alive=%d/%d\n",
+                path.c_str(), count, frames, sOn * 1000.0 / frames, sOff * 1000.0 / frames, aliveOn, aliveOff);
+            return 0;
+        }
+
+        // Surecin tepe bellek kullanimi (KB). Monoton: olcum oncesi/sonrasi farki tepe maliyettir.
+        long peakRssKB() {
+#ifdef _WIN32
+            PROCESS_MEMORY_COUNTERS pmc{};
+            return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? (long)(pmc.PeakWorkingSetSize / 1024) : 0;
+#else
+            rusage u{};
+            getrusage(RUSAGE_SELF, &u);
+#ifdef __APPLE__
+            return (long)(u.ru_maxrss / 1024); // macOS: bayt
+#else
+            return (long)u.ru_maxrss;
+#endif
+#endif
+        }
+
+        // Sentetik buyuk harita: her satir `scale` kez yan yana; obje katmanlari kaydirilip kopyalanir
+        // (isim/target sonek alir, door eslesmeleri kopya icinde kalir). Kaynakla ayni klasore yazilir
+        // ki goreli tileset yolu cozulsun. encode != nullptr: layer verisi base64 (+sikistirma).
+        bool writeScaledMap(const std::string& src, int scale, const LayerCompression* encode, const std::string& out) {
+            std::ifstream in(src);
+            if (!in) return false;
+            nlohmann::json j = nlohmann::json::parse(in, nullptr, false);
+            if (j.is_discarded() || !j["layers"].is_array()) return false;
+            const int W = j.value("width", 0);
+            const double tw = j.value("tilewidth", 32.0);
+            for (auto& L : j["layers"]) {
+                const std::string type = L.value("type", "");
+                if (type == "tilelayer" && L["data"].is_array()) {
+                    const auto& d = L["data"];
+                    const int w = L.value("width", W), h = L.value("height", 0);
+                    if ((size_t)w * h != d.size()) return false;
+                    nlohmann::json nd = nlohmann::json::array();
+                    for (int y = 0; y < h; ++y)
+                        for (int k = 0; k < scale; ++k)
+                            for (int x = 0; x < w; ++x) nd.push_back(d[(size_t)y * w + x]);
+                    L["width"] = w * scale;
+                    if (encode) {
+                        const std::vector<uint32_t> gids = nd.get<std::vector<uint32_t>>();
+                        std::string b64;
+                        if (!encodeLayerData(gids.data(), gids.size(), *encode, b64)) return false;
+                        L["data"] = std::move(b64);
+                        L["encoding"] = "base64";
+                        L["compression"] = layerCompressionName(*encode);
+                    }
+                    else L["data"] = std::move(nd);
+                }
+                else if (type == "objectgroup" && L["objects"].is_array()) {
+                    nlohmann::json objs = nlohmann::json::array();
+                    for (int k = 0; k < scale; ++k)
+                        for (nlohmann::json o : L["objects"]) {
+                            o["x"] = o.value("x", 0.0) + k * W * tw;
+                            o["id"] = o.value("id", 0) + k * 100000;
+                            if (k > 0) {
+                                const std::string suffix = "_" + std::to_string(k);
+                                o["name"] = o.value("name", "") + suffix;
+                                if (o.contains("properties"))
+                                    for (auto& p : o["properties"])
+                                        if (p.value("name", "") == "target" && p["value"].is_string())
+                                            p["value"] = p["value"].get<std::string>() + suffix;
+                            }
+                            objs.push_back(std::move(o));
+                        }
+                    L["objects"] = std::move(objs);
+                }
+            }
+            j["width"] = W * scale;
+            std::ofstream f(out);
+            f << j.dump(1);
+            return (bool)f;
+        }
+
+        // erlik --bench tmj [map.tmj] [runs] [--dom] [--gen N [--encode base64|zlib|gzip|zstd]]
+        // TMJ parse suresi (onbellek ve GPU yok) ve tepe bellek. --dom: karsilastirma icin sadece
+        // nlohmann DOM kurulur (eski DOM yolunun alt siniri). Tepe RSS surec boyunca monoton
+        // oldugundan modlari ayri calistir. --gen N: <map>_xN[_enc].tmj sentetik haritasini yazar ve cikar.
+        int benchTmj(int argc, char** argv) {
+            std::string path = "assets/level_city.tmj";
+            int runs = 10, gen = 0;
+            bool dom = false;
+            const char* encode = nullptr;
+            int pos = 0;
+            for (int i = 0; i < argc; ++i) {
+                if (std::strcmp(argv[i], "--dom") == 0) { dom = true; continue; }
+                if (std::strcmp(argv[i], "--gen") == 0 && i + 1 < argc) { gen = std::atoi(argv[++i]); continue; }
+                if (std::strcmp(argv[i], "--encode") == 0 && i + 1 < argc) { encode = argv[++i]; continue; }
+                if (pos == 0) path = argv[i];
+                else if (pos == 1) runs = std::max(1, std::atoi(argv[i]));
+                pos++;
+            }
+
+            if (gen > 0) {
+                LayerCompression comp = LayerCompression::None;
+                if (encode && std::strcmp(encode, "base64") != 0 &&
+                    (!parseLayerCompression(encode, comp) || !layerCompressionSupported(comp))) {
+                    std::fprintf(stderr, "bench tmj: unsupported encoding '%s'\n", encode);
+                    return 2;
+                }
+                const std::string stem = path.size() > 4 && path.compare(path.size() - 4, 4, ".tmj") == 0
+                    ? path.substr(0, path.size() - 4) : path;
+                const std::string out = stem + "_x" + std::to_string(gen) + (encode ? std::string("_") + encode : "") + ".tmj";
+                if (!writeScaledMap(path, gen, encode ? &comp : nullptr, out)) { std::fprintf(stderr, "bench tmj: cannot scale %s\n", path.c_str()); return 2; }
+                std::printf("bench tmj: wrote %s\n", out.c_str());
+                return 0;
+            }
+
+            std::ifstream probe(path, std::ios::binary | std::ios::ate);
+            if (!probe) { std::fprintf(stderr, "bench tmj: not found: %s\n", path.c_str()); return 2; }
+            const double fileKB = (double)probe.tellg() / 1024.0;
+            probe.close();
+
+            const double freq = (double)SDL_GetPerformanceFrequency();
+            const long rss0 = peakRssKB();
+            double best = 1e30, total = 0.0;
+            int cols = 0, rows = 0, layers = 0;
+            for (int i = 0; i < runs; ++i) {
+                bool ok = false;
+                TMJMap map;             // yikici olcume girmesin
+                nlohmann::json j;
+                const Uint64 t0 = SDL_GetPerformanceCounter();
+                if (dom) {
+                    std::ifstream in(path);
+                    j = nlohmann::json::parse(in, nullptr, false);
+                    ok = !j.is_discarded();
+                }
+                else ok = map.parse(path);
+                const double s = (double)(SDL_GetPerformanceCounter() - t0) / freq;
+                if (!ok) { std::fprintf(stderr, "bench tmj: parse failed: %s\n", path.c_str()); return 2; }
+                best = std::min(best, s); total += s;
+                if (i == 0) {
+                    cols = dom ? j.value("width", 0) : map.cols();
+                    rows = dom ? j.value("height", 0) : map.rows();
+                    if (!dom) layers = map.layerCount();
+                    else for (const auto& L : j["layers"]) layers += L.value("type", "") == "tilelayer";
+                    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_WARN); // ilk turdan sonra sessiz
+                }
+            }
+            const long rss1 = peakRssKB();
+            std::printf("bench tmj: map=%s (%.0f KB, %dx%d, %d layers) parser=%s runs=%d best=%.2f ms avg=%.2f ms peak rss +%ld KB\n",
+                path.c_str(), fileKB, cols, rows, layers, dom ? "dom" : "sax", runs, best * 1000.0,
+                total * 1000.0 / runs, rss1 - rss0);
+            return 0;
+        }
+
+    } // namespace
+
+    int runBench(int argc, char** argv) {
+        if (argc < 1) {
+            std::fprintf(stderr, "usage: erlik --bench <render|physics|broadphase|rays|nav|particles|tmj> [args...]\n");
+            return 2;
+        }
+        const std::string name = argv[0];
+        if (name == "render")  return benchRender(argc - 1, argv + 1);
+        if (name == "physics") return benchPhysics(argc - 1, argv + 1);
+        if (name == "broadphase") return benchBroadphase(argc - 1, argv + 1);
+        if (name == "rays")    return benchRays(argc - 1, argv + 1);
+        if (name == "nav")     return benchNav(argc - 1, argv + 1);
+        if (name == "particles") return benchParticles(argc - 1, argv + 1);
+        if (name == "tmj")     return benchTmj(argc - 1, argv + 1);
+        std::fprintf(stderr, "bench: unknown benchmark '%s'\n", name.c_str());
+        return 2;
+    }
+
+} // namespace Erlik
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Erlik {
+
+    // Headless benchmark'lar: `erlik --bench <name> [args...]`
+    // Pencere acmaz; SDL sadece asset yuklemek icin (software renderer) kullanilir.
+    // Donus: process exit code (0 = ok).
+    int runBench(int argc, char** argv);
+
+} // namespace Erlik
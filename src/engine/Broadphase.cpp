@@ -0,0 +1,126 @@
+#include "Broadphase.h"
+#include <algorithm>
+
+namespace Erlik {
+
+    static inline uint64_t packPair(int a, int b) {
+        if (a > b) std::swap(a, b);
+        return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+    }
+    static inline BodyPair unpackPair(uint64_t k) {
+        return BodyPair{ (int)(uint32_t)(k >> 32), (int)(uint32_t)k };
+    }
+
+    void Broadphase::set(int id, float minX, float minY, float maxX, float maxY)
+    {
+        if (id < 0) return;
+        if (id >= (int)m_box.size()) {
+            m_box.resize(id + 1);
+            m_state.resize(id + 1, 0);
+            m_touch.resize(id + 1, 0);
+            m_reborn.resize(id + 1, 0);
+        }
+        m_box[id] = Box{ minX, minY, maxX, maxY };
+        if (m_state[id] == 0) m_added.push_back(id);
+        else if (m_state[id] == 2 && !m_reborn[id]) { m_reborn[id] = 1; m_rebornIds.push_back(id); }
+        m_state[id] = 1;
+    }
+
+    void Broadphase::remove(int id)
+    {
+        if (id < 0 || id >= (int)m_state.size() || m_state[id] != 1) return;
+        m_state[id] = 2;   // update'te siralamadan cikar
+        m_dirtyRemove = true;
+    }
+
+    void Broadphase::clear()
+    {
+        m_box.clear(); m_state.clear(); m_order.clear(); m_keys.clear();
+        m_added.clear(); m_touch.clear();
+        m_reborn.clear(); m_rebornIds.clear();
+        m_cur.clear(); m_prev.clear();
+        m_pairs.clear(); m_entered.clear(); m_exited.clear();
+        m_dirtyRemove = false;
+        m_swaps = 0;
+    }
+
+    void Broadphase::update()
+    {
+        // 1) Silinenleri at, yenileri sona ekle (sort yerlerine tasir)
+        if (m_dirtyRemove) {
+            size_t w = 0;
+            for (size_t r = 0; r < m_order.size(); ++r) {
+                const int id = m_order[r];
+                if (m_state[id] == 2) { m_state[id] = 0; continue; }
+                m_order[w++] = id;
+            }
+            m_order.resize(w);
+            m_dirtyRemove = false;
+        }
+        for (int id : m_added) {
+            if (m_state[id] == 1) m_order.push_back(id);
+            else if (m_state[id] == 2) m_state[id] = 0;   // eklendigi karede silindi
+        }
+        m_added.clear();
+
+        // 2) Insertion sort (temporal coherence: neredeyse sirali)
+        const size_t n = m_order.size();
+        m_keys.resize(n);
+        for (size_t i = 0; i < n; ++i) m_keys[i] = m_box[m_order[i]].minX;
+        m_swaps = 0;
+        for (size_t i = 1; i < n; ++i) {
+            const float k = m_keys[i];
+            const int   id = m_order[i];
+            size_t j = i;
+            while (j > 0 && m_keys[j - 1] > k) {
+                m_keys[j] = m_keys[j - 1];
+                m_order[j] = m_order[j - 1];
+                --j;
+            }
+            m_keys[j] = k; m_order[j] = id;
+            m_swaps += (int)(i - j);
+        }
+
+        // 3) Sweep: X araligi acik olanlar arasinda Y testi
+        m_prev.swap(m_cur);
+        m_cur.clear();
+        for (size_t i = 0; i < n; ++i) {
+            const Box& a = m_box[m_order[i]];
+            for (size_t j = i + 1; j < n && m_keys[j] <= a.maxX; ++j) {
+                const Box& b = m_box[m_order[j]];
+                if (a.minY <= b.maxY && b.minY <= a.maxY)
+                    m_cur.push_back(packPair(m_order[i], m_order[j]));
+            }
+        }
+        std::sort(m_cur.begin(), m_cur.end());
+
+        // 4) Onceki kareyle fark: enter / exit (iki sirali listede birlesik yuruyus)
+        m_pairs.clear(); m_entered.clear(); m_exited.clear();
+        std::fill(m_touch.begin(), m_touch.end(), 0);
+        size_t p = 0, c = 0;
+        while (p < m_prev.size() || c < m_cur.size()) {
+            if (c < m_cur.size() && (p >= m_prev.size() || m_cur[c] < m_prev[p])) {
+                m_entered.push_back(unpackPair(m_cur[c]));
+                ++c;
+            }
+            else if (p < m_prev.size() && (c >= m_cur.size() || m_prev[p] < m_cur[c])) {
+                m_exited.push_back(unpackPair(m_prev[p]));
+                ++p;
+            }
+            else {
+                // id yeniden kullanildi: onceki cift baska govdeye aitti
+                const BodyPair bp = unpackPair(m_cur[c]);
+                if (m_reborn[bp.a] || m_reborn[bp.b]) { m_exited.push_back(bp); m_entered.push_back(bp); }
+                ++p; ++c;
+            }
+        }
+        for (int id : m_rebornIds) m_reborn[id] = 0;
+        m_rebornIds.clear();
+        for (uint64_t k : m_cur) {
+            const BodyPair bp = unpackPair(k);
+            m_pairs.push_back(bp);
+            m_touch[bp.a] = 1; m_touch[bp.b] = 1;
+        }
+    }
+
+} // namespace Erlik
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace Erlik {
+
+    struct BodyPair { int a, b; };   // a < b (govde id'leri)
+
+    // Sort-and-sweep broadphase (X ekseni). Proxy'ler minX'e gore sirali tutulur ve her kare
+    // insertion sort ile yeniden siralanir: hareket kucukse dizi neredeyse sirali oldugundan
+    // maliyet ~O(n + yer degistirme). Sweep, X'te cakisanlari Y ile eler; onceki karenin cift
+    // listesiyle farki alinarak enter/exit olaylari uretilir.
+    class Broadphase {
+    public:
+        // Ekle ya da guncelle (id >= 0). Ayni karede remove edilip tekrar set edilen id yeni
+        // govde sayilir: eski ciftleri update'te exit, hala cakisanlar enter olarak gelir.
+        void set(int id, float minX, float minY, float maxX, float maxY);
+        void remove(int id);     // aktif ciftleri bir sonraki update'te exit olur
+        void clear();
+
+        void update();
+
+        const std::vector<BodyPair>& pairs() const { return m_pairs; }     // su an cakisan
+        const std::vector<BodyPair>& entered() const { return m_entered; } // bu karede basladi
+        const std::vector<BodyPair>& exited() const { return m_exited; }   // bu karede bitti
+        bool overlapping(int id) const { return id >= 0 && id < (int)m_touch.size() && m_touch[id] != 0; }
+
+        int proxyCount() const { return (int)m_order.size(); }
+        int lastSwaps() const { return m_swaps; }   // insertion sort hareketi (tutarlilik gostergesi)
+
+    private:
+        struct Box { float minX, minY, maxX, maxY; };
+
+        std::vector<Box>      m_box;     // id ile indekslenir
+        std::vector<uint8_t>  m_state;   // 0 = yok, 1 = canli, 2 = siralamada ama silindi
+        std::vector<int>      m_order;   // minX'e gore sirali id'ler
+        std::vector<float>    m_keys;    // m_order ile paralel minX (sort icin cache dostu)
+        std::vector<int>      m_added;   // siralamaya henuz girmemis id'ler
+        std::vector<uint8_t>  m_touch;   // id -> bu kare herhangi bir ciftte mi
+        std::vector<uint8_t>  m_reborn;  // id -> bu kare silinip yeniden eklendi (m_rebornIds)
+        std::vector<int>      m_rebornIds;
+        bool                  m_dirtyRemove = false;
+
+        std::vector<uint64_t> m_cur, m_prev;  // paketlenmis ciftler (a<<32 | b), sirali
+        std::vector<BodyPair> m_pairs, m_entered, m_exited;
+        int                   m_swaps = 0;
+    };
+
+} // namespace Erlik
@@ -0,0 +1,150 @@
+#include "Decals.h"
+#include "Renderer2D.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Erlik {
+
+    bool DecalLayer::init(SDL_Renderer* r, int worldW, int worldH, int chunkPx, size_t budgetBytes)
+    {
+        shutdown();
+        if (!r || worldW <= 0 || worldH <= 0 || chunkPx <= 0) return false;
+        m_r = r;
+        m_chunkPx = chunkPx;
+        m_cols = (worldW + chunkPx - 1) / chunkPx;
+        m_rows = (worldH + chunkPx - 1) / chunkPx;
+        m_maxChunks = std::max<size_t>(1, budgetBytes / chunkBytes());
+        m_cells.resize((size_t)m_cols * (size_t)m_rows);
+        SDL_Log("decals: %dx%d chunks of %dpx, budget %zu chunks", m_cols, m_rows, m_chunkPx, m_maxChunks);
+        return true;
+    }
+
+    void DecalLayer::shutdown()
+    {
+        m_cells.clear();
+        m_live.clear();
+        m_pending.clear();
+        m_cols = m_rows = 0;
+        m_evictions = 0;
+        m_r = nullptr;
+    }
+
+    void DecalLayer::clear()
+    {
+        for (int cell : m_live) m_cells[cell].tex.destroy();
+        m_live.clear();
+        m_pending.clear();
+    }
+
+    void DecalLayer::stamp(float x, float y, float w, float h, SDL_Color c)
+    {
+        if (!m_r || w <= 0.f || h <= 0.f || c.a == 0) return;
+        const float cp = (float)m_chunkPx;
+        int cx0 = std::max(0, (int)std::floor(x / cp));
+        int cy0 = std::max(0, (int)std::floor(y / cp));
+        int cx1 = std::min(m_cols - 1, (int)std::floor((x + w) / cp));
+        int cy1 = std::min(m_rows - 1, (int)std::floor((y + h) / cp));
+
+        // Chunk sinirini asan stamp her chunk'a kendi parcasi olarak yazilir
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const float ox = cx * cp, oy = cy * cp;
+                const float lx0 = std::max(x - ox, 0.f), ly0 = std::max(y - oy, 0.f);
+                const float lx1 = std::min(x + w - ox, cp), ly1 = std::min(y + h - oy, cp);
+                if (lx1 <= lx0 || ly1 <= ly0) continue;
+                m_pending.push_back(Pending{ cy * m_cols + cx, SDL_FRect{ lx0, ly0, lx1 - lx0, ly1 - ly0 }, c });
+            }
+        }
+    }
+
+    bool DecalLayer::allocate(int cell)
+    {
+        while (m_live.size() >= m_maxChunks) evictOldest();
+
+        Chunk& ch = m_cells[cell];
+        if (!ch.tex.createRenderTarget(m_r, m_chunkPx, m_chunkPx, SDL_PIXELFORMAT_RGBA8888))
+            return false;
+
+        // Bos (seffaf) baslat
+        SDL_SetRenderTarget(m_r, ch.tex.sdl());
+        SDL_SetRenderDrawBlendMode(m_r, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(m_r, 0, 0, 0, 0);
+        SDL_RenderClear(m_r);
+        m_live.push_back(cell);
+        return true;
+    }
+
+    void DecalLayer::evictOldest()
+    {
+        // Canli chunk sayisi butceyle sinirli (az sayida), lineer tarama yeterli
+        size_t best = 0;
+        for (size_t i = 1; i < m_live.size(); ++i)
+            if (m_cells[m_live[i]].lastUse < m_cells[m_live[best]].lastUse) best = i;
+        m_cells[m_live[best]].tex.destroy();
+        m_live[best] = m_live.back();
+        m_live.pop_back();
+        m_evictions++;
+    }
+
+    void DecalLayer::flush()
+    {
+        ++m_frame;
+        if (!m_r || m_pending.empty()) return;
+
+        // Ayni chunk'a giden stamp'ler art arda: chunk basina tek render target degisimi
+        std::stable_sort(m_pending.begin(), m_pending.end(),
+            [](const Pending& a, const Pending& b) { return a.cell < b.cell; });
+
+        SDL_Texture* prevTarget = SDL_GetRenderTarget(m_r);
+        SDL_BlendMode prevBlend;
+        SDL_GetRenderDrawBlendMode(m_r, &prevBlend);
+
+        size_t i = 0;
+        while (i < m_pending.size()) {
+            const int cell = m_pending[i].cell;
+            size_t j = i;
+            while (j < m_pending.size() && m_pending[j].cell == cell) ++j;
+
+            Chunk& ch = m_cells[cell];
+            ch.lastUse = m_frame;
+            if (ch.tex.sdl() || allocate(cell)) {
+                SDL_SetRenderTarget(m_r, ch.tex.sdl());
+                SDL_SetRenderDrawBlendMode(m_r, SDL_BLENDMODE_BLEND);
+                for (size_t k = i; k < j; ++k) {
+                    const Pending& p = m_pending[k];
+                    SDL_SetRenderDrawColor(m_r, p.c.r, p.c.g, p.c.b, p.c.a);
+                    SDL_RenderFillRectF(m_r, &p.local);
+                }
+            }
+            i = j;
+        }
+        m_pending.clear();
+
+        SDL_SetRenderTarget(m_r, prevTarget);
+        SDL_SetRenderDrawBlendMode(m_r, prevBlend);
+    }
+
+    void DecalLayer::draw(Renderer2D& r2d) const
+    {
+        if (m_live.empty()) return;
+        int vw, vh; r2d.outputSize(vw, vh);
+        const Camera2D& cam = r2d.camera();
+        const float cp = (float)m_chunkPx;
+
+        int cx0 = std::max(0, (int)std::floor(cam.x / cp));
+        int cy0 = std::max(0, (int)std::floor(cam.y / cp));
+        int cx1 = std::min(m_cols - 1, (int)std::floor((cam.x + vw / cam.zoom) / cp));
+        int cy1 = std::min(m_rows - 1, (int)std::floor((cam.y + vh / cam.zoom) / cp));
+
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const Chunk& ch = m_cells[(size_t)cy * m_cols + cx];
+                if (!ch.tex.sdl()) continue;
+                ch.lastUse = m_frame; // gorunen chunk'lar LRU'da taze kalir
+                r2d.drawTextureSDL(ch.tex.sdl(), nullptr, (cx + 0.5f) * cp, (cy + 0.5f) * cp,
+                    1.0f, 0.0f, SDL_FLIP_NONE);
+            }
+        }
+    }
+
+} // namespace Erlik
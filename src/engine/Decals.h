@@ -0,0 +1,64 @@
+#pragma once
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Texture.h"
+
+namespace Erlik {
+
+    class Renderer2D;
+
+    // Dunyaya hizali, chunk'lanmis kalici decal katmani (iz, is, toz).
+    // Stamp'ler kuyruga alinir ve flush()'ta chunk render target'larina "pisirilir";
+    // sonrasinda frame basina simulasyon maliyeti yok, sadece gorunen chunk blit'leri.
+    // Chunk'lar ilk stamp'te olusturulur; bellek butcesi asilinca en uzun sure
+    // kullanilmayan (LRU) chunk atilir.
+    class DecalLayer {
+    public:
+        // worldW/H: piksel, chunkPx: chunk kenari (px), budgetBytes: texture bellegi ust siniri
+        bool init(SDL_Renderer* r, int worldW, int worldH, int chunkPx = 256,
+            size_t budgetBytes = 16u * 1024u * 1024u);
+        void shutdown();
+        void clear();   // tum chunk'lari birak (butce sifirlanir)
+
+        // World-space dikdortgen; chunk sinirlarini asiyorsa parcalara bolunur
+        void stamp(float x, float y, float w, float h, SDL_Color c);
+        // Kuyruktaki stamp'leri chunk'lara yaz. Frame basinda, viewport disinda cagir
+        // (render target degisimi viewport/clip'i sifirlar).
+        void flush();
+        void draw(Renderer2D& r2d) const;
+
+        bool   ready() const { return m_r != nullptr; }
+        int    liveChunks() const { return (int)m_live.size(); }
+        size_t bytesUsed() const { return m_live.size() * chunkBytes(); }
+        int    evictions() const { return m_evictions; }
+
+    private:
+        struct Chunk {
+            Texture  tex;
+            mutable uint64_t lastUse = 0;   // LRU (flush/draw frame sayaci)
+        };
+        struct Pending {
+            int       cell;
+            SDL_FRect local;        // chunk-local px
+            SDL_Color c;
+        };
+
+        size_t chunkBytes() const { return (size_t)m_chunkPx * (size_t)m_chunkPx * 4u; }
+        bool   allocate(int cell);
+        void   evictOldest();
+
+        SDL_Renderer* m_r = nullptr;
+        int    m_chunkPx = 256;
+        int    m_cols = 0, m_rows = 0;  // chunk grid
+        size_t m_maxChunks = 0;
+
+        std::vector<Chunk>   m_cells;   // cols*rows, texture'lar tembel
+        std::vector<int>     m_live;    // texture'i olan hucreler
+        std::vector<Pending> m_pending;
+        uint64_t             m_frame = 1;
+        int    m_evictions = 0;
+    };
+
+} // namespace Erlik
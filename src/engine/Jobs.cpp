@@ -0,0 +1,75 @@
+#include "Jobs.h"
+#include <algorithm>
+
+namespace Erlik {
+
+    JobPool::JobPool(int threads)
+    {
+        if (threads < 0) threads = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+        m_threads.reserve(threads);
+        for (int i = 0; i < threads; ++i)
+            m_threads.emplace_back([this]() { workerLoop(); });
+    }
+
+    JobPool::~JobPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_quit = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads) t.join();
+    }
+
+    void JobPool::runChunks()
+    {
+        for (;;) {
+            const int b = m_next.fetch_add(m_grain, std::memory_order_relaxed);
+            if (b >= m_count) break;
+            (*m_fn)(b, std::min(b + m_grain, m_count));
+        }
+    }
+
+    void JobPool::workerLoop()
+    {
+        unsigned seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m_mx);
+                m_wake.wait(lk, [&]() { return m_quit || m_gen != seen; });
+                if (m_quit) return;
+                seen = m_gen;
+            }
+            runChunks();
+            {
+                std::lock_guard<std::mutex> lk(m_mx);
+                if (--m_pending == 0) m_done.notify_one();
+            }
+        }
+    }
+
+    void JobPool::parallelFor(int count, int grain, const std::function<void(int, int)>& fn)
+    {
+        if (count <= 0) return;
+        grain = std::max(1, grain);
+        if (m_threads.empty() || count <= grain) { fn(0, count); return; }
+
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_fn = &fn;
+            m_count = count;
+            m_grain = grain;
+            m_next.store(0, std::memory_order_relaxed);
+            m_pending = (int)m_threads.size();
+            ++m_gen;
+        }
+        m_wake.notify_all();
+
+        runChunks();   // cagiran thread de calisir
+
+        std::unique_lock<std::mutex> lk(m_mx);
+        m_done.wait(lk, [&]() { return m_pending == 0; });
+        m_fn = nullptr;
+    }
+
+} // namespace Erlik
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Erlik {
+
+    // Kucuk, sabit boyutlu worker havuzu. parallelFor cagiran thread'i de calistirir ve
+    // tum parcalar bitene kadar bloklar. Is yoksa worker'lar condvar'da uyur (CPU harcamaz).
+    class JobPool {
+    public:
+        // threads: worker sayisi (cagiran thread haric). <0: donanim cekirdegi - 1
+        explicit JobPool(int threads = -1);
+        ~JobPool();
+        JobPool(const JobPool&) = delete;
+        JobPool& operator=(const JobPool&) = delete;
+
+        int workerCount() const { return (int)m_threads.size(); }
+
+        // [0,count) araligini grain'lik parcalara bolup fn(begin, end) cagirir.
+        // count <= grain ise worker'lar uyandirilmadan ayni thread'de calisir.
+        void parallelFor(int count, int grain, const std::function<void(int, int)>& fn);
+
+    private:
+        void workerLoop();
+        void runChunks();
+
+        std::vector<std::thread> m_threads;
+        std::mutex              m_mx;
+        std::condition_variable m_wake, m_done;
+
+        const std::function<void(int, int)>* m_fn = nullptr;
+        int              m_count = 0, m_grain = 1;
+        std::atomic<int> m_next{ 0 };
+        int              m_pending = 0;   // isi henuz bitirmemis worker sayisi
+        unsigned         m_gen = 0;       // her parallelFor'da artar
+        bool             m_quit = false;
+    };
+
+} // namespace Erlik
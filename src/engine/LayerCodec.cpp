@@ -0,0 +1,236 @@
+#include "LayerCodec.h"
+#include <SDL.h>
+#include <zlib.h>
+#ifdef ERLIK_HAVE_ZSTD
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+
+namespace Erlik {
+
+    namespace {
+
+        // Karakter basina onceden kaydirilmis 6 bit: 4 karakterlik grup 4 lookup + OR ile 24 bite
+        // iner. Gecersiz karakter kBad bitini tasir; blok basina tek kontrol yeter.
+        constexpr uint32_t kBad = 1u << 24;
+
+        struct B64Tables {
+            uint32_t d0[256], d1[256], d2[256], d3[256];
+        };
+
+        constexpr B64Tables makeB64Tables() {
+            B64Tables t{};
+            for (int c = 0; c < 256; ++c) {
+                int v = -1;
+                if (c >= 'A' && c <= 'Z') v = c - 'A';
+                else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+                else if (c >= '0' && c <= '9') v = c - '0' + 52;
+                else if (c == '+') v = 62;
+                else if (c == '/') v = 63;
+                t.d0[c] = v < 0 ? kBad : (uint32_t)v << 18;
+                t.d1[c] = v < 0 ? kBad : (uint32_t)v << 12;
+                t.d2[c] = v < 0 ? kBad : (uint32_t)v << 6;
+                t.d3[c] = v < 0 ? kBad : (uint32_t)v;
+            }
+            return t;
+        }
+        constexpr B64Tables kB64 = makeB64Tables();
+
+        constexpr char kB64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        bool isSpace(uint8_t c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+        inline uint32_t quad(const uint8_t* p) {
+            return kB64.d0[p[0]] | kB64.d1[p[1]] | kB64.d2[p[2]] | kB64.d3[p[3]];
+        }
+
+        void fixEndian(uint32_t* gids, size_t count) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+            for (size_t i = 0; i < count; ++i) gids[i] = SDL_SwapLE32(gids[i]);
+#else
+            (void)gids; (void)count;
+#endif
+        }
+
+    } // namespace
+
+    bool parseLayerCompression(std::string_view name, LayerCompression& out)
+    {
+        if (name.empty()) out = LayerCompression::None;
+        else if (name == "zlib") out = LayerCompression::Zlib;
+        else if (name == "gzip") out = LayerCompression::Gzip;
+        else if (name == "zstd") out = LayerCompression::Zstd;
+        else return false;
+        return true;
+    }
+
+    const char* layerCompressionName(LayerCompression c)
+    {
+        switch (c) {
+        case LayerCompression::Zlib: return "zlib";
+        case LayerCompression::Gzip: return "gzip";
+        case LayerCompression::Zstd: return "zstd";
+        default: return "";
+        }
+    }
+
+    bool layerCompressionSupported(LayerCompression c)
+    {
+#ifdef ERLIK_HAVE_ZSTD
+        (void)c;
+        return true;
+#else
+        return c != LayerCompression::Zstd;
+#endif
+    }
+
+    size_t base64Decode(const char* s, size_t n, uint8_t* out, size_t cap)
+    {
+        const uint8_t* in = (const uint8_t*)s;
+        size_t i = 0, o = 0;
+
+        // Hizli yol: 16 karakter -> 12 bayt, dalsiz lookup; son 4'luk grup (olasi '=') yavas yola kalir.
+        // Bosluk ya da gecersiz karakter gorulen blok da yavas yoldan devam eder.
+        while (i + 20 <= n && o + 12 <= cap) {
+            const uint32_t a = quad(in + i), b = quad(in + i + 4), c = quad(in + i + 8), d = quad(in + i + 12);
+            if ((a | b | c | d) & kBad) break;
+            uint8_t* w = out + o;
+            w[0] = (uint8_t)(a >> 16); w[1] = (uint8_t)(a >> 8); w[2] = (uint8_t)a;
+            w[3] = (uint8_t)(b >> 16); w[4] = (uint8_t)(b >> 8); w[5] = (uint8_t)b;
+            w[6] = (uint8_t)(c >> 16); w[7] = (uint8_t)(c >> 8); w[8] = (uint8_t)c;
+            w[9] = (uint8_t)(d >> 16); w[10] = (uint8_t)(d >> 8); w[11] = (uint8_t)d;
+            i += 16; o += 12;
+        }
+
+        // Yavas yol: karakter karakter, bosluk atlanir, '=' ile biter
+        uint32_t acc = 0;
+        int bits = 0;
+        for (; i < n; ++i) {
+            const uint8_t ch = in[i];
+            if (ch == '=') break;
+            if (isSpace(ch)) continue;
+            const uint32_t v = kB64.d3[ch];
+            if (v & kBad) return kBase64Error;
+            acc = (acc << 6) | v;
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                if (o >= cap) return kBase64Error;
+                out[o++] = (uint8_t)(acc >> bits);
+            }
+        }
+        for (; i < n; ++i)
+            if (in[i] != '=' && !isSpace(in[i])) return kBase64Error;
+        return o;
+    }
+
+    void base64Encode(const uint8_t* p, size_t n, std::string& out)
+    {
+        out.clear();
+        out.reserve((n + 2) / 3 * 4);
+        size_t i = 0;
+        for (; i + 3 <= n; i += 3) {
+            const uint32_t v = (uint32_t)p[i] << 16 | (uint32_t)p[i + 1] << 8 | p[i + 2];
+            out += kB64Chars[v >> 18]; out += kB64Chars[(v >> 12) & 63];
+            out += kB64Chars[(v >> 6) & 63]; out += kB64Chars[v & 63];
+        }
+        if (i < n) {
+            const uint32_t v = (uint32_t)p[i] << 16 | (i + 1 < n ? (uint32_t)p[i + 1] << 8 : 0u);
+            out += kB64Chars[v >> 18]; out += kB64Chars[(v >> 12) & 63];
+            out += i + 1 < n ? kB64Chars[(v >> 6) & 63] : '=';
+            out += '=';
+        }
+    }
+
+    bool decodeLayerData(std::string_view b64, LayerCompression c, uint32_t* gids, size_t count,
+        std::vector<uint8_t>& scratch, std::string& err)
+    {
+        const size_t bytes = count * sizeof(uint32_t);
+        if (c == LayerCompression::None) {
+            // Sikistirmasiz: base64 dogrudan gid dizisine
+            const size_t got = base64Decode(b64.data(), b64.size(), (uint8_t*)gids, bytes);
+            if (got != bytes) { err = got == kBase64Error ? "invalid base64 (or too long)" : "size mismatch"; return false; }
+            fixEndian(gids, count);
+            return true;
+        }
+
+        scratch.resize(b64.size() / 4 * 3 + 3);
+        const size_t got = base64Decode(b64.data(), b64.size(), scratch.data(), scratch.size());
+        if (got == kBase64Error) { err = "invalid base64"; return false; }
+
+        if (c == LayerCompression::Zstd) {
+#ifdef ERLIK_HAVE_ZSTD
+            const size_t r = ZSTD_decompress(gids, bytes, scratch.data(), got);
+            if (ZSTD_getErrorCode(r) == ZSTD_error_dstSize_tooSmall) { err = "size mismatch: decoded data larger than layer"; return false; }
+            if (ZSTD_isError(r)) { err = std::string("zstd: ") + ZSTD_getErrorName(r); return false; }
+            if (r != bytes) { err = "size mismatch: decoded data smaller than layer"; return false; }
+            fixEndian(gids, count);
+            return true;
+#else
+            err = "zstd support not compiled in";
+            return false;
+#endif
+        }
+
+        // zlib ve gzip: windowBits 15+32 basligi otomatik tanir; cikti dogrudan gid dizisine
+        z_stream zs{};
+        if (inflateInit2(&zs, 15 + 32) != Z_OK) { err = "zlib init failed"; return false; }
+        zs.next_in = scratch.data();
+        zs.avail_in = (uInt)got;
+        zs.next_out = (Bytef*)gids;
+        zs.avail_out = (uInt)bytes;
+        const int r = inflate(&zs, Z_FINISH);
+        const bool full = zs.avail_out == 0;
+        const std::string msg = zs.msg ? zs.msg : "corrupt stream";
+        inflateEnd(&zs);
+        // Z_FINISH ile tum girdi elde: akis bitmeden cikti dolduysa veri katmandan buyuk
+        // (inflate bunu Z_OK ya da Z_BUF_ERROR ile bildirir), cikti dolmadan girdi bittiyse kesik
+        if (r != Z_STREAM_END || !full) {
+            if (r == Z_STREAM_END) err = "size mismatch: decoded data smaller than layer";
+            else if (full && (r == Z_OK || r == Z_BUF_ERROR)) err = "size mismatch: decoded data larger than layer";
+            else if (r == Z_BUF_ERROR) err = std::string(layerCompressionName(c)) + ": truncated stream";
+            else err = std::string(layerCompressionName(c)) + ": " + msg;
+            return false;
+        }
+        fixEndian(gids, count);
+        return true;
+    }
+
+    bool encodeLayerData(const uint32_t* gids, size_t count, LayerCompression c, std::string& out, int level)
+    {
+        std::vector<uint32_t> le(gids, gids + count);
+        fixEndian(le.data(), count);
+        const uint8_t* raw = (const uint8_t*)le.data();
+        const size_t bytes = count * sizeof(uint32_t);
+        if (c == LayerCompression::None) { base64Encode(raw, bytes, out); return true; }
+
+        std::vector<uint8_t> packed;
+        if (c == LayerCompression::Zstd) {
+#ifdef ERLIK_HAVE_ZSTD
+            packed.resize(ZSTD_compressBound(bytes));
+            const size_t r = ZSTD_compress(packed.data(), packed.size(), raw, bytes, level < 0 ? ZSTD_CLEVEL_DEFAULT : level);
+            if (ZSTD_isError(r)) return false;
+            packed.resize(r);
+#else
+            return false;
+#endif
+        }
+        else {
+            z_stream zs{};
+            const int bitsW = c == LayerCompression::Gzip ? 15 + 16 : 15;
+            if (deflateInit2(&zs, level < 0 ? Z_DEFAULT_COMPRESSION : level, Z_DEFLATED, bitsW, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+            packed.resize(deflateBound(&zs, (uLong)bytes) + 32);
+            zs.next_in = (Bytef*)raw;
+            zs.avail_in = (uInt)bytes;
+            zs.next_out = packed.data();
+            zs.avail_out = (uInt)packed.size();
+            const int r = deflate(&zs, Z_FINISH);
+            packed.resize(zs.total_out);
+            deflateEnd(&zs);
+            if (r != Z_STREAM_END) return false;
+        }
+        base64Encode(packed.data(), packed.size(), out);
+        return true;
+    }
+
+} // namespace Erlik
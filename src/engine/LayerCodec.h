@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Erlik {
+
+    // Tiled tile layer "data" kodlamasi: encoding "base64" + compression ("", zlib, gzip, zstd).
+    // Cozulmus veri width*height adet little-endian uint32 gid'dir.
+    enum class LayerCompression : uint8_t { None, Zlib, Gzip, Zstd };
+
+    // "" / "zlib" / "gzip" / "zstd"; taninmayan ad: false
+    bool parseLayerCompression(std::string_view name, LayerCompression& out);
+    const char* layerCompressionName(LayerCompression c);
+    bool layerCompressionSupported(LayerCompression c); // zstd derlemeye bagli (ERLIK_HAVE_ZSTD)
+
+    // base64 -> bayt. Donus: yazilan bayt; gecersiz girdi ya da cap asimi: kBase64Error.
+    // Bosluk/satir sonu atlanir, '=' dolgusu opsiyonel.
+    constexpr size_t kBase64Error = ~(size_t)0;
+    size_t base64Decode(const char* s, size_t n, uint8_t* out, size_t cap);
+    void   base64Encode(const uint8_t* p, size_t n, std::string& out);
+
+    // Kodlanmis layer verisini dogrudan gids[0..count) dizisine acar (ara gid kopyasi yok).
+    // Sikistirilmis veride base64 ciktisi scratch'e yazilir (cagiran tekrar kullanir).
+    // Boyut tam count*4 bayt olmali; hata: false + err.
+    bool decodeLayerData(std::string_view b64, LayerCompression c, uint32_t* gids, size_t count,
+        std::vector<uint8_t>& scratch, std::string& err);
+    // Ters yon (araclar/bench): gid'ler -> base64 (+ sikistirma). level < 0: kutuphane varsayilani
+    bool encodeLayerData(const uint32_t* gids, size_t count, LayerCompression c, std::string& out, int level = -1);
+
+} // namespace Erlik
@@ -0,0 +1,292 @@
+#include "Lighting.h"
+#include "Tilemap.h"
+#include "Renderer2D.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Erlik {
+
+    // Isik merkezinden texel merkezine tile DDA: aradaki bir solid tile gorusu keser.
+    // Hedef tile'in kendisi sayilmaz (duvar yuzeyleri aydinlansin).
+    static bool tileLineClear(const Tilemap& m, float x0, float y0, float x1, float y1)
+    {
+        const float tile = (float)m.tileSize();
+        int tx = (int)std::floor(x0 / tile), ty = (int)std::floor(y0 / tile);
+        const int ex = (int)std::floor(x1 / tile), ey = (int)std::floor(y1 / tile);
+        if (tx == ex && ty == ey) return true;
+
+        const float dx = x1 - x0, dy = y1 - y0;
+        const int stepX = (dx > 0.f) ? 1 : -1;
+        const int stepY = (dy > 0.f) ? 1 : -1;
+        const float inf = 1e30f;
+        const float tDeltaX = (dx != 0.f) ? std::fabs(tile / dx) : inf;
+        const float tDeltaY = (dy != 0.f) ? std::fabs(tile / dy) : inf;
+        float tMaxX = (dx != 0.f) ? (((stepX > 0 ? (tx + 1) * tile : tx * tile) - x0) / dx) : inf;
+        float tMaxY = (dy != 0.f) ? (((stepY > 0 ? (ty + 1) * tile : ty * tile) - y0) / dy) : inf;
+
+        // |ex-tx| + |ey-ty| adimdan fazlasi gerekmez
+        int steps = std::abs(ex - tx) + std::abs(ey - ty);
+        while (steps-- > 0) {
+            if (tMaxX < tMaxY) { tx += stepX; tMaxX += tDeltaX; }
+            else               { ty += stepY; tMaxY += tDeltaY; }
+            if (tx == ex && ty == ey) return true;
+            if (m.solidAtTile(tx, ty)) return false;
+        }
+        return true;
+    }
+
+    bool LightMap::init(SDL_Renderer* r, int worldW, int worldH, int cellPx)
+    {
+        shutdown();
+        if (!r || worldW <= 0 || worldH <= 0 || cellPx <= 0) return false;
+        m_cell = cellPx;
+        m_w = (worldW + cellPx - 1) / cellPx;
+        m_h = (worldH + cellPx - 1) / cellPx;
+        if (!m_tex.createStreaming(r, m_w, m_h, SDL_PIXELFORMAT_RGBA8888)) { m_w = m_h = 0; return false; }
+        // Lightmap dunyayi carpar (dst * src)
+        m_tex.setBlend(SDL_BLENDMODE_MOD);
+        SDL_SetTextureScaleMode(m_tex.sdl(), SDL_ScaleModeLinear);
+
+        m_pixels.assign((size_t)m_w * (size_t)m_h, 0xFFFFFFFFu);
+        markDirtyRect(0, 0, m_w, m_h);
+        SDL_Log("lightmap: %dx%d texels (cell=%dpx)", m_w, m_h, m_cell);
+        return true;
+    }
+
+    void LightMap::shutdown()
+    {
+        m_tex.destroy();
+        m_slots.clear(); m_free.clear(); m_alive = 0;
+        m_dirty.clear(); m_pixels.clear(); m_acc.clear();
+        m_anyDirtyLight = false;
+        m_w = m_h = 0;
+    }
+
+    void LightMap::setAmbient(Uint8 r, Uint8 g, Uint8 b)
+    {
+        if (r == m_ambR && g == m_ambG && b == m_ambB) return;
+        m_ambR = r; m_ambG = g; m_ambB = b;
+        markDirtyRect(0, 0, m_w, m_h);
+    }
+
+    int LightMap::addLight(const PointLight& l)
+    {
+        int id;
+        if (!m_free.empty()) { id = m_free.back(); m_free.pop_back(); }
+        else { id = (int)m_slots.size(); m_slots.emplace_back(); }
+        Slot& s = m_slots[id];
+        s.l = l; s.alive = true; s.dirty = true;
+        s.fx = s.fy = s.fw = s.fh = 0; s.falloff.clear();
+        m_alive++;
+        m_anyDirtyLight = true;
+        return id;
+    }
+
+    void LightMap::setLight(int id, const PointLight& l)
+    {
+        if (id < 0 || id >= (int)m_slots.size() || !m_slots[id].alive) return;
+        Slot& s = m_slots[id];
+        const PointLight& o = s.l;
+        if (o.x == l.x && o.y == l.y && o.radius == l.radius && o.r == l.r && o.g == l.g && o.b == l.b &&
+            o.intensity == l.intensity && o.shadows == l.shadows) return;
+        s.l = l; s.dirty = true; m_anyDirtyLight = true;
+    }
+
+    void LightMap::moveLight(int id, float x, float y)
+    {
+        if (id < 0 || id >= (int)m_slots.size() || !m_slots[id].alive) return;
+        Slot& s = m_slots[id];
+        if (s.l.x == x && s.l.y == y) return;
+        s.l.x = x; s.l.y = y; s.dirty = true; m_anyDirtyLight = true;
+    }
+
+    void LightMap::removeLight(int id)
+    {
+        if (id < 0 || id >= (int)m_slots.size() || !m_slots[id].alive) return;
+        Slot& s = m_slots[id];
+        markDirtyRect(s.fx, s.fy, s.fx + s.fw, s.fy + s.fh);
+        s.alive = false; s.dirty = false; s.falloff.clear();
+        m_free.push_back(id);
+        m_alive--;
+    }
+
+    void LightMap::clearLights()
+    {
+        for (int i = 0; i < (int)m_slots.size(); ++i) if (m_slots[i].alive) removeLight(i);
+    }
+
+    const PointLight* LightMap::light(int id) const
+    {
+        if (id < 0 || id >= (int)m_slots.size() || !m_slots[id].alive) return nullptr;
+        return &m_slots[id].l;
+    }
+
+    void LightMap::invalidateTiles(int tx0, int ty0, int tx1, int ty1, int tileSize)
+    {
+        if (m_w <= 0 || tileSize <= 0) return;
+        const int x0 = (tx0 * tileSize) / m_cell, y0 = (ty0 * tileSize) / m_cell;
+        const int x1 = ((tx1 + 1) * tileSize + m_cell - 1) / m_cell;
+        const int y1 = ((ty1 + 1) * tileSize + m_cell - 1) / m_cell;
+        for (auto& s : m_slots) {
+            if (!s.alive || !s.l.shadows) continue;
+            if (s.fx >= x1 || s.fx + s.fw <= x0 || s.fy >= y1 || s.fy + s.fh <= y0) continue;
+            s.dirty = true; m_anyDirtyLight = true;
+        }
+    }
+
+    void LightMap::invalidateAll()
+    {
+        for (auto& s : m_slots) if (s.alive) { s.dirty = true; m_anyDirtyLight = true; }
+        markDirtyRect(0, 0, m_w, m_h);
+    }
+
+    void LightMap::markDirtyRect(int x0, int y0, int x1, int y1)
+    {
+        x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+        x1 = std::min(x1, m_w); y1 = std::min(y1, m_h);
+        if (x1 <= x0 || y1 <= y0) return;
+
+        // Cakisan bir rect varsa birlestir (yeniden toplama idempotent)
+        for (auto& d : m_dirty) {
+            if (x0 <= d.x1 && x1 >= d.x0 && y0 <= d.y1 && y1 >= d.y0) {
+                d.x0 = std::min(d.x0, x0); d.y0 = std::min(d.y0, y0);
+                d.x1 = std::max(d.x1, x1); d.y1 = std::max(d.y1, y1);
+                return;
+            }
+        }
+        m_dirty.push_back(Rect{ x0, y0, x1, y1 });
+        if (m_dirty.size() > 8) {
+            Rect u = m_dirty[0];
+            for (const auto& d : m_dirty) {
+                u.x0 = std::min(u.x0, d.x0); u.y0 = std::min(u.y0, d.y0);
+                u.x1 = std::max(u.x1, d.x1); u.y1 = std::max(u.y1, d.y1);
+            }
+            m_dirty.clear(); m_dirty.push_back(u);
+        }
+    }
+
+    void LightMap::rebuildFootprint(Slot& s, const Tilemap& occluders)
+    {
+        const PointLight& l = s.l;
+        const float cell = (float)m_cell;
+        int x0 = (int)std::floor((l.x - l.radius) / cell);
+        int y0 = (int)std::floor((l.y - l.radius) / cell);
+        int x1 = (int)std::ceil((l.x + l.radius) / cell);
+        int y1 = (int)std::ceil((l.y + l.radius) / cell);
+        x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+        x1 = std::min(x1, m_w); y1 = std::min(y1, m_h);
+
+        s.fx = x0; s.fy = y0;
+        s.fw = std::max(0, x1 - x0); s.fh = std::max(0, y1 - y0);
+        s.falloff.assign((size_t)s.fw * (size_t)s.fh, 0);
+        if (s.fw == 0 || s.fh == 0 || l.radius <= 0.f) return;
+
+        const bool occlude = l.shadows && occluders.cols() > 0;
+        const float invR = 1.f / l.radius;
+        for (int ty = 0; ty < s.fh; ++ty) {
+            const float wy = (y0 + ty + 0.5f) * cell;
+            const float dy = wy - l.y;
+            for (int tx = 0; tx < s.fw; ++tx) {
+                const float wx = (x0 + tx + 0.5f) * cell;
+                const float dx = wx - l.x;
+                const float d = std::sqrt(dx * dx + dy * dy);
+                if (d >= l.radius) continue;
+                const float k = 1.f - d * invR;
+                if (occlude && !tileLineClear(occluders, l.x, l.y, wx, wy)) continue;
+                s.falloff[(size_t)ty * s.fw + tx] = (uint8_t)std::lround(k * k * 255.f);
+            }
+        }
+    }
+
+    void LightMap::compose(const Rect& rc)
+    {
+        const int w = rc.x1 - rc.x0, h = rc.y1 - rc.y0;
+        if (w <= 0 || h <= 0) return;
+        m_acc.resize((size_t)w * (size_t)h * 3);
+        for (size_t i = 0; i < (size_t)w * h; ++i) {
+            m_acc[i * 3 + 0] = m_ambR; m_acc[i * 3 + 1] = m_ambG; m_acc[i * 3 + 2] = m_ambB;
+        }
+
+        for (const auto& s : m_slots) {
+            if (!s.alive || s.fw == 0 || s.fh == 0) continue;
+            const int ix0 = std::max(rc.x0, s.fx), iy0 = std::max(rc.y0, s.fy);
+            const int ix1 = std::min(rc.x1, s.fx + s.fw), iy1 = std::min(rc.y1, s.fy + s.fh);
+            if (ix1 <= ix0 || iy1 <= iy0) continue;
+
+            const int kr = (int)std::lround(s.l.r * s.l.intensity);
+            const int kg = (int)std::lround(s.l.g * s.l.intensity);
+            const int kb = (int)std::lround(s.l.b * s.l.intensity);
+            for (int y = iy0; y < iy1; ++y) {
+                const uint8_t* src = &s.falloff[(size_t)(y - s.fy) * s.fw + (ix0 - s.fx)];
+                int* acc = &m_acc[((size_t)(y - rc.y0) * w + (ix0 - rc.x0)) * 3];
+                for (int x = ix0; x < ix1; ++x, ++src, acc += 3) {
+                    const int f = *src;
+                    if (!f) continue;
+                    acc[0] += (f * kr + 127) / 255;
+                    acc[1] += (f * kg + 127) / 255;
+                    acc[2] += (f * kb + 127) / 255;
+                }
+            }
+        }
+
+        for (int y = 0; y < h; ++y) {
+            Uint32* dst = &m_pixels[(size_t)(rc.y0 + y) * m_w + rc.x0];
+            const int* acc = &m_acc[(size_t)y * w * 3];
+            for (int x = 0; x < w; ++x, acc += 3) {
+                const Uint32 r = (Uint32)std::min(acc[0], 255);
+                const Uint32 g = (Uint32)std::min(acc[1], 255);
+                const Uint32 b = (Uint32)std::min(acc[2], 255);
+                dst[x] = (r << 24) | (g << 16) | (b << 8) | 0xFFu;
+            }
+        }
+
+        SDL_Rect up{ rc.x0, rc.y0, w, h };
+        SDL_UpdateTexture(m_tex.sdl(), &up, &m_pixels[(size_t)rc.y0 * m_w + rc.x0], m_w * (int)sizeof(Uint32));
+        m_statTexels += w * h;
+    }
+
+    void LightMap::update(const Tilemap& occluders)
+    {
+        m_statLights = 0; m_statTexels = 0;
+        if (!m_tex.sdl()) return;
+        if (!m_anyDirtyLight && m_dirty.empty()) return; // statik sahne: sifir is
+
+        if (m_anyDirtyLight) {
+            for (auto& s : m_slots) {
+                if (!s.alive || !s.dirty) continue;
+                markDirtyRect(s.fx, s.fy, s.fx + s.fw, s.fy + s.fh);   // eski footprint
+                rebuildFootprint(s, occluders);
+                markDirtyRect(s.fx, s.fy, s.fx + s.fw, s.fy + s.fh);   // yeni footprint
+                s.dirty = false;
+                m_statLights++;
+            }
+            m_anyDirtyLight = false;
+        }
+
+        for (const auto& rc : m_dirty) compose(rc);
+        m_dirty.clear();
+    }
+
+    void LightMap::draw(Renderer2D& r2d) const
+    {
+        if (!m_tex.sdl()) return;
+        int vw, vh; r2d.outputSize(vw, vh);
+        const Camera2D& cam = r2d.camera();
+        const float cell = (float)m_cell;
+
+        int x0 = (int)std::floor(cam.x / cell);
+        int y0 = (int)std::floor(cam.y / cell);
+        int x1 = (int)std::ceil((cam.x + vw / cam.zoom) / cell);
+        int y1 = (int)std::ceil((cam.y + vh / cam.zoom) / cell);
+        x0 = std::clamp(x0, 0, m_w); x1 = std::clamp(x1, 0, m_w);
+        y0 = std::clamp(y0, 0, m_h); y1 = std::clamp(y1, 0, m_h);
+        if (x1 <= x0 || y1 <= y0) return;
+
+        // Gorunen texel bolgesini tek MOD blit ile world'e uygula
+        SDL_Rect src{ x0, y0, x1 - x0, y1 - y0 };
+        const float cx = (x0 + src.w * 0.5f) * cell;
+        const float cy = (y0 + src.h * 0.5f) * cell;
+        r2d.drawTextureSDL(m_tex.sdl(), &src, cx, cy, cell, 0.0f, SDL_FLIP_NONE);
+    }
+
+} // namespace Erlik
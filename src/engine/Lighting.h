@@ -0,0 +1,84 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+#include "Texture.h"
+
+namespace Erlik {
+
+    class Tilemap;
+    class Renderer2D;
+
+    struct PointLight {
+        float x = 0.f, y = 0.f;      // world-space center (px)
+        float radius = 160.f;        // px
+        Uint8 r = 255, g = 220, b = 170;
+        float intensity = 1.0f;      // 0..N (1 = full color at center)
+        bool  shadows = true;        // collision grid ile occlusion
+    };
+
+    // Dusuk cozunurluklu, dunyaya hizali CPU lightmap.
+    // Her isik kendi "footprint"ini (falloff * gorunurluk) cache'ler; sadece hareket eden /
+    // degisen isiklar yeniden hesaplanir, etkilenen texel bolgesi yeniden toplanip
+    // SDL_UpdateTexture ile yuklenir. Cizim: SDL_BLENDMODE_MOD ile tek blit.
+    class LightMap {
+    public:
+        // worldW/H: piksel, cellPx: bir lightmap texel'inin kapsadigi piksel
+        bool init(SDL_Renderer* r, int worldW, int worldH, int cellPx = 8);
+        void shutdown();
+
+        void setAmbient(Uint8 r, Uint8 g, Uint8 b);
+        int  addLight(const PointLight& l);            // id doner
+        void setLight(int id, const PointLight& l);    // degismediyse hicbir sey yapmaz
+        void moveLight(int id, float x, float y);
+        void removeLight(int id);
+        void clearLights();
+        const PointLight* light(int id) const;
+
+        // Occluder (collision) degisti: bu tile bolgesine dokunan isiklari yeniden hesapla
+        void invalidateTiles(int tx0, int ty0, int tx1, int ty1, int tileSize);
+        void invalidateAll();
+
+        // Kirli isiklari yeniden hesapla + kirli bolgeleri yeniden topla/yukle.
+        // Hicbir sey degismediyse O(1).
+        void update(const Tilemap& occluders);
+        // drawAbovePlayer'dan sonra cagir (kamera world-space olmali)
+        void draw(Renderer2D& r2d) const;
+
+        bool ready() const { return m_tex.sdl() != nullptr; }
+        int  lightCount() const { return m_alive; }
+        int  lastRebuiltLights() const { return m_statLights; }
+        int  lastUploadedTexels() const { return m_statTexels; }
+
+    private:
+        struct Slot {
+            PointLight l;
+            bool alive = false;
+            bool dirty = false;
+            // footprint (texel koordinatlari, lightmap'e kirpilmis)
+            int fx = 0, fy = 0, fw = 0, fh = 0;
+            std::vector<uint8_t> falloff; // fw*fh, 0..255
+        };
+        struct Rect { int x0, y0, x1, y1; }; // texel, [x0,x1) x [y0,y1)
+
+        void markDirtyRect(int x0, int y0, int x1, int y1);
+        void rebuildFootprint(Slot& s, const Tilemap& occluders);
+        void compose(const Rect& rc);
+
+        Texture m_tex;
+        int m_cell = 8;
+        int m_w = 0, m_h = 0;           // texel
+        Uint8 m_ambR = 40, m_ambG = 40, m_ambB = 56;
+
+        std::vector<Slot>     m_slots;
+        std::vector<int>      m_free;
+        int                   m_alive = 0;
+        bool                  m_anyDirtyLight = false;
+        std::vector<Rect>     m_dirty;
+        std::vector<Uint32>   m_pixels;   // m_w*m_h, RGBA8888
+        std::vector<int>      m_acc;      // compose scratch (rgb)
+
+        int m_statLights = 0, m_statTexels = 0;
+    };
+
+} // namespace Erlik
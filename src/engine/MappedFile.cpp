@@ -0,0 +1,73 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Erlik {
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+        HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (f == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(f, &sz) || sz.QuadPart <= 0) { CloseHandle(f); return false; }
+        HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m) { CloseHandle(f); return false; }
+        void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+        if (!p) { CloseHandle(m); CloseHandle(f); return false; }
+        m_file = f; m_mapping = m;
+        m_data = (const uint8_t*)p;
+        m_size = (size_t)sz.QuadPart;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle((HANDLE)m_mapping);
+        if (m_file) CloseHandle((HANDLE)m_file);
+        m_data = nullptr; m_size = 0;
+        m_mapping = nullptr; m_file = nullptr;
+    }
+#else
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { ::close(fd); return false; }
+        madvise(p, (size_t)st.st_size, MADV_WILLNEED); // tek seferde okunacak: onden getir
+        m_fd = fd;
+        m_data = (const uint8_t*)p;
+        m_size = (size_t)st.st_size;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data) munmap((void*)m_data, m_size);
+        if (m_fd >= 0) ::close(m_fd);
+        m_data = nullptr; m_size = 0;
+        m_fd = -1;
+    }
+#endif
+
+} // namespace Erlik
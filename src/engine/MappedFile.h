@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Erlik {
+
+    // Salt-okunur bellek esleme (POSIX mmap / Win32 MapViewOfFile). Sayfalar ilk erisimde
+    // diskten/page cache'ten gelir; okuma tamponu ya da kopya yok. RAII: yikicida kapanir.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::string& path);   // bos dosya ya da hata: false
+        void close();
+
+        const uint8_t* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+    };
+
+} // namespace Erlik
@@ -0,0 +1,130 @@
+#include "Minimap.h"
+#include "Renderer2D.h"
+#include "TMJMap.h"
+#include "Tilemap.h"
+#include <algorithm>
+
+namespace Erlik {
+
+    static inline Uint32 rgba(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+        return ((Uint32)r << 24) | ((Uint32)g << 16) | ((Uint32)b << 8) | (Uint32)a;
+    }
+
+    Uint32 Minimap::cellColor(const TMJMap& tmj, const Tilemap& col, int tx, int ty)
+    {
+        if (col.solidAtTile(tx, ty))  return rgba(150, 150, 162, 255);
+        if (col.oneWayAtTile(tx, ty)) return rgba(90, 170, 230, 255);
+        uint8_t r, g, b;
+        if (tmj.minimapColor(tx, ty, r, g, b)) return rgba(r, g, b, 220);
+        return rgba(14, 14, 20, 170); // bos
+    }
+
+    bool Minimap::build(SDL_Renderer* r, const TMJMap& tmj, const Tilemap& col)
+    {
+        m_tex.destroy();
+        m_cols = col.cols(); m_rows = col.rows(); m_tile = col.tileSize();
+        m_dx0 = m_dy0 = 0; m_dx1 = m_dy1 = -1;
+        if (!r || m_cols <= 0 || m_rows <= 0) { m_pixels.clear(); return false; }
+        if (!m_tex.createStreaming(r, m_cols, m_rows, SDL_PIXELFORMAT_RGBA8888)) return false;
+
+        colorize(tmj, col, m_pixels);
+        SDL_UpdateTexture(m_tex.sdl(), nullptr, m_pixels.data(), m_cols * (int)sizeof(Uint32));
+        SDL_Log("minimap: built %dx%d", m_cols, m_rows);
+        return true;
+    }
+
+    void Minimap::colorize(const TMJMap& tmj, const Tilemap& col, std::vector<Uint32>& out)
+    {
+        const int cols = std::max(0, col.cols()), rows = std::max(0, col.rows());
+        out.resize((size_t)cols * (size_t)rows);
+        for (int ty = 0; ty < rows; ++ty)
+            for (int tx = 0; tx < cols; ++tx)
+                out[(size_t)ty * cols + tx] = cellColor(tmj, col, tx, ty);
+    }
+
+    int Minimap::refresh(SDL_Renderer* r, const TMJMap& tmj, const Tilemap& col)
+    {
+        std::vector<Uint32> pixels;
+        colorize(tmj, col, pixels);
+        return refresh(r, col.cols(), col.rows(), col.tileSize(), pixels);
+    }
+
+    int Minimap::refresh(SDL_Renderer* r, int cols, int rows, int tile, std::vector<Uint32>& pixels)
+    {
+        if (pixels.size() != (size_t)std::max(0, cols) * (size_t)std::max(0, rows)) return 0;
+        if (!m_tex.sdl() || cols != m_cols || rows != m_rows) { // boyut degisti: tam kurulum
+            m_tex.destroy();
+            m_cols = cols; m_rows = rows; m_tile = tile;
+            m_dx0 = m_dy0 = 0; m_dx1 = m_dy1 = -1;
+            m_pixels.swap(pixels);
+            if (!r || m_cols <= 0 || m_rows <= 0) { m_pixels.clear(); return 0; }
+            if (!m_tex.createStreaming(r, m_cols, m_rows, SDL_PIXELFORMAT_RGBA8888)) return 0;
+            SDL_UpdateTexture(m_tex.sdl(), nullptr, m_pixels.data(), m_cols * (int)sizeof(Uint32));
+            SDL_Log("minimap: built %dx%d", m_cols, m_rows);
+            return m_cols * m_rows;
+        }
+        m_tile = tile;
+
+        int changed = 0;
+        for (int ty = 0; ty < m_rows; ++ty) {
+            for (int tx = 0; tx < m_cols; ++tx) {
+                const size_t i = (size_t)ty * m_cols + tx;
+                if (m_pixels[i] == pixels[i]) continue;
+                markDirty(tx, ty); changed++;
+            }
+        }
+        m_pixels.swap(pixels);
+        flush();
+        return changed;
+    }
+
+    void Minimap::updateCell(const TMJMap& tmj, const Tilemap& col, int tx, int ty)
+    {
+        if (tx < 0 || ty < 0 || tx >= m_cols || ty >= m_rows) return;
+        const Uint32 c = cellColor(tmj, col, tx, ty);
+        Uint32& dst = m_pixels[(size_t)ty * m_cols + tx];
+        if (dst == c) return;
+        dst = c; markDirty(tx, ty);
+    }
+
+    void Minimap::markDirty(int tx, int ty)
+    {
+        if (m_dx1 < m_dx0) { m_dx0 = m_dx1 = tx; m_dy0 = m_dy1 = ty; return; }
+        m_dx0 = std::min(m_dx0, tx); m_dx1 = std::max(m_dx1, tx);
+        m_dy0 = std::min(m_dy0, ty); m_dy1 = std::max(m_dy1, ty);
+    }
+
+    void Minimap::flush()
+    {
+        if (!m_tex.sdl() || m_dx1 < m_dx0) return;
+        SDL_Rect rc{ m_dx0, m_dy0, m_dx1 - m_dx0 + 1, m_dy1 - m_dy0 + 1 };
+        SDL_UpdateTexture(m_tex.sdl(), &rc, &m_pixels[(size_t)m_dy0 * m_cols + m_dx0], m_cols * (int)sizeof(Uint32));
+        m_dx0 = m_dy0 = 0; m_dx1 = m_dy1 = -1;
+    }
+
+    void Minimap::draw(Renderer2D& r2d, float x, float y, float maxW, float maxH,
+        float playerX, float playerY, const std::vector<Trigger>& triggers) const
+    {
+        if (!m_tex.sdl()) return;
+        const float s = std::min(maxW / (float)m_cols, maxH / (float)m_rows);
+        const float w = m_cols * s, h = m_rows * s;
+        const SDL_FRect dst{ x + (maxW - w), y + (maxH - h), w, h }; // sag-alt koseye yasli
+        r2d.drawTextureScreen(m_tex.sdl(), nullptr, dst);
+
+        // world px -> minimap px
+        const float k = s / (float)m_tile;
+
+        // Trigger marker'lari (tek cagri)
+        m_markers.clear();
+        for (const auto& t : triggers) {
+            m_markers.push_back(SDL_FRect{ dst.x + t.x * k, dst.y + t.y * k,
+                std::max(2.f, t.w * k), std::max(2.f, t.h * k) });
+        }
+        r2d.fillRectsScreen(m_markers.data(), (int)m_markers.size(), SDL_Color{ 240,200,60,170 });
+
+        // Oyuncu
+        const SDL_FRect pm{ dst.x + playerX * k - 2.f, dst.y + playerY * k - 2.f, 4.f, 4.f };
+        r2d.fillRectScreen(pm, SDL_Color{ 255,70,70,255 });
+    }
+
+} // namespace Erlik
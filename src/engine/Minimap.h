@@ -0,0 +1,52 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+#include "Texture.h"
+
+namespace Erlik {
+
+    class TMJMap;
+    class Renderer2D;
+    class Tilemap;
+    struct Trigger;
+
+    // Tile basina bir texel'lik minimap. Yuklemede bir kez olusturulur; hot reload ya da
+    // runtime tile edit'lerinde sadece degisen hucreler yeniden yuklenir.
+    // Cizim: Renderer2D uzerinden tek texture blit + marker'lar (tek FillRects cagrisi).
+    class Minimap {
+    public:
+        bool build(SDL_Renderer* r, const TMJMap& tmj, const Tilemap& col);
+        // Hot reload sonrasi: boyut ayniysa farki bulup sadece degisenleri yukler.
+        // Degisen hucre sayisini doner (boyut degistiyse tamamen yeniden kurar).
+        int  refresh(SDL_Renderer* r, const TMJMap& tmj, const Tilemap& col);
+        // Ayni fark yuklemesi, texel'ler onceden colorize ile hazirlanmis (pixels tuketilir)
+        int  refresh(SDL_Renderer* r, int cols, int rows, int tile, std::vector<Uint32>& pixels);
+        // GPU'suz, thread-safe: hucre renkleri (cols*rows). Hot reload worker'inda cagrilir
+        static void colorize(const TMJMap& tmj, const Tilemap& col, std::vector<Uint32>& out);
+        // Runtime edit: hucreyi yeniden renklendir, yukleme flush()'a kadar bekler
+        void updateCell(const TMJMap& tmj, const Tilemap& col, int tx, int ty);
+        void flush();   // kirli bolgeyi tek SDL_UpdateTexture ile yukle
+
+        // Ekran koordinatlarinda (HUD) ciz. maxW/maxH kutusuna orani koruyarak, sag-alta yasli sigdirir.
+        void draw(Renderer2D& r2d, float x, float y, float maxW, float maxH,
+            float playerX, float playerY, const std::vector<Trigger>& triggers) const;
+
+        bool ready() const { return m_tex.sdl() != nullptr; }
+        int  cols() const { return m_cols; }
+        int  rows() const { return m_rows; }
+
+    private:
+        static Uint32 cellColor(const TMJMap& tmj, const Tilemap& col, int tx, int ty);
+        void   markDirty(int tx, int ty);
+
+        Texture m_tex;
+        int     m_cols = 0, m_rows = 0;
+        int     m_tile = 32;                  // world px / texel
+        std::vector<Uint32> m_pixels;         // RGBA8888, cols*rows
+        int     m_dx0 = 0, m_dy0 = 0, m_dx1 = -1, m_dy1 = -1; // kirli bolge (dahil)
+
+        mutable std::vector<SDL_FRect> m_markers; // draw scratch
+    };
+
+} // namespace Erlik
@@ -0,0 +1,373 @@
+#include "NavGraph.h"
+#include "Renderer2D.h"
+#include "Tilemap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Erlik {
+
+    namespace {
+        constexpr float SIM_DT = 1.f / 60.f;
+        constexpr float SIM_MAX_T = 2.5f;     // daha uzun dususler kenar sayilmaz
+        constexpr int   SHORT_JUMP_FRAMES = 6; // kisa ziplamada tusun basili kaldigi kare
+        constexpr int   JUMP_STRIDE = 2;      // ziplama kalkislari her N hucrede bir
+        constexpr int   DEDUP_TILES = 4;      // ayni hedefe yakin kalkislardan biri yeter
+
+        // A* scratch: nesil damgasiyla sorgu basina temizlenmez, toplu sorguda tekrar kullanilir
+        struct Scratch {
+            std::vector<float>    g;
+            std::vector<int>      parent;
+            std::vector<uint32_t> stamp;
+            std::vector<std::pair<float, int>> heap;
+            uint32_t gen = 0;
+
+            void prepare(size_t n) {
+                if (g.size() < n) { g.resize(n); parent.resize(n); stamp.resize(n, 0u); }
+                if (++gen == 0) { std::fill(stamp.begin(), stamp.end(), 0u); gen = 1; }
+                heap.clear();
+            }
+        };
+        thread_local Scratch t_scratch;
+
+        constexpr int START = 0, GOAL = 1;
+    }
+
+    void NavGraph::clear()
+    {
+        m_surf.clear(); m_out.clear(); m_free.clear(); m_cell.clear();
+        m_edgeBase.clear(); m_flatOwner.clear();
+        m_alive = 0; m_edgeTotal = 0;
+    }
+
+    bool NavGraph::walkable(const Tilemap& map, int tx, int ty) const
+    {
+        if (tx < 0 || ty < 0 || tx >= m_cols || ty >= m_rows) return false;
+        if (map.anyInRow(ty, tx, tx, Tilemap::MASK_SOLID)) return false;
+        // sekilli hucrede govde hucrenin icinde durur; digerlerinde alttaki zemin gerekir
+        const bool shaped = map.anyInRow(ty, tx, tx, Tilemap::MASK_SHAPED);
+        if (!shaped && !map.anyInRow(ty + 1, tx, tx, Tilemap::MASK_BLOCK)) return false;
+        for (int k = 1; k < m_clearRows; ++k)
+            if (map.anyInRow(ty - k, tx, tx, Tilemap::MASK_SOLID | Tilemap::MASK_SHAPED)) return false;
+        return true;
+    }
+
+    void NavGraph::rowRuns(const Tilemap& map, int ty, std::vector<NavSurface>& out) const
+    {
+        out.clear();
+        for (int tx = 0; tx < m_cols; ++tx) {
+            if (!walkable(map, tx, ty)) continue;
+            NavSurface s; s.row = ty; s.tx0 = tx; s.alive = true;
+            while (tx + 1 < m_cols && walkable(map, tx + 1, ty)) ++tx;
+            s.tx1 = tx;
+            out.push_back(s);
+        }
+    }
+
+    int NavGraph::addSurface(const NavSurface& s)
+    {
+        int id;
+        if (!m_free.empty()) { id = m_free.back(); m_free.pop_back(); m_surf[id] = s; }
+        else { id = (int)m_surf.size(); m_surf.push_back(s); m_out.emplace_back(); }
+        for (int tx = s.tx0; tx <= s.tx1; ++tx) m_cell[(size_t)s.row * m_cols + tx] = id;
+        ++m_alive;
+        return id;
+    }
+
+    void NavGraph::killSurface(int id)
+    {
+        NavSurface& s = m_surf[id];
+        for (int tx = s.tx0; tx <= s.tx1; ++tx) m_cell[(size_t)s.row * m_cols + tx] = -1;
+        s.alive = false;
+        m_out[id].clear();
+        --m_alive;
+    }
+
+    int NavGraph::surfaceUnder(const Player& p) const
+    {
+        const float t = (float)m_tile;
+        const int ty = (int)std::floor((p.y + p.halfH - 0.5f) / t);
+        auto at = [&](int tx, int row) {
+            if (tx < 0 || row < 0 || tx >= m_cols || row >= m_rows) return -1;
+            return m_cell[(size_t)row * m_cols + tx];
+        };
+        const int tx = (int)std::floor(p.x / t);
+        int s = at(tx, ty);
+        if (s < 0) s = at(tx, ty + 1); // egimin tepesinde ayak satir sinirinda
+        if (s < 0) s = at((int)std::floor((p.x - p.halfW + 1.f) / t), ty);
+        if (s < 0) s = at((int)std::floor((p.x + p.halfW - 1.f) / t), ty);
+        return s;
+    }
+
+    int NavGraph::surfaceAt(float x, float feetY) const
+    {
+        Player p;
+        p.x = x; p.y = feetY - m_halfH; p.halfW = m_halfW; p.halfH = m_halfH;
+        return surfaceUnder(p);
+    }
+
+    // Kalkis noktasindan kontrolcuyu kosar; baska bir yuzeye inerse (ya da yururken gecerse) kenar.
+    bool NavGraph::simulate(const Tilemap& map, int from, float x, int dir, uint8_t kind, NavEdge& e) const
+    {
+        const NavSurface& S = m_surf[from];
+        const float t = (float)m_tile;
+        Player p;
+        p.halfW = m_halfW; p.halfH = m_halfH;
+        p.x = x;
+        // Ayak: hucre tabani, sekilli hucrede profil yuzeyi
+        float feet = (S.row + 1) * t;
+        const float left = x - m_halfW + 1.f, right = x + m_halfW - 1.f;
+        for (int tx = (int)std::floor(left / t); tx <= (int)std::floor(right / t); ++tx)
+            if (map.anyInRow(S.row, tx, tx, Tilemap::MASK_SHAPED))
+                feet = std::min(feet, map.shapeTop(tx, S.row, left, right));
+        p.y = feet - m_halfH - 0.01f;
+        p.onGround = true;
+        integrate(p, map, m_pp, SIM_DT, false, false, false, false, false);
+        if (!p.onGround || surfaceUnder(p) != from) return false; // dar/kapali kalkis noktasi
+        x = p.x;
+
+        const int frames = (int)(SIM_MAX_T / SIM_DT);
+        const float yMax = (float)(m_rows + 2) * t;
+        bool air = false;
+        for (int f = 0; f < frames; ++f) {
+            const bool jump = (kind == NavEdge::Jump || kind == NavEdge::ShortJump || kind == NavEdge::DropThrough) && f == 0;
+            const bool held = kind == NavEdge::Jump || (kind == NavEdge::ShortJump && f < SHORT_JUMP_FRAMES);
+            integrate(p, map, m_pp, SIM_DT, dir < 0, dir > 0, jump, held, kind == NavEdge::DropThrough && f == 0);
+            if (!p.onGround) {
+                air = true;
+                if (p.y > yMax) return false;
+                continue;
+            }
+            const int u = surfaceUnder(p);
+            if (u >= 0 && u != from) {
+                e.to = u;
+                e.kind = (kind == NavEdge::Walk && air) ? (uint8_t)NavEdge::Fall : kind;
+                e.dir = (int8_t)dir;
+                e.fromX = x; e.toX = p.x;
+                e.time = (f + 1) * SIM_DT;
+                return true;
+            }
+            // ayni yuzeye geri indi ya da duvara dayandi
+            if (air || (f > 2 && p.vx == 0.f)) return false;
+        }
+        return false;
+    }
+
+    void NavGraph::buildEdges(const Tilemap& map, int id)
+    {
+        std::vector<NavEdge>& out = m_out[id];
+        out.clear();
+        const NavSurface S = m_surf[id];
+        const float t = (float)m_tile;
+        auto colX = [&](int tx) { return (tx + 0.5f) * t; };
+        NavEdge e;
+
+        // Uclardan disari yuru: egimle komsu yuzeye gecis ya da kenardan dusus
+        if (simulate(map, id, colX(S.tx0), -1, NavEdge::Walk, e)) out.push_back(e);
+        if (simulate(map, id, colX(S.tx1), +1, NavEdge::Walk, e)) out.push_back(e);
+
+        for (int tx = S.tx0; tx <= S.tx1; tx = (tx == S.tx1) ? tx + 1 : std::min(tx + JUMP_STRIDE, S.tx1)) {
+            for (int dir = -1; dir <= 1; ++dir) {
+                if (simulate(map, id, colX(tx), dir, NavEdge::Jump, e)) out.push_back(e);
+                if (simulate(map, id, colX(tx), dir, NavEdge::ShortJump, e)) out.push_back(e);
+            }
+            if (map.oneWayAtTile(tx, S.row + 1) && simulate(map, id, colX(tx), 0, NavEdge::DropThrough, e))
+                out.push_back(e);
+        }
+
+        // Ayni (hedef, tur, yon) icin birbirine DEDUP_TILES'tan yakin kalkislardan ilki kalir
+        std::sort(out.begin(), out.end(), [](const NavEdge& a, const NavEdge& b) {
+            if (a.to != b.to) return a.to < b.to;
+            if (a.kind != b.kind) return a.kind < b.kind;
+            if (a.dir != b.dir) return a.dir < b.dir;
+            return a.fromX < b.fromX;
+        });
+        size_t w = 0;
+        for (size_t i = 0; i < out.size(); ++i) {
+            if (w > 0) {
+                const NavEdge& k = out[w - 1];
+                if (k.to == out[i].to && k.kind == out[i].kind && k.dir == out[i].dir &&
+                    out[i].fromX - k.fromX < DEDUP_TILES * t) {
+                    if (out[i].time < k.time) out[w - 1] = out[i];
+                    continue;
+                }
+            }
+            out[w++] = out[i];
+        }
+        out.resize(w);
+    }
+
+    void NavGraph::reindex()
+    {
+        m_edgeBase.assign(m_surf.size(), 0);
+        m_flatOwner.clear();
+        int total = 0;
+        for (size_t s = 0; s < m_surf.size(); ++s) {
+            m_edgeBase[s] = total;
+            total += (int)m_out[s].size();
+            m_flatOwner.insert(m_flatOwner.end(), m_out[s].size(), (int)s);
+        }
+        m_edgeTotal = total;
+    }
+
+    void NavGraph::build(const Tilemap& map, const PhysicsParams& pp, float halfW, float halfH)
+    {
+        clear();
+        m_pp = pp; m_halfW = halfW; m_halfH = halfH;
+        m_cols = map.cols(); m_rows = map.rows(); m_tile = map.tileSize();
+        if (m_cols <= 0 || m_rows <= 0) return;
+        const float t = (float)m_tile;
+        m_clearRows = std::max(1, (int)std::ceil(2.f * halfH / t));
+        m_reachX = (int)std::ceil(pp.moveSpeed * SIM_MAX_T / t) + 2;
+        m_reachUp = (int)std::ceil(pp.jumpVel * pp.jumpVel / (2.f * pp.gravity) / t) + 2;
+        m_cell.assign((size_t)m_cols * m_rows, -1);
+
+        std::vector<NavSurface> runs;
+        for (int ty = 0; ty < m_rows; ++ty) {
+            rowRuns(map, ty, runs);
+            for (const NavSurface& s : runs) addSurface(s);
+        }
+        for (int id = 0; id < (int)m_surf.size(); ++id) buildEdges(map, id);
+        reindex();
+    }
+
+    void NavGraph::patch(const Tilemap& map, int tx0, int ty0, int tx1, int ty1)
+    {
+        if (map.cols() != m_cols || map.rows() != m_rows || map.tileSize() != m_tile) {
+            build(map, m_pp, m_halfW, m_halfH);
+            return;
+        }
+        // Hucre (tx,ty) yurunebilirligi kendisine, altina ve ustteki m_clearRows-1 satira bagli
+        const int r0 = std::max(0, ty0 - 1), r1 = std::min(m_rows - 1, ty1 + m_clearRows - 1);
+
+        // 1) satirlari yeniden bol; ayni kalan kosu id'sini korur
+        std::vector<char> killed(m_surf.size(), 0);
+        std::vector<NavSurface> fresh, runs;
+        for (int ty = r0; ty <= r1; ++ty) {
+            rowRuns(map, ty, runs);
+            for (int tx = 0; tx < m_cols; ++tx) {
+                const int id = m_cell[(size_t)ty * m_cols + tx];
+                if (id < 0) continue;
+                const NavSurface& s = m_surf[id];
+                const bool same = std::any_of(runs.begin(), runs.end(),
+                    [&](const NavSurface& r) { return r.tx0 == s.tx0 && r.tx1 == s.tx1; });
+                tx = s.tx1;
+                if (!same) { killSurface(id); killed[id] = 1; }
+            }
+            for (const NavSurface& r : runs)
+                if (m_cell[(size_t)ty * m_cols + r.tx0] < 0) fresh.push_back(r);
+        }
+
+        // 2) yeniden simule edilecekler: olu yuzeye kenari olanlar + menzili degisikligi kapsayanlar
+        std::vector<char> dirty(m_surf.size(), 0);
+        for (int s = 0; s < (int)m_surf.size(); ++s) {
+            const NavSurface& S = m_surf[s];
+            if (!S.alive) continue;
+            if (S.tx1 + m_reachX >= tx0 && S.tx0 - m_reachX <= tx1 && S.row - m_reachUp <= ty1) { dirty[s] = 1; continue; }
+            for (const NavEdge& e : m_out[s]) if (killed[e.to]) { dirty[s] = 1; break; }
+        }
+        for (int id = 0; id < (int)killed.size(); ++id) if (killed[id]) m_free.push_back(id);
+
+        // 3) yeni kosular
+        for (const NavSurface& r : fresh) {
+            const int id = addSurface(r);
+            if (id >= (int)dirty.size()) dirty.resize(id + 1, 0);
+            dirty[id] = 1;
+        }
+        for (int id = 0; id < (int)dirty.size(); ++id) if (dirty[id]) buildEdges(map, id);
+        reindex();
+    }
+
+    bool NavGraph::findPath(int from, float fromX, int to, float toX, std::vector<NavStep>& out) const
+    {
+        out.clear();
+        if (from < 0 || to < 0 || from >= (int)m_surf.size() || to >= (int)m_surf.size()) return false;
+        if (!m_surf[from].alive || !m_surf[to].alive) return false;
+
+        Scratch& sc = t_scratch;
+        sc.prepare(2 + (size_t)m_edgeTotal);
+        const float invSpeed = 1.f / std::max(1.f, m_pp.moveSpeed);
+
+        // durum -> (yuzey, x)
+        auto edgeOf = [&](int v) -> const NavEdge& {
+            const int s = m_flatOwner[v - 2];
+            return m_out[s][v - 2 - m_edgeBase[s]];
+        };
+        auto relax = [&](int v, float c, int u, float x) {
+            if (sc.stamp[v] == sc.gen && sc.g[v] <= c) return;
+            sc.stamp[v] = sc.gen; sc.g[v] = c; sc.parent[v] = u;
+            // yatay mesafe / yurume hizi: hicbir gecis yatayda daha hizli degil (kabul edilebilir)
+            sc.heap.emplace_back(-(c + std::fabs(x - toX) * invSpeed), v);
+            std::push_heap(sc.heap.begin(), sc.heap.end());
+        };
+
+        relax(START, 0.f, -1, fromX);
+        bool found = false;
+        while (!sc.heap.empty()) {
+            std::pop_heap(sc.heap.begin(), sc.heap.end());
+            const auto [negF, u] = sc.heap.back();
+            sc.heap.pop_back();
+            if (u == GOAL) { found = true; break; }
+            int su; float xu;
+            if (u == START) { su = from; xu = fromX; }
+            else { const NavEdge& e = edgeOf(u); su = e.to; xu = e.toX; }
+            if (-negF > sc.g[u] + std::fabs(xu - toX) * invSpeed + 1e-4f) continue; // eski kayit
+
+            if (su == to) relax(GOAL, sc.g[u] + std::fabs(xu - toX) * invSpeed, u, toX);
+            const std::vector<NavEdge>& es = m_out[su];
+            for (int k = 0; k < (int)es.size(); ++k) {
+                const NavEdge& e = es[k];
+                if (!m_surf[e.to].alive) continue;
+                relax(2 + m_edgeBase[su] + k, sc.g[u] + std::fabs(xu - e.fromX) * invSpeed + e.time, u, e.toX);
+            }
+        }
+        if (!found) return false;
+
+        for (int v = sc.parent[GOAL]; v != START; v = sc.parent[v]) {
+            const NavEdge& e = edgeOf(v);
+            NavStep st;
+            st.from = m_flatOwner[v - 2]; st.to = e.to;
+            st.kind = e.kind; st.dir = e.dir;
+            st.fromX = e.fromX; st.toX = e.toX;
+            out.push_back(st);
+        }
+        std::reverse(out.begin(), out.end());
+        NavStep last;
+        last.from = last.to = to;
+        last.fromX = last.toX = toX;
+        out.push_back(last);
+        return true;
+    }
+
+    int NavGraph::findPaths(const Query* q, int count, std::vector<NavStep>* out) const
+    {
+        int found = 0;
+        for (int i = 0; i < count; ++i) {
+            const int a = surfaceAt(q[i].fromX, q[i].fromY);
+            const int b = surfaceAt(q[i].toX, q[i].toY);
+            if (a >= 0 && b >= 0 && findPath(a, q[i].fromX, b, q[i].toX, out[i])) ++found;
+            else out[i].clear();
+        }
+        return found;
+    }
+
+    void NavGraph::drawDebug(Renderer2D& r2d) const
+    {
+        int vw, vh; r2d.outputSize(vw, vh);
+        const Camera2D& cam = r2d.camera();
+        const float t = (float)m_tile;
+        const float x0 = cam.x, y0 = cam.y, x1 = cam.x + vw / cam.zoom, y1 = cam.y + vh / cam.zoom;
+        for (size_t s = 0; s < m_surf.size(); ++s) {
+            const NavSurface& S = m_surf[s];
+            if (!S.alive) continue;
+            const float sy = (S.row + 1) * t, sx0 = S.tx0 * t, sx1 = (S.tx1 + 1) * t;
+            if (sx1 < x0 || sx0 > x1 || sy < y0 || sy - t > y1) continue;
+            r2d.fillRect(sx0, sy - 3.f, sx1 - sx0, 3.f, SDL_Color{ 80,220,120,160 });
+            for (const NavEdge& e : m_out[s]) {
+                static const SDL_Color kc[] = { { 80,220,120,255 }, { 120,160,255,255 },
+                    { 255,200,60,255 }, { 255,140,60,255 }, { 200,100,255,255 } };
+                r2d.fillRect(e.fromX - 2.f, sy - 8.f, 4.f, 5.f, kc[e.kind]);
+            }
+        }
+    }
+
+} // namespace Erlik
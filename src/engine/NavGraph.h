@@ -0,0 +1,94 @@
+#pragma once
+#include "Physics.h"
+#include <cstdint>
+#include <vector>
+
+namespace Erlik {
+
+    class Renderer2D;
+
+    // Yurunebilir yuzey: ayni satirda kesintisiz zemin kosusu, tile biriminde [tx0,tx1].
+    // 'row' govdenin ayak hucresinin satiri (zeminin bir ustu; sekilli hucrede kendisi).
+    struct NavSurface {
+        int  row = 0, tx0 = 0, tx1 = -1;
+        bool alive = false;
+    };
+
+    // Yuzeyler arasi gecis: fromX'e yuru, eylemi 'dir' yonunu tutarak yap, 'to' uzerinde toX'e in.
+    struct NavEdge {
+        enum Kind : uint8_t { Walk, Fall, Jump, ShortJump, DropThrough };
+        int     to = -1;
+        uint8_t kind = Walk;
+        int8_t  dir = 0;                 // -1 / 0 / +1
+        float   fromX = 0.f, toX = 0.f;  // govde merkezi (world px)
+        float   time = 0.f;              // gecis suresi (s), kalkisa kadar yurume haric
+    };
+
+    // Yol adimi: 'from' uzerinde fromX'e yuru, sonra kind/dir ile 'to'ya gec.
+    // Son adim hedef yuzeyde yurumedir (kind = Walk, from == to, fromX == toX = hedef).
+    struct NavStep {
+        int     from = -1, to = -1;
+        uint8_t kind = NavEdge::Walk;
+        int8_t  dir = 0;
+        float   fromX = 0.f, toX = 0.f;
+    };
+
+    // Platformer navigasyon grafi. Dugumler yuzeyler; kenarlar yukleme aninda gercek
+    // kontrolcunun (integrate + PhysicsParams) simulasyonuyla bulunur: kenardan yuru/dus,
+    // iki guclu ziplama x uc yon, one-way'den drop-through. Sorgular sadece bu graf uzerinde
+    // A* (maliyet = sure); ajan basina ziplama simulasyonu yok.
+    class NavGraph {
+    public:
+        void build(const Tilemap& map, const PhysicsParams& pp, float halfW = 12.f, float halfH = 16.f);
+        // [tx0,tx1]x[ty0,ty1] hucreleri degisti (Tilemap zaten guncel): etkilenen satirlar yeniden
+        // bolunur, erisim menzilindeki yuzeylerin kenarlari yeniden simule edilir.
+        void patch(const Tilemap& map, int tx0, int ty0, int tx1, int ty1);
+        void clear();
+
+        int  surfaceSlots() const { return (int)m_surf.size(); } // olu slotlar dahil
+        int  surfaceCount() const { return m_alive; }
+        int  edgeCount() const { return m_edgeTotal; }
+        const NavSurface& surface(int id) const { return m_surf[id]; }
+        const std::vector<NavEdge>& edges(int id) const { return m_out[id]; }
+
+        // Ayak noktasinin (x, alt kenar y) bulundugu yuzey, yoksa -1
+        int surfaceAt(float x, float feetY) const;
+
+        // En kisa sureli yol; bulunamazsa false (out bos)
+        bool findPath(int from, float fromX, int to, float toX, std::vector<NavStep>& out) const;
+        // Toplu sorgu (ayak noktalari): scratch bir kez hazirlanir, out[i] bos = yol yok.
+        struct Query { float fromX, fromY, toX, toY; };
+        int  findPaths(const Query* q, int count, std::vector<NavStep>* out) const; // bulunan yol sayisi
+
+        // Debug: gorunur yuzeyler + kalkis/inis noktalari
+        void drawDebug(Renderer2D& r2d) const;
+
+    private:
+        bool walkable(const Tilemap& map, int tx, int ty) const;
+        void rowRuns(const Tilemap& map, int ty, std::vector<NavSurface>& out) const;
+        int  addSurface(const NavSurface& s);
+        void killSurface(int id);
+        void buildEdges(const Tilemap& map, int id);
+        bool simulate(const Tilemap& map, int from, float x, int dir, uint8_t kind, NavEdge& e) const;
+        int  surfaceUnder(const Player& p) const;
+        void reindex();
+
+        PhysicsParams m_pp;
+        float m_halfW = 12.f, m_halfH = 16.f;
+        int   m_cols = 0, m_rows = 0, m_tile = 32;
+        int   m_clearRows = 1;          // govde yuksekligi (tile)
+        int   m_reachX = 0, m_reachUp = 0; // patch: kenarlari etkilenebilecek yuzey menzili (tile)
+
+        std::vector<NavSurface> m_surf;
+        std::vector<std::vector<NavEdge>> m_out;
+        std::vector<int> m_free;        // olu slotlar (patch yeniden kullanir)
+        std::vector<int> m_cell;        // cols*rows -> yuzey id, yoksa -1
+        int   m_alive = 0;
+
+        // A* durum indeksleri: 2 + m_edgeBase[s] + k = s'nin k. kenariyla varis
+        std::vector<int> m_edgeBase;
+        std::vector<int> m_flatOwner;   // durum -> kaynak yuzey
+        int   m_edgeTotal = 0;
+    };
+
+} // namespace Erlik
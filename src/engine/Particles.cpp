@@ -1,26 +1,185 @@
 #include "Particles.h"
 #include "Renderer2D.h"
+#include "Decals.h"
+#include "Tilemap.h"
 #include <cmath>
 
 namespace Erlik {
 
+    // Kalici iz: ayni renkte, soluk, zemine yapisik kucuk leke
+    void ParticleSystem::deposit(const Particle& p, float groundY)
+    {
+        if (!p.deposit || !m_decals) return;
+        const float w = p.size * 1.2f, h = std::max(1.5f, p.size * 0.35f);
+        m_decals->stamp(p.x - w * 0.5f, groundY - h * 0.5f, w, h, SDL_Color{ 150, 145, 135, 70 });
+    }
+
+    void ParticleSystem::init(int cap)
+    {
+        m_cap = std::max(1, cap);
+        m_pool.assign(m_cap, Particle{});
+        m_next = 0;
+        m_awake.clear(); m_awake.reserve(m_cap);
+        m_asleep.clear(); m_asleep.reserve(m_cap);
+        m_sleepClock = 0.f;
+    }
+
+    void ParticleSystem::clear()
+    {
+        for (auto& p : m_pool) { p.alive = false; p.list = LIST_NONE; }
+        m_next = 0;
+        m_awake.clear(); m_asleep.clear();
+        m_sleepClock = 0.f;
+    }
+
+    int ParticleSystem::aliveCount() const
+    {
+        int n = 0;
+        for (const auto& p : m_pool) n += p.alive ? 1 : 0;
+        return n;
+    }
+
     void ParticleSystem::update(float dt)
     {
         const float baseGravity = 900.f;
+        const bool collide = m_map && m_map->cols() > 0;
+        if (collide && (int)m_hitIdx.size() < m_cap) {
+            m_hitIdx.resize(m_cap); m_ox.resize(m_cap); m_oy.resize(m_cap);
+            m_nx.resize(m_cap); m_ny.resize(m_cap); m_mask.resize(m_cap);
+        }
+        int n = 0;
+        m_sleepClock += dt;
 
-        for (int i = 0; i < m_cap; ++i) {
+        // Sirasiz silme (swap-pop): collide() indeksleri m_hitIdx'ten okur, sira onemsiz
+        for (size_t k = 0; k < m_awake.size();) {
+            const int i = m_awake[k];
             auto& p = m_pool[i];
-            if (!p.alive) continue;
+            if (!p.alive) { // onceki karede collide() oldurdu
+                p.list = LIST_NONE;
+                m_awake[k] = m_awake.back(); m_awake.pop_back();
+                continue;
+            }
 
             p.life += dt;
-            if (p.life >= p.maxLife) { p.alive = false; continue; }
+            const bool asleep = p.x < m_ax0 || p.x > m_ax1 || p.y < m_ay0 || p.y > m_ay1;
+            if (p.life >= p.maxLife || asleep) {
+                if (asleep) {
+                    p.list = LIST_ASLEEP;
+                    p.sleptAt = m_sleepClock;
+                    m_asleep.push_back(i);
+                }
+                else {
+                    p.alive = false;
+                    p.list = LIST_NONE;
+                    deposit(p, p.groundY);
+                }
+                m_awake[k] = m_awake.back(); m_awake.pop_back();
+                continue;
+            }
+            ++k;
 
             // Integrate
             p.vx *= std::max(0.f, 1.f - p.drag * dt);
             p.vy += baseGravity * p.gravityScale * dt;
 
+            const float ox = p.x, oy = p.y;
             p.x += p.vx * dt;
             p.y += p.vy * dt;
+            if (collide && p.hit != ParticleHit::None) {
+                m_hitIdx[n] = i; m_ox[n] = ox; m_oy[n] = oy; m_nx[n] = p.x; m_ny[n] = p.y; ++n;
+            }
+        }
+        if (n > 0) this->collide(n, dt);
+        if (m_sleepClock >= SLEEP_SWEEP) sweepSleepers();
+    }
+
+    // Uyuyanlar: gecen sure toplu eklenir; olenler iz birakmaz, aktif kutuya girenler uyanir.
+    void ParticleSystem::sweepSleepers()
+    {
+        size_t w = 0;
+        for (size_t k = 0; k < m_asleep.size(); ++k) {
+            const int i = m_asleep[k];
+            Particle& p = m_pool[i];
+            if (p.list != LIST_ASLEEP) continue; // bayat ya da bu taramada goruldu
+
+            p.life += m_sleepClock - p.sleptAt;
+            if (!p.alive || p.life >= p.maxLife) {
+                p.alive = false;
+                p.list = LIST_NONE;
+                continue;
+            }
+            if (p.x >= m_ax0 && p.x <= m_ax1 && p.y >= m_ay0 && p.y <= m_ay1) {
+                p.list = LIST_AWAKE;
+                m_awake.push_back(i);
+                continue;
+            }
+            p.list = LIST_SWEPT;
+            p.sleptAt = 0.f;
+            m_asleep[w++] = i;
+        }
+        m_asleep.resize(w);
+        for (int i : m_asleep) m_pool[i].list = LIST_ASLEEP;
+        m_sleepClock = 0.f;
+    }
+
+    // Partikul nokta kabul edilir ve kare basina bir hucreden az ilerledigi varsayilir
+    // (900 px/s^2 ile ~1 sn dususte bile 15 px/kare < tile).
+    void ParticleSystem::collide(int n, float dt)
+    {
+        m_map->pointMasks(m_nx.data(), m_ny.data(), n, m_mask.data());
+
+        const float tile = (float)m_map->tileSize();
+        const float inv = 1.f / tile;
+        for (int k = 0; k < n; ++k) {
+            const uint8_t m = m_mask[k];
+            if (!m) continue;
+            Particle& p = m_pool[m_hitIdx[k]];
+            const float ox = m_ox[k], oy = m_oy[k];
+            const int tx = (int)std::floor(p.x * inv), ty = (int)std::floor(p.y * inv);
+
+            bool hitX = false, hitY = false;
+            float floorY = ty * tile; // ustten inince oturulacak yuzey
+            if (m & Tilemap::MASK_SOLID) {
+                // hangi eksenden girdi: eski x ile yeni y / yeni x ile eski y
+                const bool yBlock = m_map->solidAtTile((int)std::floor(ox * inv), ty);
+                const bool xBlock = m_map->solidAtTile(tx, (int)std::floor(oy * inv));
+                hitY = yBlock || !xBlock;
+                hitX = xBlock || !yBlock;
+            }
+            else if (m & Tilemap::MASK_ONEWAY) {
+                hitY = p.vy > 0.f && oy <= floorY;
+            }
+            else { // sekilli: profil yuzeyinin altina girdiyse zemin
+                floorY = m_map->shapeTop(tx, ty, p.x, p.x);
+                hitY = p.y >= floorY && p.vy > 0.f;
+            }
+            if (!hitX && !hitY) continue;
+            const bool onFloor = hitY && p.vy > 0.f;
+
+            switch (p.hit) {
+            case ParticleHit::Die:
+                p.alive = false;
+                if (onFloor) deposit(p, floorY); // iz temas noktasina
+                continue;
+            case ParticleHit::Bounce:
+                if (hitX) { p.x = ox; p.vx = -p.vx * m_restitution; }
+                if (hitY) {
+                    p.y = onFloor ? floorY - 0.01f : oy;
+                    p.vy = -p.vy * m_restitution;
+                    if (onFloor && p.vy > -20.f) p.vy = 0.f; // yerde titremesin
+                }
+                break;
+            case ParticleHit::Slide:
+                if (hitX) { p.x = ox; p.vx = 0.f; }
+                if (hitY) {
+                    p.y = onFloor ? floorY - 0.01f : oy;
+                    p.vy = 0.f;
+                    if (onFloor) p.vx *= std::max(0.f, 1.f - 8.f * dt); // zemin surtunmesi
+                }
+                break;
+            default: break;
+            }
+            if (onFloor) p.groundY = floorY;
         }
     }
 
@@ -38,19 +197,25 @@ namespace Erlik {
         }
     }
 
-    void ParticleSystem::emitFootDust(float x, float y, int count, float dir)
+    void ParticleSystem::emitFootDust(float x, float y, int count, float dir, ParticleHit hit)
     {
-        emitDust(x, y, count, dir, 80.f);
+        emitDust(x, y, count, dir, 80.f, 0.3f, hit);
     }
 
-    void ParticleSystem::emitDust(float x, float y, int count, float dir, float baseSpeed)
+    void ParticleSystem::emitDust(float x, float y, int count, float dir, float baseSpeed, float depositChance,
+        ParticleHit hit)
     {
         dir = (dir >= 0.f) ? 1.f : -1.f;
         for (int i = 0; i < count; ++i) {
-            Particle& p = m_pool[m_next];
+            const int slot = m_next;
+            Particle& p = m_pool[slot];
             m_next = (m_next + 1) % m_cap;
 
             p.alive = true;
+            if (p.list != LIST_AWAKE) { // uyku listesindeki girdi bayatlar
+                p.list = LIST_AWAKE;
+                m_awake.push_back(slot);
+            }
             p.x = x + frand(-2.f, 2.f);
             p.y = y + frand(-2.f, 2.f);
             p.vx = dir * (baseSpeed + frand(-20.f, 20.f));
@@ -65,6 +230,10 @@ namespace Erlik {
             p.drag = 6.0f;
 
             p.baseA = 210;
+
+            p.deposit = depositChance > 0.f && frand(0.f, 1.f) < depositChance;
+            p.hit = hit;
+            p.groundY = y;
         }
     }
 
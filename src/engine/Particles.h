@@ -1,10 +1,15 @@
 #pragma once
 #include <SDL.h>
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <vector>
 
 namespace Erlik {
 
+    // Tile grid'e carpinca ne olur (emitter basina secilir; None: carpisma yok)
+    enum class ParticleHit : uint8_t { None, Bounce, Slide, Die };
+
     struct Particle {
         float x = 0, y = 0, vx = 0, vy = 0, size = 6;
         float life = 0, maxLife = 0.5f;
@@ -12,25 +17,67 @@ namespace Erlik {
         float drag = 2.5f;           // horizontal damping
         Uint8  baseA = 255;
         bool   alive = false;
+        bool   deposit = false;      // olunce decal katmanina iz birakir
+        ParticleHit hit = ParticleHit::None;
+        float  groundY = 0.f;        // izin birakilacagi zemin (spawn y; carpismada temas y)
+        uint8_t list = 0;            // ParticleSystem: hangi indeks listesinde (uyanik/uyku)
+        float  sleptAt = 0.f;        // uykuya girdigi an (son uyku taramasina gore)
     };
 
     class Renderer2D; // fwd
+    class DecalLayer; // fwd
+    class Tilemap;    // fwd
 
     class ParticleSystem {
     public:
-        void init(int cap = 256) { m_cap = std::min(cap, MAX_CAP); clear(); }
-        void clear() { for (int i = 0; i < MAX_CAP; ++i) m_pool[i].alive = false; m_next = 0; }
+        ParticleSystem() { init(); }
+        void init(int cap = 256);
+        void clear();
+        int  capacity() const { return m_cap; }
+        int  aliveCount() const;
+        // Olen "deposit" partikuller bu katmana pisirilir (nullptr: kapali)
+        void setDecals(DecalLayer* d) { m_decals = d; }
+        // Carpisma haritasi (nullptr: hit modlari yok sayilir). Bounce: hiz * restitution ile yansir.
+        void setCollision(const Tilemap* map, float restitution = 0.35f) { m_map = map; m_restitution = restitution; }
+        // Aktif kutu disindaki partikuller uyur: hareket/carpisma/iz yok, update onlara hic
+        // dokunmaz. Yaslanma ve uyanma SLEEP_SWEEP saniyede bir toplu taramada telafi edilir.
+        // Varsayilan: sinirsiz.
+        void setActiveRect(float x0, float y0, float x1, float y1) { m_ax0 = x0; m_ay0 = y0; m_ax1 = x1; m_ay1 = y1; }
         void update(float dt);
         void draw(Renderer2D& r2d) const;
-        void emitFootDust(float x, float y, int count, float dir);
+        void emitFootDust(float x, float y, int count, float dir, ParticleHit hit = ParticleHit::None);
         // general dust burst  dir: +1 right, -1 left; baseSpeed: starting horizontal speed
-        void emitDust(float x, float y, int count, float dir, float baseSpeed);
+        // depositChance: partikulun olunce zeminde iz birakma olasiligi (0..1)
+        void emitDust(float x, float y, int count, float dir, float baseSpeed, float depositChance = 0.f,
+            ParticleHit hit = ParticleHit::None);
 
     private:
-        static constexpr int MAX_CAP = 256;
-        Particle m_pool[MAX_CAP];
-        int m_cap = MAX_CAP;
+        // Carpisma modlu partikuller toplu gecer: once tum yeni konumlar tek Tilemap::pointMasks
+        // cagrisiyla hucre maskesine cevrilir, sadece dolu hucreye girenler cozulur.
+        void collide(int n, float dt); // ilk n scratch girdisi
+        void deposit(const Particle& p, float groundY);
+        void sweepSleepers();
+
+        // Particle::list degerleri. SWEPT yalnizca tarama icinde tekrar girdileri ayiklar.
+        enum : uint8_t { LIST_NONE, LIST_AWAKE, LIST_ASLEEP, LIST_SWEPT };
+        static constexpr float SLEEP_SWEEP = 0.1f;
+
+        std::vector<Particle> m_pool;
+        int m_cap = 0;
         int m_next = 0;
+        // update yalnizca m_awake'i gezer. m_asleep bayat/tekrar girdi tasiyabilir
+        // (uyurken slotu yeniden emit edilen partikul); tarama list alanina bakip ayiklar.
+        std::vector<int> m_awake, m_asleep;
+        float m_sleepClock = 0.f;      // son uyku taramasindan beri gecen sure
+        DecalLayer* m_decals = nullptr;
+        const Tilemap* m_map = nullptr;
+        float m_restitution = 0.35f;
+        float m_ax0 = -1e30f, m_ay0 = -1e30f, m_ax1 = 1e30f, m_ay1 = 1e30f;
+
+        // collide() scratch: kapasite kadar bir kez ayrilir, update doldurur
+        std::vector<int>     m_hitIdx;
+        std::vector<float>   m_ox, m_oy, m_nx, m_ny;
+        std::vector<uint8_t> m_mask;
 
         static inline float frand(float a, float b) {
             return a + (b - a) * (float(std::rand()) / float(RAND_MAX));
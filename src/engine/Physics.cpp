@@ -1,14 +1,182 @@
 #include "Physics.h"
 #include "Tilemap.h"
+#include "Platforms.h"
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 namespace Erlik {
 
     static inline int tileFloor(float v, float tile) { return (int)std::floor(v / tile); }
 
+    // Satir r'de [left,right] araligindaki en yuksek yuzey (world y), yoksa +inf.
+    // Tam blok satirin ustudur; sekilli hucrelerde profil tablosu okunur.
+    static float rowSurface(const Tilemap& map, int r, float left, float right, uint8_t fullMask, float tile)
+    {
+        const int tx0 = tileFloor(left, tile), tx1 = tileFloor(right, tile);
+        if (map.anyInRow(r, tx0, tx1, fullMask)) return r * tile;
+        float top = INFINITY;
+        for (int c = map.firstInRow(r, tx0, tx1, Tilemap::MASK_SHAPED); c >= 0;
+             c = (c < tx1) ? map.firstInRow(r, c + 1, tx1, Tilemap::MASK_SHAPED) : -1)
+            top = std::min(top, map.shapeTop(c, r, left, right));
+        return top;
+    }
+
+    // Sutun c'nin [ty0,ty1] satirlarindaki en yuksek yuzey, x'te (world y), yoksa +inf.
+    // Ustten ilk dolu satir yeter: alt satirlarin yuzeyi hep daha asagidadir.
+    static float colSurface(const Tilemap& map, int c, int ty0, int ty1, float x, float tile)
+    {
+        const int r = map.scanRows(c, c, ty0, ty1, Tilemap::MASK_SOLID | Tilemap::MASK_SHAPED);
+        if (r < 0) return INFINITY;
+        return map.anyInRow(r, c, c, Tilemap::MASK_SOLID) ? r * tile : map.shapeTop(c, r, x, x);
+    }
+
+    // Yatay sweep: on kenarin gectigi sutunlar sirayla. Her sutunda girilen kenardaki yuzey
+    // yuksekligi tek sorguyla bulunur: 'climb' px'e kadarsa govde o kadar yukselir (basamak,
+    // egim girisi), daha yuksekse ya da yukselince kafa degiyorsa duvar.
+    static void sweepX(Player& p, const Tilemap& map, float dx, float tile, float eps, float climb)
+    {
+        if (dx == 0.f) return;
+        const int dir = (dx > 0.f) ? 1 : -1;
+        const float edge = (dir > 0) ? p.x + p.halfW : p.x - p.halfW;
+        const int c0 = tileFloor(edge, tile);
+        const int c1 = tileFloor(edge + dx, tile);
+
+        for (int c = c0; ; c += dir) {
+            const float bottom = p.y + p.halfH;
+            const float ex = (c == c0) ? edge : ((dir > 0) ? c * tile : (c + 1) * tile - 1.0f);
+            const int ty1 = tileFloor(bottom - 1.0f, tile); // inset
+            const float top = colSurface(map, c, tileFloor(p.y - p.halfH + 1.0f, tile), ty1, ex, tile);
+            const float lift = bottom - top;
+            bool blocked = lift > climb;
+            if (!blocked && lift > 0.f) {
+                // yukselmis govdenin satirlarinda daha yuksek bir sey var mi (kafa payi)
+                blocked = colSurface(map, c, tileFloor(p.y - p.halfH - lift + 1.0f, tile), ty1, ex, tile) < top;
+                if (!blocked) p.y -= lift + eps;
+            }
+            if (blocked) {
+                p.x = (dir > 0) ? c * tile - p.halfW - eps : (c + 1) * tile + p.halfW + eps;
+                p.vx = 0.f;
+                return;
+            }
+            if (c == c1) break;
+        }
+        p.x += dx;
+    }
+
+    // Dikey sweep: on kenarin gectigi satirlar (span sorgusu ile) sirayla.
+    // One-way sadece sweep basinda ustundeysek ve drop-through yokken sayilir.
+    // Asagi inerken sekilli hucrelerin yuzeyi profil tablosundan; 'climb' px'e kadar gomulmus
+    // yuzeye de inilir (egimde yukari yururken on kose egime girer).
+    static void sweepY(Player& p, const Tilemap& map, float dy, float tile, float eps, float climb)
+    {
+        if (dy == 0.f) return;
+        const int tx0 = tileFloor(p.x - p.halfW + 1.0f, tile); // inset
+        const int tx1 = tileFloor(p.x + p.halfW - 1.0f, tile);
+
+        if (dy > 0.f) { // aşağı
+            const float bottom0 = p.y + p.halfH;
+            const float left = p.x - p.halfW + 1.0f, right = p.x + p.halfW - 1.0f;
+            const int rFoot = tileFloor(bottom0, tile), r1 = tileFloor(bottom0 + dy, tile);
+            for (int r = tileFloor(bottom0 - climb, tile); r <= r1; ++r) {
+                r = map.scanRows(tx0, tx1, r, r1, Tilemap::MASK_ANY);
+                if (r < 0) break;
+                // Tam bloklar ayak satirindan itibaren (bottom0 satirin icindeyse de ustune oturur);
+                // ustteki satirlarda sadece sekilli yuzeyler
+                const bool onewayCounts = (p.dropTimer <= 0.f) && (bottom0 <= r * tile);
+                const uint8_t fullMask = (r < rFoot) ? 0 : (onewayCounts ? Tilemap::MASK_BLOCK : Tilemap::MASK_SOLID);
+                const bool full = fullMask && map.anyInRow(r, tx0, tx1, fullMask);
+                const float top = full ? r * tile : rowSurface(map, r, left, right, 0, tile);
+                if (!full && (top < bottom0 - climb || top > bottom0 + dy)) continue;
+                p.y = top - p.halfH - eps;
+                p.vy = 0.f;
+                p.onGround = true;
+                return;
+            }
+        }
+        else { // yukarı: sekilli hucrelerin alti duz, tavan gibi
+            const float top0 = p.y - p.halfH;
+            const int r = map.scanRows(tx0, tx1, tileFloor(top0, tile), tileFloor(top0 + dy, tile),
+                Tilemap::MASK_SOLID | Tilemap::MASK_SHAPED);
+            if (r >= 0) {
+                p.y = (r + 1) * tile + p.halfH + eps;
+                p.vy = 0.f;
+                return;
+            }
+        }
+        p.y += dy;
+    }
+
+    // Egimden inerken zemine yapis: ayagin [up, down] px yakinindaki en yuksek solid/sekilli
+    // yuzeye otur. Sadece haritada sekilli hucre varsa cagrilir.
+    static void followGround(Player& p, const Tilemap& map, float up, float down, float tile, float eps)
+    {
+        const float bottom = p.y + p.halfH;
+        const float left = p.x - p.halfW + 1.0f, right = p.x + p.halfW - 1.0f; // inset
+        const int tx0 = tileFloor(left, tile), tx1 = tileFloor(right, tile);
+        const int rB = tileFloor(bottom + down, tile);
+        for (int r = tileFloor(bottom - up, tile); r <= rB; ++r) {
+            r = map.scanRows(tx0, tx1, r, rB, Tilemap::MASK_SOLID | Tilemap::MASK_SHAPED);
+            if (r < 0) return;
+            const float top = rowSurface(map, r, left, right, Tilemap::MASK_SOLID, tile);
+            if (top < bottom - up) continue;
+            if (top > bottom + down) return;
+            p.y = top - p.halfH - eps;
+            p.vy = 0.f;
+            p.onGround = true;
+            return;
+        }
+    }
+
+    // Kinematik platform temasi (alt adim sonu, platform zamani t0 -> t1).
+    // Govdenin adim basindaki konumu (sx,sy) platformun t0 konumuyla karsilastirilir: ustundeyse
+    // inis (one-way dahil, drop-through yokken), degilse kati platform alttan/yandan iter.
+    // Birden cok platform ustune inilebiliyorsa en yuksegi secilir.
+    static void collidePlatforms(Player& p, const PlatformSet& ps, const std::vector<int>& cand,
+        double t0, double t1, float sx, float sy, float eps)
+    {
+        const float tol = 0.5f;
+        int   landId = -1;
+        float landTop = 0.f;
+        for (int id : cand) {
+            const KinematicPlatform& d = ps.get(id);
+            float ax, ay, x, y;
+            ps.positionAt(id, t0, ax, ay);
+            ps.positionAt(id, t1, x, y);
+            if (p.x + p.halfW <= x || p.x - p.halfW >= x + d.w) continue;
+            if (p.y + p.halfH < y || p.y - p.halfH >= y + d.h) continue;
+
+            if (sy + p.halfH <= ay + tol) { // ustten
+                if (d.oneWay && p.dropTimer > 0.f) continue;
+                if (landId < 0 || y < landTop) { landId = id; landTop = y; }
+                continue;
+            }
+            if (d.oneWay) continue;
+
+            if (sy - p.halfH >= ay + d.h - tol) { // alttan: kafa carpar
+                p.y = y + d.h + p.halfH + eps;
+                if (p.vy < 0.f) p.vy = 0.f;
+            }
+            else if (sx < ax + d.w * 0.5f) {      // soldan
+                p.x = x - p.halfW - eps;
+                if (p.vx > 0.f) p.vx = 0.f;
+            }
+            else {                                // sagdan
+                p.x = x + d.w + p.halfW + eps;
+                if (p.vx < 0.f) p.vx = 0.f;
+            }
+        }
+        if (landId >= 0) {
+            p.y = landTop - p.halfH - eps;
+            p.vy = 0.f;
+            p.onGround = true;
+            p.platform = landId;
+        }
+    }
+
     void integrate(Player& p, const Tilemap& map, const PhysicsParams& pp, float dt,
-        bool moveLeft, bool moveRight, bool jumpPressed, bool jumpHeld, bool dropRequest)
+        bool moveLeft, bool moveRight, bool jumpPressed, bool jumpHeld, bool dropRequest,
+        const PlatformSet* platforms)
     {
         const float tile = (float)map.tileSize();
         const float eps = 0.001f;
@@ -27,16 +195,19 @@ namespace Erlik {
             const int   rowUnder = (int)std::floor(bottom / tile);
             const int   tx0 = (int)std::floor((p.x - p.halfW + 1.0f) / tile);
             const int   tx1 = (int)std::floor((p.x + p.halfW - 1.0f) / tile);
-            for (int tx = tx0; tx <= tx1; ++tx) {
-                if (map.oneWayAtTile(tx, rowUnder)) { onewayUnder = true; break; }
-            }
+            onewayUnder = map.anyInRow(rowUnder, tx0, tx1, Tilemap::MASK_ONEWAY);
         }
 
+        // Binilen platform hala gecerli mi? (hot reload'da kume yeniden kurulur)
+        if (!platforms || p.platform >= platforms->count()) p.platform = -1;
+        if (p.platform >= 0 && platforms->get(p.platform).oneWay) onewayUnder = true;
+
         // Geçerli drop isteği: S+Jump ve zeminde ve altında one-way
         const bool doDrop = dropRequest && p.onGround && onewayUnder;
         if (doDrop) {
             p.dropTimer = pp.dropThroughTime;
             p.onGround = false;           // hemen serbest bırak
+            p.platform = -1;
             p.jumpBufferTimer = 0.f;      // bu framede jump’ı iptal et
             if (p.vy < 30.f) p.vy = 30.f; // aşağı doğru minik itki
         }
@@ -97,118 +268,84 @@ namespace Erlik {
 
 
 
-        // -------- STEP X --------
-        p.x += p.vx * dt;
+        // -------- HAREKET (swept + substep) --------
+        // Her eksen DDA ile sweep edilir (gecilen her sutun/satir kontrol edilir), boylece
+        // tek adimda tile'dan buyuk hareketler de tunnelling yapmaz. X-sonra-Y ayrimi capraz
+        // hareketlerde kose hatasi biraktigi icin, hizli govdelerde adim kucuk parcalara bolunur.
+        // Kinematik platformlar ayni dongude: binilen platformun alt adim hareketi once govdeye
+        // tasinir (carry, tile'lara karsi sweep edilerek), sonra platform temasi cozulur.
+        const bool wasGround = p.onGround;
+        p.onGround = false;
         {
-            float left = p.x - p.halfW;
-            float right = p.x + p.halfW;
-            float top = p.y - p.halfH + 1.0f;   // inset
-            float bottom = p.y + p.halfH - 1.0f;   // inset
-
-            if (p.vx > 0.f) {
-                int col = tileFloor(right, tile);
-                bool collided = false;
-
-                // küçük basamaklara tırman
-                for (int step = 0; step <= pp.stepMaxPixels; ++step) {
-                    int ty0 = tileFloor((top - step), tile);
-                    int ty1 = tileFloor((bottom - step), tile);
-                    collided = false;
-                    for (int ty = ty0; ty <= ty1; ++ty) {
-                        if (map.solidAtTile(col, ty)) { collided = true; break; }
-                    }
-                    if (!collided) { p.y -= (float)step; top -= (float)step; bottom -= (float)step; break; }
-                }
+            const float dist = std::max(std::fabs(p.vx), std::fabs(p.vy)) * dt;
+            const int n = std::clamp((int)std::ceil(dist / std::max(1.f, pp.maxSubstepPx)), 1, std::max(1, pp.maxSubsteps));
+            const float h = dt / (float)n;
 
-                if (collided) {
-                    float tileLeft = col * tile;
-                    p.x = tileLeft - p.halfW - eps;
-                    p.vx = 0.f;
-                }
+            // Aday platformlar: govdenin bu karede ulasabilecegi kutu (grid sorgusu, kare basina bir)
+            thread_local std::vector<int> cand;
+            cand.clear();
+            double pt0 = 0.0;
+            if (platforms && platforms->count() > 0) {
+                pt0 = platforms->time();
+                const float reach = dist + platforms->maxSpeed() * dt + 1.f;
+                platforms->query(p.x - p.halfW - reach, p.y - p.halfH - reach,
+                    p.x + p.halfW + reach, p.y + p.halfH + reach, cand);
+                if (p.platform >= 0 && !std::binary_search(cand.begin(), cand.end(), p.platform))
+                    p.platform = -1;
             }
-            else if (p.vx < 0.f) {
-                int col = tileFloor(left, tile);
-                bool collided = false;
-
-                for (int step = 0; step <= pp.stepMaxPixels; ++step) {
-                    int ty0 = tileFloor((top - step), tile);
-                    int ty1 = tileFloor((bottom - step), tile);
-                    collided = false;
-                    for (int ty = ty0; ty <= ty1; ++ty) {
-                        if (map.solidAtTile(col, ty)) { collided = true; break; }
-                    }
-                    if (!collided) { p.y -= (float)step; top -= (float)step; bottom -= (float)step; break; }
-                }
 
-                if (collided) {
-                    float tileRight = (col + 1) * tile;
-                    p.x = tileRight + p.halfW + eps;
-                    p.vx = 0.f;
+            const float climb = (float)pp.stepMaxPixels;
+            const bool shapes = map.hasShapes();
+            for (int i = 0; i < n; ++i) {
+                const double ta = pt0 + (double)h * i, tb = ta + h;
+                const float sx = p.x, sy = p.y;
+                const bool grounded = (i == 0) ? wasGround : p.onGround;
+                if (p.platform >= 0) { // carry
+                    float ax, ay, bx, by;
+                    platforms->positionAt(p.platform, ta, ax, ay);
+                    platforms->positionAt(p.platform, tb, bx, by);
+                    sweepX(p, map, bx - ax, tile, eps, climb);
+                    sweepY(p, map, by - ay, tile, eps, climb);
+                    p.platform = -1;
+                }
+                sweepX(p, map, p.vx * h, tile, eps, climb);
+                sweepY(p, map, p.vy * h, tile, eps, climb);
+                if (shapes && p.vy >= 0.f && p.platform < 0) {
+                    // egimde yurume: yukari egim on kosede climb + yol kadar, asagi egim yol kadar
+                    const float run = std::fabs(p.vx * h);
+                    followGround(p, map, run + climb, grounded ? run + pp.groundSnapDist : 0.f, tile, eps);
                 }
+                if (!cand.empty()) collidePlatforms(p, *platforms, cand, ta, tb, sx, sy, eps);
             }
         }
 
-        // -------- STEP Y --------
-        p.y += p.vy * dt;
-        p.onGround = false;
-        {
-            float left = p.x - p.halfW + 1.0f; // inset
-            float right = p.x + p.halfW - 1.0f; // inset
-            float top = p.y - p.halfH;
-            float bottom = p.y + p.halfH;
-            
-
-            int tx0 = tileFloor(left, tile);
-            int tx1 = tileFloor(right, tile);
-
-            if (p.vy > 0.f) { // aşağı
-                int row = tileFloor(bottom, tile);
-                for (int tx = tx0; tx <= tx1; ++tx) {
-                    bool solid = map.solidAtTile(tx, row);
-                    bool oneway = map.oneWayAtTile(tx, row);
-                    float tileTop = row * tile;
-                    float prevBottom = p.prevY + p.halfH;
-
-                    const bool onewayCounts = oneway && (p.dropTimer <= 0.f) && (prevBottom <= tileTop);
-                    if (solid || onewayCounts) {
-                        p.y = tileTop - p.halfH - eps;
-                        p.vy = 0.f;
-                        p.onGround = true;
-                        break;
-                    }
-                }
+        // -------- GROUND SNAP --------
+        if (!p.onGround && p.vy > 0.f) {
+            const float left = p.x - p.halfW + 1.0f; // inset
+            const float right = p.x + p.halfW - 1.0f; // inset
+            const float bottom = p.y + p.halfH;
+            const int tx0 = tileFloor(left, tile);
+            const int tx1 = tileFloor(right, tile);
 
-                // ground snap
-                if (!p.onGround) {
-                    float snap = pp.groundSnapDist;
-                    int rowSnap = tileFloor(bottom + snap, tile);
-                    for (int tx = tx0; tx <= tx1; ++tx) {
-                        bool solid = map.solidAtTile(tx, rowSnap);
-                        bool oneway = map.oneWayAtTile(tx, rowSnap);
-                        float tileTop = rowSnap * tile;
-                        float prevBottom = p.prevY + p.halfH;
-
-                        const bool onewayCounts = oneway && (p.dropTimer <= 0.f) && (prevBottom <= tileTop);
-                        if (solid || onewayCounts) {
-                            float dist = tileTop - bottom;
-                            if (dist >= 0.f && dist <= snap) {
-                                p.y += dist; p.vy = 0.f; p.onGround = true;
-                            }
-                            break;
-                        }
-                    }
-                }
-            }
-            else if (p.vy < 0.f) { // yukarı
-                int row = tileFloor(top, tile);
-                for (int tx = tx0; tx <= tx1; ++tx) {
-                    if (map.solidAtTile(tx, row)) {
-                        float tileBottom = (row + 1) * tile;
-                        p.y = tileBottom + p.halfH + eps;
-                        p.vy = 0.f;
-                        break;
-                    }
+            const float prevBottom = p.prevY + p.halfH;
+            // One-way sadece ustten gelirken ve drop-through yokken sayilir (satir bazinda sabit)
+            auto groundMask = [&](int row) -> uint8_t {
+                const bool onewayCounts = (p.dropTimer <= 0.f) && (prevBottom <= row * tile);
+                return onewayCounts ? Tilemap::MASK_BLOCK : Tilemap::MASK_SOLID;
+            };
+
+            // ayak altindaki snap mesafesi icindeki ilk zemin satiri
+            const float snap = pp.groundSnapDist;
+            const int rowFrom = tileFloor(bottom, tile) + 1, rowTo = tileFloor(bottom + snap, tile);
+            for (int r = rowFrom; r <= rowTo; ++r) {
+                r = map.scanRows(tx0, tx1, r, rowTo, Tilemap::MASK_BLOCK);
+                if (r < 0) break;
+                if (!map.anyInRow(r, tx0, tx1, groundMask(r))) continue; // sadece gecilebilir one-way
+                float d = r * tile - bottom;
+                if (d >= 0.f && d <= snap) {
+                    p.y += d; p.vy = 0.f; p.onGround = true;
                 }
+                break;
             }
         }
     }
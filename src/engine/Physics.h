@@ -3,6 +3,8 @@
 
 namespace Erlik {
 
+class PlatformSet;
+
 struct Player {
     float x=0.f, y=0.f;
     float vx=0.f, vy=0.f;
@@ -12,6 +14,7 @@ struct Player {
     float dropTimer = 0.f;        // one-way'i geçici olarak yok saymak için
     float coyoteTimer = 0.f, jumpBufferTimer = 0.f;
     bool jumpWasHeld = false; // önceki frame durumu
+    int  platform = -1;       // üstünde durduğu kinematik platform (-1 = yok)
 
 
 };
@@ -32,7 +35,11 @@ struct PhysicsParams {
     float coyoteTime = 0.10f;
     float jumpBufferTime = 0.12f;
     float groundSnapDist = 3.0f;
-    int   stepMaxPixels = 8;
+    int   stepMaxPixels = 8;       // basamak/egim girisinde tek sorguda tirmanilan en fazla yukseklik
+
+    // Swept hareket: kare basina yer degistirme bu kadar px'i asarsa alt adimlara bol
+    float maxSubstepPx = 16.f;  // ~yarim tile; X-sonra-Y kose hatasini sinirlar
+    int   maxSubsteps = 8;
 
     // Sürtünme
     float frictionGround = 20.f; // px/s sürtünme katsayısı
@@ -41,8 +48,10 @@ struct PhysicsParams {
 };
 
 // İMZA: jumpPressed + jumpHeld ++ dropRequest
+// platforms: kinematik platformlar (zamanı adım başı = platforms->time(); salt-okunur)
 void integrate(Player& p, const Tilemap& map, const PhysicsParams& pp, float dt,
-    bool moveLeft, bool moveRight, bool jumpPressed, bool jumpHeld, bool dropRequest);
+    bool moveLeft, bool moveRight, bool jumpPressed, bool jumpHeld, bool dropRequest,
+    const PlatformSet* platforms = nullptr);
 
 
 } // namespace Erlik
\ No newline at end of file
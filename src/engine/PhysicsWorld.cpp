@@ -0,0 +1,232 @@
+#include "PhysicsWorld.h"
+#include "Jobs.h"
+#include "Activity.h"
+#include <algorithm>
+
+namespace Erlik {
+
+    int PhysicsWorld::addBody(float x, float y, float halfW, float halfH)
+    {
+        int id;
+        if (!m_freeIds.empty()) { id = m_freeIds.back(); m_freeIds.pop_back(); }
+        else { id = (int)m_idToIndex.size(); m_idToIndex.push_back(-1); }
+
+        m_idToIndex[id] = (int)m_x.size();
+        m_indexToId.push_back(id);
+        m_x.push_back(x);        m_y.push_back(y);
+        m_vx.push_back(0.f);     m_vy.push_back(0.f);
+        m_halfW.push_back(halfW); m_halfH.push_back(halfH);
+        m_prevX.push_back(x);    m_prevY.push_back(y);
+        m_drop.push_back(0.f);   m_coyote.push_back(0.f); m_jumpBuf.push_back(0.f);
+        m_flags.push_back(0);    m_input.push_back(0);
+        m_platform.push_back(-1);
+        m_region.push_back(-1);
+
+        // yeni govde uyanik baslar: uyuyan kismin basina takasla
+        swapIndices(m_idToIndex[id], m_active);
+        ++m_active;
+        return id;
+    }
+
+    void PhysicsWorld::removeBody(int id)
+    {
+        if (!valid(id)) return;
+        int i = m_idToIndex[id];
+        if (i < m_active) {
+            // once uyanik kismin sonuna, boylece asagidaki swap-remove bolmeyi bozmaz
+            swapIndices(i, m_active - 1);
+            i = --m_active;
+        }
+        else if (m_region[i] >= 0 && m_region[i] < (int)m_sleepers.size()) {
+            auto& b = m_sleepers[m_region[i]];
+            b.erase(std::find(b.begin(), b.end(), id));
+        }
+        const int last = (int)m_x.size() - 1;
+
+        // swap-remove: son govdeyi bosalan yere tasi
+        auto mv = [&](auto& v) { v[i] = v[last]; v.pop_back(); };
+        mv(m_x); mv(m_y); mv(m_vx); mv(m_vy); mv(m_halfW); mv(m_halfH);
+        mv(m_prevX); mv(m_prevY); mv(m_drop); mv(m_coyote); mv(m_jumpBuf);
+        mv(m_flags); mv(m_input); mv(m_platform); mv(m_region);
+
+        const int movedId = m_indexToId[last];
+        m_indexToId[i] = movedId;
+        m_indexToId.pop_back();
+        if (movedId != id) m_idToIndex[movedId] = i;
+
+        m_idToIndex[id] = -1;
+        m_freeIds.push_back(id);
+        m_broad.remove(id);
+    }
+
+    void PhysicsWorld::clear()
+    {
+        for (auto* v : { &m_x, &m_y, &m_vx, &m_vy, &m_halfW, &m_halfH,
+                         &m_prevX, &m_prevY, &m_drop, &m_coyote, &m_jumpBuf }) v->clear();
+        m_flags.clear(); m_input.clear(); m_platform.clear(); m_region.clear();
+        m_indexToId.clear(); m_idToIndex.clear(); m_freeIds.clear();
+        m_active = 0;
+        for (auto& b : m_sleepers) b.clear();
+        m_broad.clear();
+    }
+
+    void PhysicsWorld::setContactsEnabled(bool on)
+    {
+        m_contacts = on;
+        if (!on) m_broad.clear();
+    }
+
+    Player PhysicsWorld::load(int i) const
+    {
+        Player p;
+        p.x = m_x[i];   p.y = m_y[i];
+        p.vx = m_vx[i]; p.vy = m_vy[i];
+        p.halfW = m_halfW[i]; p.halfH = m_halfH[i];
+        p.prevX = m_prevX[i]; p.prevY = m_prevY[i];
+        p.dropTimer = m_drop[i];
+        p.coyoteTimer = m_coyote[i];
+        p.jumpBufferTimer = m_jumpBuf[i];
+        p.onGround = (m_flags[i] & F_GROUND) != 0;
+        p.jumpWasHeld = (m_flags[i] & F_JUMP_WAS_HELD) != 0;
+        p.platform = m_platform[i];
+        return p;
+    }
+
+    void PhysicsWorld::store(int i, const Player& p)
+    {
+        m_x[i] = p.x;   m_y[i] = p.y;
+        m_vx[i] = p.vx; m_vy[i] = p.vy;
+        m_halfW[i] = p.halfW; m_halfH[i] = p.halfH;
+        m_prevX[i] = p.prevX; m_prevY[i] = p.prevY;
+        m_drop[i] = p.dropTimer;
+        m_coyote[i] = p.coyoteTimer;
+        m_jumpBuf[i] = p.jumpBufferTimer;
+        m_flags[i] = (uint8_t)((m_flags[i] & F_KEEP_AWAKE) | (p.onGround ? F_GROUND : 0) | (p.jumpWasHeld ? F_JUMP_WAS_HELD : 0));
+        m_platform[i] = p.platform;
+    }
+
+    void PhysicsWorld::step(const Tilemap& map, const PhysicsParams& pp, float dt, JobPool* pool, int grain)
+    {
+        // Her govde sadece kendi indeksine yazar, Tilemap ve platformlar salt-okunur: parcalar bagimsiz
+        m_platforms.build();
+        const PlatformSet* plats = m_platforms.count() > 0 ? &m_platforms : nullptr;
+        auto run = [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                Player p = load(i);
+                const uint8_t in = m_input[i];
+                integrate(p, map, pp, dt,
+                    (in & IN_LEFT) != 0, (in & IN_RIGHT) != 0,
+                    (in & IN_JUMP_PRESSED) != 0, (in & IN_JUMP_HELD) != 0, (in & IN_DROP) != 0, plats);
+                store(i, p);
+                m_input[i] = (uint8_t)(in & ~(IN_JUMP_PRESSED | IN_DROP)); // tek-kare bitler
+            }
+        };
+        if (pool) pool->parallelFor(m_active, grain, run);
+        else      run(0, m_active);
+        m_platforms.advance(dt);
+
+        if (m_contacts) {
+            const int n = m_active; // uyuyanlar uyurken broadphase'den cikarilir
+            for (int i = 0; i < n; ++i)
+                m_broad.set(m_indexToId[i], m_x[i] - m_halfW[i], m_y[i] - m_halfH[i],
+                    m_x[i] + m_halfW[i], m_y[i] + m_halfH[i]);
+            m_broad.update();
+        }
+    }
+
+    void PhysicsWorld::swapIndices(int a, int b)
+    {
+        if (a == b) return;
+        auto sw = [&](auto& v) { std::swap(v[a], v[b]); };
+        sw(m_x); sw(m_y); sw(m_vx); sw(m_vy); sw(m_halfW); sw(m_halfH);
+        sw(m_prevX); sw(m_prevY); sw(m_drop); sw(m_coyote); sw(m_jumpBuf);
+        sw(m_flags); sw(m_input); sw(m_platform); sw(m_region);
+        sw(m_indexToId);
+        m_idToIndex[m_indexToId[a]] = a;
+        m_idToIndex[m_indexToId[b]] = b;
+    }
+
+    void PhysicsWorld::setKeepAwake(int id, bool on)
+    {
+        int i = m_idToIndex[id];
+        if (on) {
+            if (i >= m_active) {
+                if (m_region[i] >= 0 && m_region[i] < (int)m_sleepers.size()) {
+                    auto& b = m_sleepers[m_region[i]];
+                    b.erase(std::find(b.begin(), b.end(), id));
+                }
+                wakeIndex(i, 0.f, nullptr, nullptr);
+                i = m_idToIndex[id];
+            }
+            m_flags[i] |= F_KEEP_AWAKE;
+        }
+        else m_flags[i] &= (uint8_t)~F_KEEP_AWAKE;
+    }
+
+    void PhysicsWorld::sleepIndex(int i, int region)
+    {
+        const int j = m_active - 1;
+        swapIndices(i, j);
+        --m_active;
+        const int id = m_indexToId[j];
+        m_region[j] = region;
+        m_input[j] = 0;
+        m_sleepers[region].push_back(id);
+        if (m_contacts) m_broad.remove(id);
+    }
+
+    void PhysicsWorld::wakeIndex(int i, float sleptFor, const Tilemap* map, const PhysicsParams* pp)
+    {
+        swapIndices(i, m_active);
+        i = m_active++;
+        m_region[i] = -1;
+        if (!map || sleptFor <= 0.f) return;
+
+        // Telafi: tam simulasyon yerine tek adim. Uzun uykuda dusus zaten maxFall'a oturur.
+        constexpr float kMaxCatchUp = 1.0f;
+        Player p = load(i);
+        if (p.platform >= 0 && p.platform < m_platforms.count()) {
+            float ax, ay, bx, by;
+            const double t = m_platforms.time();
+            m_platforms.positionAt(p.platform, t - sleptFor, ax, ay);
+            m_platforms.positionAt(p.platform, t, bx, by);
+            p.x += bx - ax; p.y += by - ay;
+            p.prevX = p.x;  p.prevY = p.y;
+        }
+        else if (!p.onGround) {
+            integrate(p, *map, *pp, std::min(sleptFor, kMaxCatchUp), false, false, false, false, false, nullptr);
+        }
+        else return;
+        store(i, p);
+    }
+
+    void PhysicsWorld::wakeAll()
+    {
+        while (m_active < bodyCount()) wakeIndex(m_active, 0.f, nullptr, nullptr);
+        for (auto& b : m_sleepers) b.clear();
+    }
+
+    void PhysicsWorld::syncActivity(const ActivityMap& act, const Tilemap& map, const PhysicsParams& pp)
+    {
+        if (act.version() != m_actVersion || (int)m_sleepers.size() != act.regionCount()) {
+            wakeAll(); // bolge id'leri gecersiz: herkes uyanik baslar, asagidaki tarama yeniden uyutur
+            m_sleepers.assign(act.regionCount(), {});
+            m_actVersion = act.version();
+        }
+        if (act.regionCount() == 0) return;
+
+        for (int r : act.woke()) {
+            const float slept = act.sleptFor(r);
+            for (int id : m_sleepers[r]) wakeIndex(m_idToIndex[id], slept, &map, &pp);
+            m_sleepers[r].clear();
+        }
+        for (int i = 0; i < m_active;) {
+            if (!(m_flags[i] & F_KEEP_AWAKE)) {
+                const int r = act.regionAt(m_x[i], m_y[i]);
+                if (!act.awake(r)) { sleepIndex(i, r); continue; } // i'ye takaslanan govde de bakilir
+            }
+            ++i;
+        }
+    }
+
+} // namespace Erlik
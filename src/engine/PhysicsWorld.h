@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Physics.h"
+#include "Broadphase.h"
+#include "Platforms.h"
+
+namespace Erlik {
+
+    class JobPool;
+    class ActivityMap;
+
+    // Govde girdileri (her kare controller/AI yazar; tek-kare bitler step sonrasi silinir)
+    enum BodyInput : uint8_t {
+        IN_LEFT = 1, IN_RIGHT = 2,
+        IN_JUMP_PRESSED = 4,   // tek kare
+        IN_JUMP_HELD = 8,
+        IN_DROP = 16,          // tek kare (asagi + ziplama)
+    };
+
+    // Cok govdeli fizik dunyasi. Govdeler SoA (structure-of-arrays) olarak saklanir;
+    // step() govdeleri parcalar halinde (JobPool varsa paralel) paylasilan Tilemap'e karsi
+    // integrate eder. Hareket kurallari tek yerde: integrate() (Physics.cpp) — oyuncu da
+    // ayni PhysicsParams ile buradaki govdelerden biridir.
+    // Id'ler kalicidir; silmede dense diziler swap-remove ile sikistirilir.
+    // Uyku: dense dizilerin [0, activeCount) kismi uyanik govdelerdir; uyuyanlar sona
+    // takaslanir ve bolge kovasinda bekler. step() ve temaslar sadece uyanik kismi gezer.
+    class PhysicsWorld {
+    public:
+        int  addBody(float x, float y, float halfW, float halfH);
+        void removeBody(int id);
+        void clear();
+
+        bool valid(int id) const { return id >= 0 && id < (int)m_idToIndex.size() && m_idToIndex[id] >= 0; }
+        int  bodyCount() const { return (int)m_x.size(); }
+        int  activeCount() const { return m_active; }
+        int  activeId(int i) const { return m_indexToId[i]; }   // i < activeCount()
+        bool awake(int id) const { return m_idToIndex[id] < m_active; }
+        // Oyuncu gibi govdeler bolgesi uyusa da uyumaz
+        void setKeepAwake(int id, bool on);
+
+        void    setInput(int id, uint8_t in) { m_input[m_idToIndex[id]] = in; }
+        uint8_t input(int id) const { return m_input[m_idToIndex[id]]; }
+
+        // AoS goruntusu: oyun kodu (teleport, respawn, HUD) icin tek govdeyi oku/yaz
+        Player body(int id) const { return load(m_idToIndex[id]); }
+        void   setBody(int id, const Player& p) { store(m_idToIndex[id], p); }
+        float  x(int id) const { return m_x[m_idToIndex[id]]; }
+        float  y(int id) const { return m_y[m_idToIndex[id]]; }
+
+        // grain: parca basina govde sayisi (kucuk dunyalarda worker'lar uyandirilmaz)
+        void step(const Tilemap& map, const PhysicsParams& pp, float dt,
+            JobPool* pool = nullptr, int grain = 256);
+
+        // Govde-govde temaslari (sort-and-sweep). Aciksa step() sonunda guncellenir.
+        void setContactsEnabled(bool on);
+        bool contactsEnabled() const { return m_contacts; }
+        const Broadphase& contacts() const { return m_broad; }
+
+        // Aktivite senkronu (step'ten once, ActivityMap::update'ten sonra):
+        // uyanan bolgelerin govdeleri geri alinir ve uyudugu sure tek adimda telafi edilir
+        // (havadakiler tek integrate ile duser, platformdakiler platformla tasinir);
+        // uyuyan bolgeye giren uyanik govdeler uyutulur. Maliyet: uyanik + uyanan govde sayisi.
+        void syncActivity(const ActivityMap& act, const Tilemap& map, const PhysicsParams& pp);
+        void wakeAll();
+
+        // Kinematik platformlar: step() icinde govdelerle birlikte cozulur (ride/carry, one-way,
+        // kati yanlar). Zaman step() sonunda dt kadar ilerler. clear() platformlara dokunmaz.
+        PlatformSet&       platforms() { return m_platforms; }
+        const PlatformSet& platforms() const { return m_platforms; }
+
+    private:
+        Player load(int i) const;
+        void   store(int i, const Player& p);
+        void   swapIndices(int a, int b);
+        void   sleepIndex(int i, int region);
+        void   wakeIndex(int i, float sleptFor, const Tilemap* map, const PhysicsParams* pp);
+
+        enum : uint8_t { F_GROUND = 1, F_JUMP_WAS_HELD = 2, F_KEEP_AWAKE = 4 };
+
+        // dense SoA
+        std::vector<float>   m_x, m_y, m_vx, m_vy, m_halfW, m_halfH;
+        std::vector<float>   m_prevX, m_prevY;
+        std::vector<float>   m_drop, m_coyote, m_jumpBuf;
+        std::vector<uint8_t> m_flags, m_input;
+        std::vector<int>     m_platform;   // binilen platform id (-1 = yok)
+        std::vector<int>     m_region;     // uyuyorsa bolgesi, uyanik -1
+        std::vector<int>     m_indexToId;
+
+        std::vector<int>     m_idToIndex;  // -1 = bos id
+        std::vector<int>     m_freeIds;
+
+        int m_active = 0;
+        std::vector<std::vector<int>> m_sleepers; // bolge -> uyuyan govde id'leri
+        uint32_t m_actVersion = 0;
+
+        bool       m_contacts = false;
+        Broadphase m_broad;
+
+        PlatformSet m_platforms;
+    };
+
+} // namespace Erlik
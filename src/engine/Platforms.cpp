@@ -0,0 +1,118 @@
+#include "Platforms.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Erlik {
+
+    int PlatformSet::add(const KinematicPlatform& p)
+    {
+        const int id = (int)m_defs.size();
+        m_defs.push_back(p);
+        m_range.push_back(Range{
+            std::min(p.x, p.toX), std::min(p.y, p.toY),
+            std::max(p.x, p.toX) + p.w, std::max(p.y, p.toY) + p.h });
+        m_len.push_back(std::hypot(p.toX - p.x, p.toY - p.y));
+        if (m_len.back() > 0.f) m_maxSpeed = std::max(m_maxSpeed, p.speed);
+        m_dirty = true;
+        return id;
+    }
+
+    void PlatformSet::clear()
+    {
+        m_defs.clear(); m_range.clear(); m_len.clear();
+        m_start.clear(); m_items.clear();
+        m_cols = m_rows = 0;
+        m_maxSpeed = 0.f;
+        m_dirty = false;
+        m_time = 0.0;
+    }
+
+    void PlatformSet::positionAt(int id, double t, float& x, float& y) const
+    {
+        const KinematicPlatform& p = m_defs[id];
+        const float len = m_len[id];
+        if (len <= 0.f || p.speed <= 0.f) { x = p.x; y = p.y; return; }
+
+        // ping-pong: u in [0,2) -> s in [0,1]
+        float u = (float)std::fmod(t * p.speed / len + p.phase, 2.0);
+        if (u < 0.f) u += 2.f;
+        const float s = (u <= 1.f) ? u : 2.f - u;
+        x = p.x + (p.toX - p.x) * s;
+        y = p.y + (p.toY - p.y) * s;
+    }
+
+    void PlatformSet::build()
+    {
+        if (!m_dirty) return;
+        m_dirty = false;
+        m_start.clear(); m_items.clear();
+        m_cols = m_rows = 0;
+        if (m_defs.empty()) return;
+
+        float x0 = m_range[0].x0, y0 = m_range[0].y0, x1 = m_range[0].x1, y1 = m_range[0].y1;
+        for (const Range& r : m_range) {
+            x0 = std::min(x0, r.x0); y0 = std::min(y0, r.y0);
+            x1 = std::max(x1, r.x1); y1 = std::max(y1, r.y1);
+        }
+        m_originX = x0; m_originY = y0;
+        m_cols = (int)std::floor((x1 - x0) / CELL_PX) + 1;
+        m_rows = (int)std::floor((y1 - y0) / CELL_PX) + 1;
+
+        auto cellSpan = [&](const Range& r, int& cx0, int& cy0, int& cx1, int& cy1) {
+            cx0 = (int)std::floor((r.x0 - m_originX) / CELL_PX);
+            cy0 = (int)std::floor((r.y0 - m_originY) / CELL_PX);
+            cx1 = std::min(m_cols - 1, (int)std::floor((r.x1 - m_originX) / CELL_PX));
+            cy1 = std::min(m_rows - 1, (int)std::floor((r.y1 - m_originY) / CELL_PX));
+        };
+
+        // iki gecis: say, sonra yerlestir
+        m_start.assign((size_t)m_cols * m_rows + 1, 0);
+        for (const Range& r : m_range) {
+            int cx0, cy0, cx1, cy1; cellSpan(r, cx0, cy0, cx1, cy1);
+            for (int cy = cy0; cy <= cy1; ++cy)
+                for (int cx = cx0; cx <= cx1; ++cx) ++m_start[(size_t)cy * m_cols + cx + 1];
+        }
+        for (size_t c = 1; c < m_start.size(); ++c) m_start[c] += m_start[c - 1];
+        m_items.resize(m_start.back());
+        std::vector<int> fill(m_start.begin(), m_start.end() - 1);
+        for (int id = 0; id < (int)m_range.size(); ++id) {
+            int cx0, cy0, cx1, cy1; cellSpan(m_range[id], cx0, cy0, cx1, cy1);
+            for (int cy = cy0; cy <= cy1; ++cy)
+                for (int cx = cx0; cx <= cx1; ++cx) m_items[fill[(size_t)cy * m_cols + cx]++] = id;
+        }
+    }
+
+    void PlatformSet::query(float x0, float y0, float x1, float y1, std::vector<int>& out) const
+    {
+        out.clear();
+        auto hit = [&](int id) {
+            const Range& r = m_range[id];
+            return r.x0 <= x1 && x0 <= r.x1 && r.y0 <= y1 && y0 <= r.y1;
+        };
+
+        if (m_dirty) { // build() oncesi: dogrusal tarama
+            for (int id = 0; id < (int)m_range.size(); ++id) if (hit(id)) out.push_back(id);
+            return;
+        }
+        if (m_cols == 0) return;
+
+        const int cx0 = std::max(0, (int)std::floor((x0 - m_originX) / CELL_PX));
+        const int cy0 = std::max(0, (int)std::floor((y0 - m_originY) / CELL_PX));
+        const int cx1 = std::min(m_cols - 1, (int)std::floor((x1 - m_originX) / CELL_PX));
+        const int cy1 = std::min(m_rows - 1, (int)std::floor((y1 - m_originY) / CELL_PX));
+        if (cx0 > cx1 || cy0 > cy1) return;
+
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const size_t c = (size_t)cy * m_cols + cx;
+                for (int k = m_start[c]; k < m_start[c + 1]; ++k)
+                    if (hit(m_items[k])) out.push_back(m_items[k]);
+            }
+        // birden cok hucreye yazilmis platformlar
+        if (cx0 != cx1 || cy0 != cy1) {
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        }
+    }
+
+} // namespace Erlik
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+
+namespace Erlik {
+
+    // Kinematik platform: A (x,y) ile B (toX,toY) arasinda sabit hizla gidip gelir.
+    // Konum sadece zamanin fonksiyonudur; kare basina guncellenecek durum yoktur.
+    struct KinematicPlatform {
+        float x = 0.f, y = 0.f, w = 96.f, h = 16.f; // A: sol-ust + boyut
+        float toX = 0.f, toY = 0.f;                 // B: sol-ust (A == B -> sabit)
+        float speed = 80.f;                         // px/s
+        float phase = 0.f;                          // 0..1: yolun neresinden baslar
+        bool  oneWay = true;                        // false: yanlar ve alt da kati
+    };
+
+    // Platform kumesi + statik uniform grid. Her platform hareket araliginin (A..B kutusu)
+    // degdigi hucrelere bir kez yazilir; platform hareket etse de grid degismez. Boylece
+    // sorgu maliyeti sadece govdenin yakinindaki platformlar kadardir.
+    class PlatformSet {
+    public:
+        int  add(const KinematicPlatform& p);   // id = ekleme sirasi
+        void clear();
+        int  count() const { return (int)m_defs.size(); }
+        const KinematicPlatform& get(int id) const { return m_defs[id]; }
+
+        // Simulasyon zamani (PhysicsWorld::step sonunda ilerler). double: platformlarin
+        // periyotlari farkli, ortak mod yok; float saatte saatler sonra alt adim farki kaybolur.
+        double time() const { return m_time; }
+        void   advance(float dt) { m_time += dt; }
+
+        // t anindaki sol-ust konum
+        void positionAt(int id, double t, float& x, float& y) const;
+        float maxSpeed() const { return m_maxSpeed; }
+
+        // add() sonrasi grid'i kur (step bunu cagirir; query'ler salt-okunur kalir)
+        void build();
+
+        // Hareket araligi [x0,x1]x[y0,y1] ile kesisen platformlar (tekrarsiz, artan id)
+        void query(float x0, float y0, float x1, float y1, std::vector<int>& out) const;
+
+    private:
+        struct Range { float x0, y0, x1, y1; };
+
+        std::vector<KinematicPlatform> m_defs;
+        std::vector<Range> m_range;      // id -> hareket araligi kutusu
+        std::vector<float> m_len;        // id -> A..B uzunlugu
+
+        // CSR grid: hucre c'nin platformlari m_items[m_start[c] .. m_start[c+1])
+        static constexpr float CELL_PX = 256.f;
+        float m_originX = 0.f, m_originY = 0.f;
+        int   m_cols = 0, m_rows = 0;
+        std::vector<int> m_start, m_items;
+        bool  m_dirty = false;
+
+        double m_time = 0.0;
+        float m_maxSpeed = 0.f;
+    };
+
+} // namespace Erlik
@@ -3,17 +3,112 @@
 
 namespace Erlik {
 
-void Renderer2D::clear(Uint8 r, Uint8 g, Uint8 b, Uint8 a){ SDL_SetRenderDrawColor(m_r,r,g,b,a); SDL_RenderClear(m_r); }
-void Renderer2D::present(){ SDL_RenderPresent(m_r); }
-void Renderer2D::outputSize(int& w, int& h) const { SDL_GetRendererOutputSize(m_r, &w, &h); }
+void Renderer2D::beginFrame() {
+    m_drawCalls = 0;
+    m_cmds.clear();
+    m_texIds.clear();
+    if (m_r) SDL_GetRendererOutputSize(m_r, &m_outW, &m_outH);
+}
+
+void Renderer2D::clear(Uint8 r, Uint8 g, Uint8 b, Uint8 a){
+    if (m_rec) { RenderCmd c; c.type = RenderCmd::Clear; c.color = SDL_Color{ r,g,b,a }; m_cmds.push_back(c); }
+    if (!m_r) return;
+    SDL_SetRenderDrawColor(m_r,r,g,b,a); SDL_RenderClear(m_r);
+}
+void Renderer2D::present(){ if (m_r) SDL_RenderPresent(m_r); }
+
+Uint16 Renderer2D::texId(SDL_Texture* tex) {
+    if (!tex) return 0;
+    for (size_t i = 0; i < m_texIds.size(); ++i)
+        if (m_texIds[i] == tex) return (Uint16)(i + 1);
+    m_texIds.push_back(tex);
+    return (Uint16)m_texIds.size();
+}
+
+void Renderer2D::setTextureAlpha(SDL_Texture* tex, Uint8 a) {
+    if (!tex) return;
+    if (m_rec) {
+        RenderCmd c; c.type = RenderCmd::Alpha; c.tex = texId(tex); c.color.a = a;
+        m_cmds.push_back(c);
+    }
+    if (m_r) SDL_SetTextureAlphaMod(tex, a);
+}
+
+// Tum texture blit'leri buradan gecer (kayit + SDL + sayac)
+void Renderer2D::quad(SDL_Texture* tex, const SDL_Rect* src, const SDL_FRect& dst, float rot, SDL_RendererFlip flip) {
+    if (m_rec) {
+        RenderCmd c; c.type = RenderCmd::Quad; c.tex = texId(tex); c.flip = (Uint8)flip;
+        if (src) c.src = *src;
+        c.dst = dst; c.rot = rot;
+        m_cmds.push_back(c);
+    }
+    if (m_r) {
+        SDL_FPoint center{ dst.w * 0.5f, dst.h * 0.5f };
+        SDL_RenderCopyExF(m_r, tex, src, &dst, rot, &center, flip);
+    }
+    m_drawCalls++;
+}
+
+// FNV-1a; alanlar tek tek beslenir (struct padding hash'e girmez)
+uint64_t Renderer2D::frameHash() const {
+    uint64_t h = 1469598103934665603ull;
+    auto feed = [&h](const void* p, size_t n) {
+        const unsigned char* b = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ull; }
+    };
+    for (const RenderCmd& c : m_cmds) {
+        feed(&c.type, 1); feed(&c.flip, 1); feed(&c.tex, 2);
+        feed(&c.src.x, 4); feed(&c.src.y, 4); feed(&c.src.w, 4); feed(&c.src.h, 4);
+        feed(&c.dst.x, 4); feed(&c.dst.y, 4); feed(&c.dst.w, 4); feed(&c.dst.h, 4);
+        feed(&c.rot, 4);
+        feed(&c.color.r, 1); feed(&c.color.g, 1); feed(&c.color.b, 1); feed(&c.color.a, 1);
+    }
+    return h;
+}
+void Renderer2D::outputSize(int& w, int& h) const {
+    if (m_vpActive) { w = m_vp.w; h = m_vp.h; return; }
+    if (m_outW > 0 && m_outH > 0) { w = m_outW; h = m_outH; return; }
+    w = h = 0;
+    if (m_r) SDL_GetRendererOutputSize(m_r, &w, &h);
+}
+
+void Renderer2D::beginViewport(const SDL_Rect& rect, const Camera2D& cam) {
+    if (m_vpActive) endViewport();
+    m_vpSavedCam = m_cam;
+    m_vp = rect;
+    m_vpActive = true;
+    // Clip rect viewport'a gore; disari tasan blit'ler kesilsin
+    SDL_Rect clip{ 0, 0, rect.w, rect.h };
+    if (m_rec) {
+        RenderCmd v; v.type = RenderCmd::Viewport; v.src = m_vp; m_cmds.push_back(v);
+        RenderCmd c; c.type = RenderCmd::Clip; c.src = clip; m_cmds.push_back(c);
+    }
+    if (m_r) {
+        SDL_RenderSetViewport(m_r, &m_vp);
+        SDL_RenderSetClipRect(m_r, &clip);
+    }
+    m_cam = cam;
+}
+
+void Renderer2D::endViewport() {
+    if (!m_vpActive) return;
+    if (m_rec) {
+        RenderCmd c; c.type = RenderCmd::Clip; m_cmds.push_back(c);
+        RenderCmd v; v.type = RenderCmd::Viewport; m_cmds.push_back(v);
+    }
+    if (m_r) {
+        SDL_RenderSetClipRect(m_r, nullptr);
+        SDL_RenderSetViewport(m_r, nullptr);
+    }
+    m_cam = m_vpSavedCam;
+    m_vpActive = false;
+}
 
 void Renderer2D::drawTexture(const Texture& tex, float cx, float cy, float scale, float rot) {
     if (!tex.sdl()) return;
     int w = (int)(tex.width() * scale * m_cam.zoom), h = (int)(tex.height() * scale * m_cam.zoom);
     SDL_FRect dst{ (cx - m_cam.x) * m_cam.zoom - w * 0.5f, (cy - m_cam.y) * m_cam.zoom - h * 0.5f, (float)w,(float)h };
-    SDL_FPoint center{ dst.w * 0.5f, dst.h * 0.5f };
-    SDL_RenderCopyExF(m_r, tex.sdl(), /*src*/nullptr, &dst, rot, &center, SDL_FLIP_NONE);
-    m_drawCalls++; // saya
+    quad(tex.sdl(), /*src*/nullptr, dst, rot, SDL_FLIP_NONE);
 }
 
 void Renderer2D::drawTextureRegion(const Texture& tex, const SDL_Rect& src,
@@ -22,40 +117,59 @@ void Renderer2D::drawTextureRegion(const Texture& tex, const SDL_Rect& src,
     if (!tex.sdl()) return;
     int w = (int)(src.w * scale * m_cam.zoom), h = (int)(src.h * scale * m_cam.zoom);
     SDL_FRect dst{ (cx - m_cam.x) * m_cam.zoom - w * 0.5f, (cy - m_cam.y) * m_cam.zoom - h * 0.5f, (float)w,(float)h };
-    SDL_FPoint center{ dst.w * 0.5f, dst.h * 0.5f };
-    SDL_RenderCopyExF(m_r, tex.sdl(), &src, &dst, rot, &center, flip);
-    m_drawCalls++; // saya
+    quad(tex.sdl(), &src, dst, rot, flip);
 }
 
 void Renderer2D::fillRect(float x, float y, float w, float h, SDL_Color color)
 {
-    SDL_BlendMode prev;
-    SDL_GetRenderDrawBlendMode(m_r, &prev);
-    
-    SDL_SetRenderDrawBlendMode(m_r, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(m_r, color.r, color.g, color.b, color.a);
-    
     SDL_FRect r{
         (x - m_cam.x) * m_cam.zoom,
         (y - m_cam.y) * m_cam.zoom,
         w * m_cam.zoom,
         h * m_cam.zoom
     };
-    SDL_RenderFillRectF(m_r, &r);
+    fillRectScreen(r, color);
+}
+
+void Renderer2D::fillRectScreen(const SDL_FRect& r, SDL_Color color) {
+    fillRectsScreen(&r, 1, color);
+}
+
+void Renderer2D::fillRectsScreen(const SDL_FRect* rects, int n, SDL_Color color) {
+    if (n <= 0) return;
     m_drawCalls++;
+    if (m_rec)
+        for (int i = 0; i < n; ++i) { RenderCmd c; c.type = RenderCmd::Rect; c.dst = rects[i]; c.color = color; m_cmds.push_back(c); }
+    if (!m_r) return;
+
+    SDL_BlendMode prev;
+    SDL_GetRenderDrawBlendMode(m_r, &prev);
+    SDL_SetRenderDrawBlendMode(m_r, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(m_r, color.r, color.g, color.b, color.a);
+    if (n == 1) SDL_RenderFillRectF(m_r, rects);
+    else        SDL_RenderFillRectsF(m_r, rects, n);
     SDL_SetRenderDrawBlendMode(m_r, prev);
 }
 
+void Renderer2D::drawTextureScreen(SDL_Texture* tex, const SDL_Rect* src, const SDL_FRect& dst) {
+    if (!tex) return;
+    quad(tex, src, dst, 0.f, SDL_FLIP_NONE);
+}
+
 
 void Renderer2D::drawGrid(int spacing, Uint8 r, Uint8 g, Uint8 b, Uint8 a){
     if(spacing<=0) return;
-    SDL_SetRenderDrawColor(m_r,r,g,b,a);
-    int w,h; SDL_GetRendererOutputSize(m_r,&w,&h);
+    if(m_r) SDL_SetRenderDrawColor(m_r,r,g,b,a);
+    int w,h; outputSize(w,h);
     const float left=m_cam.x, top=m_cam.y, right=m_cam.x + w/m_cam.zoom, bottom=m_cam.y + h/m_cam.zoom;
     const int startX=(int)std::floor(left/spacing)*spacing, startY=(int)std::floor(top/spacing)*spacing;
     const int maxX=(int)std::ceil(right), maxY=(int)std::ceil(bottom);
-    for(int x=startX;x<=maxX;x+=spacing){ float sx=(x-m_cam.x)*m_cam.zoom; SDL_RenderDrawLineF(m_r, sx,0.f, sx,(float)h); }
-    for(int y=startY;y<=maxY;y+=spacing){ float sy=(y-m_cam.y)*m_cam.zoom; SDL_RenderDrawLineF(m_r, 0.f,sy, (float)w,sy); }
+    auto line = [&](float x1, float y1, float x2, float y2) {
+        if (m_rec) { RenderCmd c; c.type = RenderCmd::Line; c.dst = SDL_FRect{ x1,y1,x2,y2 }; c.color = SDL_Color{ r,g,b,a }; m_cmds.push_back(c); }
+        if (m_r) SDL_RenderDrawLineF(m_r, x1,y1, x2,y2);
+    };
+    for(int x=startX;x<=maxX;x+=spacing){ float sx=(x-m_cam.x)*m_cam.zoom; line(sx,0.f, sx,(float)h); }
+    for(int y=startY;y<=maxY;y+=spacing){ float sy=(y-m_cam.y)*m_cam.zoom; line(0.f,sy, (float)w,sy); }
 }
 
 void Renderer2D::drawTextureSDL(SDL_Texture* tex, const SDL_Rect* src,
@@ -73,9 +187,7 @@ void Renderer2D::drawTextureSDL(SDL_Texture* tex, const SDL_Rect* src,
     (cy - m_cam.y) * m_cam.zoom - h * 0.5f,
     (float)w, (float)h
     };
-    SDL_FPoint center{ dst.w * 0.5f, dst.h * 0.5f };
-    SDL_RenderCopyExF(m_r, tex, src, &dst, rot, &center, flip);
-    m_drawCalls++;
+    quad(tex, src, dst, rot, flip);
 }
 
 } // namespace Erlik
\ No newline at end of file
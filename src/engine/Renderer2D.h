@@ -1,20 +1,54 @@
 #pragma once
 #include <SDL.h>
+#include <cstdint>
+#include <vector>
 #include "Texture.h"
 
 namespace Erlik {
 
 struct Camera2D { float x=0.f; float y=0.f; float zoom=1.f; };
 
+// Kayit edilen tek komut (recording / null backend). Pointer icermez; texture'lar
+// frame icinde ilk gorulme sirasina gore numaralanir, boylece hash calismalar arasi stabil.
+struct RenderCmd {
+    enum Type : Uint8 { Clear, Quad, Rect, Line, Viewport, Clip, Alpha };
+    Uint8     type = Clear;
+    Uint8     flip = 0;
+    Uint16    tex = 0;               // 0 = texture yok
+    SDL_Rect  src{ 0,0,0,0 };        // Quad: kaynak (0 boyut = tum texture), Viewport/Clip: rect
+    SDL_FRect dst{ 0,0,0,0 };        // ekran px; Line: x1,y1,x2,y2
+    float     rot = 0.f;
+    SDL_Color color{ 0,0,0,0 };      // Clear/Rect/Line rengi, Alpha: color.a
+};
+
 class Renderer2D {
 public:
     explicit Renderer2D(SDL_Renderer* r): m_r(r) {}
+    // Null backend: SDL'e hic dokunmaz, her seyi kaydeder (headless bench / CI)
+    Renderer2D(int outW, int outH): m_outW(outW), m_outH(outH), m_rec(true) {}
+
+    // SDL backend'inde cizime ek olarak komut akisini kaydet
+    void setRecording(bool on) { m_rec = on || !m_r; }
+    bool recording() const { return m_rec; }
+    bool isNull() const { return m_r == nullptr; }
+    const std::vector<RenderCmd>& commands() const { return m_cmds; }
+    // Bu frame'in (beginFrame'den beri) komut akisinin FNV-1a hash'i
+    uint64_t frameHash() const;
+    // Texture alpha mod'u (state degisimi olarak kaydedilir)
+    void setTextureAlpha(SDL_Texture* tex, Uint8 a);
+
     void clear(Uint8 r, Uint8 g, Uint8 b, Uint8 a=255);
     void present();
+    // Aktif viewport varsa onun boyutu, yoksa (frame basinda cache'lenen) cikis boyutu
     void outputSize(int& w, int& h) const;
     void fillRect(float x, float y, float w, float h, SDL_Color color);
+    // Ekran-px (kamera yok): HUD, overlay, minimap. Kayit ve sayac dunya cizimleriyle ayni;
+    // fillRectsScreen tek SDL cagrisi (n Rect komutu kaydeder)
+    void fillRectScreen(const SDL_FRect& r, SDL_Color color);
+    void fillRectsScreen(const SDL_FRect* rects, int n, SDL_Color color);
+    void drawTextureScreen(SDL_Texture* tex, const SDL_Rect* src, const SDL_FRect& dst);
     void drawTexture(const Texture&, float cx,float cy,float scale=1.f,float rotationDeg=0.f);
-    void beginFrame() { m_drawCalls = 0; }
+    void beginFrame();
     int  drawCalls() const { return m_drawCalls; }
 
     // imza SONUNA varsaylan flip eklendi
@@ -26,6 +60,12 @@ public:
 
     void setCamera(const Camera2D& c){ m_cam=c; }
     const Camera2D& camera() const { return m_cam; }
+
+    // Split-screen / PiP: ekran-px dikdortgeni + kendi kamerasi. Texture'lar, statik
+    // cache'ler ve draw list'ler viewport'lar arasinda paylasilir; sadece kamera/clip degisir.
+    void beginViewport(const SDL_Rect& rect, const Camera2D& cam);
+    void endViewport();
+    bool inViewport() const { return m_vpActive; }
     // SDL_Texture* dorudan izen yardmc (cache blit iin)
     void drawTextureSDL(SDL_Texture * tex,
         const SDL_Rect * src,
@@ -35,9 +75,20 @@ public:
         SDL_RendererFlip flip = SDL_FLIP_NONE);
 
 private:
+    void   quad(SDL_Texture* tex, const SDL_Rect* src, const SDL_FRect& dst, float rot, SDL_RendererFlip flip);
+    Uint16 texId(SDL_Texture* tex);
+
     SDL_Renderer* m_r = nullptr;
     Camera2D m_cam;
     int  m_drawCalls = 0;
+    int  m_outW = 0, m_outH = 0;   // frame basinda cache
+    bool     m_vpActive = false;
+    SDL_Rect m_vp{ 0,0,0,0 };
+    Camera2D m_vpSavedCam;
+
+    bool m_rec = false;
+    std::vector<RenderCmd>    m_cmds;
+    std::vector<SDL_Texture*> m_texIds;  // index+1 = id (frame basinda sifirlanir)
 };
 
 } // namespace Erlik
\ No newline at end of file
@@ -1,9 +1,20 @@
 #include "ResourceManager.h"
 #include <system_error>
 #include <iostream>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
 
 namespace Erlik {
 
+    ResourceManager::~ResourceManager() { stopNotify(); }
+
     std::optional<std::filesystem::file_time_type>
         ResourceManager::safe_mtime(const std::string& path) {
         std::error_code ec;
@@ -12,6 +23,16 @@ namespace Erlik {
         return t;
     }
 
+    void ResourceManager::fire(Entry& e) {
+        try {
+            e.reload();
+        }
+        catch (...) {
+            // Reload srasnda bir hata olursa sessiz gemeyelim
+            std::cerr << "[hotreload] reload callback threw for: " << e.path << "\n";
+        }
+    }
+
     void ResourceManager::track(const std::string& path, std::function<void()> reload) {
         // Eer zaten izleniyorsa gncelle
         for (auto& e : m_entries) {
@@ -27,41 +48,172 @@ namespace Erlik {
         e.reload = std::move(reload);
         e.firstInit = true;
         if (auto mt = safe_mtime(path)) e.lastWrite = *mt;
+
+        // Dosyanin kendisi degil ust dizini izlenir: rename ile degistirilen dosya yeni inode olur
+        if (!m_notifyTried) startNotify();
+        if (m_notifyFd >= 0) {
+            const std::filesystem::path p(path);
+            const std::string dir = p.has_parent_path() ? p.parent_path().string() : std::string(".");
+            e.name = p.filename().string();
+            e.watch = addWatch(dir);
+        }
+        if (e.watch < 0) ++m_polled;
         m_entries.push_back(std::move(e));
     }
 
     void ResourceManager::untrack(const std::string& path) {
+        for (auto& e : m_entries) {
+            if (e.path != path) continue;
+            if (e.watch >= 0) releaseWatch(e.watch); else --m_polled;
+            if (e.due) --m_dueCount;
+        }
         m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
             [&](const Entry& e) { return e.path == path; }),
             m_entries.end());
     }
 
     void ResourceManager::check(bool force) {
+        if (force) {
+            for (auto& e : m_entries) {
+                e.due = false;
+                fire(e);
+                e.firstInit = false;
+            }
+            m_dueCount = 0;
+            return;
+        }
+
+        // Bos karede: bir atomik okuma + iki sayac; stat/read yok
+        if (m_hasEvents.load(std::memory_order_acquire)) drainEvents();
+        if (m_dueCount > 0) {
+            const Clock::time_point now = Clock::now();
+            for (auto& e : m_entries) {
+                if (!e.due || now < e.dueAt) continue;
+                e.due = false; --m_dueCount;
+                fire(e);
+            }
+        }
+        if (m_polled > 0) pollEntries();
+    }
+
+    // Watch'i olmayan entry'ler: her karede mtime (eski yol)
+    void ResourceManager::pollEntries() {
         for (auto& e : m_entries) {
+            if (e.watch >= 0) continue;
             bool changed = false;
-            if (!force) {
-                if (auto mt = safe_mtime(e.path)) {
-                    if (e.firstInit) {
-                        // ilk kontrol: lastWrite' gncelle ve tetikleME
-                        e.lastWrite = *mt;
-                    }
-                    else if (*mt != e.lastWrite) {
-                        e.lastWrite = *mt;
-                        changed = true;
-                    }
-                }
-            }
-            if (force || changed) {
-                try {
-                    e.reload();
+            if (auto mt = safe_mtime(e.path)) {
+                if (e.firstInit) {
+                    // ilk kontrol: lastWrite' gncelle ve tetikleME
+                    e.lastWrite = *mt;
                 }
-                catch (...) {
-                    // Reload srasnda bir hata olursa sessiz gemeyelim
-                    std::cerr << "[hotreload] reload callback threw for: " << e.path << "\n";
+                else if (*mt != e.lastWrite) {
+                    e.lastWrite = *mt;
+                    changed = true;
                 }
             }
+            if (changed) fire(e);
             e.firstInit = false;
         }
     }
 
+    // Ana thread: kuyruktaki olaylari entry'lere esle, debounce suresini (yeniden) baslat
+    void ResourceManager::drainEvents() {
+        {
+            std::lock_guard<std::mutex> lk(m_evMx);
+            m_evScratch.swap(m_events);
+            m_hasEvents.store(false, std::memory_order_relaxed);
+        }
+        const Clock::time_point at = Clock::now() + std::chrono::milliseconds(m_debounceMs);
+        for (const auto& [wd, name] : m_evScratch) {
+            for (auto& e : m_entries) {
+                if (e.watch < 0) continue;
+                if (wd >= 0 && (e.watch != wd || e.name != name)) continue; // wd<0: tasma -> hepsi
+                if (!e.due) { e.due = true; ++m_dueCount; }
+                e.dueAt = at;
+            }
+        }
+        m_evScratch.clear();
+    }
+
+#ifdef __linux__
+    bool ResourceManager::startNotify() {
+        m_notifyTried = true;
+        m_notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_notifyFd < 0) {
+            std::cerr << "[hotreload] inotify unavailable, falling back to mtime polling\n";
+            return false;
+        }
+        m_wakeFd = eventfd(0, EFD_CLOEXEC);
+        if (m_wakeFd < 0) { close(m_notifyFd); m_notifyFd = -1; return false; }
+        m_notifyThread = std::thread([this] { notifyLoop(); });
+        return true;
+    }
+
+    void ResourceManager::stopNotify() {
+        if (m_notifyThread.joinable()) {
+            const uint64_t one = 1;
+            [[maybe_unused]] ssize_t w = write(m_wakeFd, &one, sizeof(one));
+            m_notifyThread.join();
+        }
+        if (m_wakeFd >= 0) { close(m_wakeFd); m_wakeFd = -1; }
+        if (m_notifyFd >= 0) { close(m_notifyFd); m_notifyFd = -1; } // watch'lar fd ile kapanir
+        m_watches.clear();
+    }
+
+    // Arka plan thread'i: olay gelene kadar poll'da uyur, entry'lere dokunmaz
+    void ResourceManager::notifyLoop() {
+        alignas(inotify_event) char buf[8192];
+        pollfd fds[2] = { { m_notifyFd, POLLIN, 0 }, { m_wakeFd, POLLIN, 0 } };
+        for (;;) {
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (fds[1].revents) break;
+            const ssize_t n = read(m_notifyFd, buf, sizeof(buf));
+            if (n <= 0) continue;
+            std::lock_guard<std::mutex> lk(m_evMx);
+            for (const char* p = buf; p < buf + n; ) {
+                const inotify_event* ev = (const inotify_event*)p;
+                if (ev->mask & IN_Q_OVERFLOW) m_events.emplace_back(-1, std::string());
+                else if (ev->len > 0) m_events.emplace_back(ev->wd, std::string(ev->name));
+                p += sizeof(inotify_event) + ev->len;
+            }
+            m_hasEvents.store(true, std::memory_order_release);
+        }
+    }
+
+    int ResourceManager::addWatch(const std::string& dir) {
+        for (auto& w : m_watches)
+            if (w.dir == dir) { ++w.refs; return w.wd; }
+        // Yerinde yazma: CLOSE_WRITE; temp + rename: MOVED_TO (hedef adla gelir)
+        const int wd = inotify_add_watch(m_notifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            std::cerr << "[hotreload] inotify watch failed for: " << dir << " (polling)\n";
+            return -1;
+        }
+        for (auto& w : m_watches)
+            if (w.wd == wd) { ++w.refs; return wd; }  // ayni dizine farkli yazilis ("./a" / "a")
+        m_watches.push_back({ wd, dir, 1 });
+        return wd;
+    }
+
+    void ResourceManager::releaseWatch(int wd) {
+        for (size_t i = 0; i < m_watches.size(); ++i) {
+            if (m_watches[i].wd != wd) continue;
+            if (--m_watches[i].refs == 0) {
+                inotify_rm_watch(m_notifyFd, wd);
+                m_watches.erase(m_watches.begin() + (ptrdiff_t)i);
+            }
+            return;
+        }
+    }
+#else
+    bool ResourceManager::startNotify() { m_notifyTried = true; return false; }
+    void ResourceManager::stopNotify() {}
+    void ResourceManager::notifyLoop() {}
+    int  ResourceManager::addWatch(const std::string&) { return -1; }
+    void ResourceManager::releaseWatch(int) {}
+#endif
+
 } // namespace Erlik
@@ -5,11 +5,24 @@
 #include <filesystem>
 #include <optional>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 namespace Erlik {
 
+    // Linux: dosyalar ust dizinlerine konan inotify watch'lari ile izlenir. Olaylari arka plandaki
+    // thread okur ve kuyruga atar; check() yalnizca atomik bayraga bakar (degisiklik yoksa sifir
+    // syscall). Editorlerin temp dosya + rename ile kaydetmesi ve art arda yazmalar debounce ile
+    // tek reload'a iner. Diger platformlarda (ya da watch kurulamayan yolda) mtime yoklamasi.
     class ResourceManager {
     public:
+        ResourceManager() = default;
+        ~ResourceManager();
+        ResourceManager(const ResourceManager&) = delete;
+        ResourceManager& operator=(const ResourceManager&) = delete;
+
         // Bir dosyay izle ve deitiinde 'reload' callback'ini altr
         void track(const std::string& path, std::function<void()> reload);
 
@@ -19,16 +32,48 @@ namespace Erlik {
         // Deiiklikleri kontrol et. force=true ise callback'i hemen altrr
         void check(bool force = false);
 
+        // Son olaydan sonra reload icin beklenen sure (ms); bu sure icindeki olaylar birlesir
+        void setDebounceMs(int ms) { m_debounceMs = ms < 0 ? 0 : ms; }
+        bool usingNotify() const { return m_notifyFd >= 0; }
+
     private:
+        using Clock = std::chrono::steady_clock;
         struct Entry {
             std::string path;
             std::filesystem::file_time_type lastWrite{};
             std::function<void()> reload;
             bool firstInit = true; // ilk track'te force ile tetiklemeyi kolaylatrr
+            // inotify: ust dizin watch'i + dosya adi; watch < 0 ise mtime yoklanir
+            int         watch = -1;
+            std::string name;
+            bool        due = false;      // olay geldi, debounce suresi bekleniyor
+            Clock::time_point dueAt{};
         };
         std::vector<Entry> m_entries;
 
         static std::optional<std::filesystem::file_time_type> safe_mtime(const std::string& path);
+        static void fire(Entry& e);
+        void pollEntries();
+
+        // --- inotify (yalnizca Linux; digerlerinde fd'ler -1 kalir) ---
+        struct Watch { int wd = -1; std::string dir; int refs = 0; };
+        std::vector<Watch> m_watches;
+        int  m_notifyFd = -1, m_wakeFd = -1;
+        bool m_notifyTried = false;
+        std::thread m_notifyThread;
+        std::mutex  m_evMx;
+        std::vector<std::pair<int, std::string>> m_events, m_evScratch; // (wd, dosya adi); wd<0: tasma
+        std::atomic<bool> m_hasEvents{ false };
+        int  m_dueCount = 0;     // due=true entry sayisi (0 ise saat bile okunmaz)
+        int  m_polled = 0;       // watch'siz (yoklanan) entry sayisi
+        int  m_debounceMs = 100;
+
+        bool startNotify();
+        void stopNotify();
+        void notifyLoop();
+        int  addWatch(const std::string& dir);
+        void releaseWatch(int wd);
+        void drainEvents();
     };
 
 } // namespace Erlik
@@ -1,8 +1,15 @@
 #include "SpriteAtlas.h"
 #include <SDL.h>
+#include <utility>
 namespace Erlik{
 bool SpriteAtlas::loadGrid(SDL_Renderer* r,const std::string& path,int frameW,int frameH,int margin,int spacing){
-    if(!m_tex.loadFromFile(r,path)) return false;
+    Texture tex;
+    if(!tex.loadFromFile(r,path)) return false;
+    return loadGrid(std::move(tex),frameW,frameH,margin,spacing);
+}
+bool SpriteAtlas::loadGrid(Texture&& tex,int frameW,int frameH,int margin,int spacing){
+    if(!tex.sdl()) return false;
+    m_tex=std::move(tex);
     m_frames.clear();
     int texW=m_tex.width(), texH=m_tex.height();
     for(int y=margin; y+frameH<=texH; y+=frameH+spacing){
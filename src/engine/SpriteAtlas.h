@@ -8,6 +8,8 @@ namespace Erlik {
 class SpriteAtlas{
 public:
     bool loadGrid(SDL_Renderer*, const std::string& path, int frameW,int frameH,int margin=0,int spacing=0);
+    // Onceden yuklenmis texture ile (AssetLoader::takeTexture)
+    bool loadGrid(Texture&& tex, int frameW,int frameH,int margin=0,int spacing=0);
     const Texture& texture() const { return m_tex; }
     const SDL_Rect* frame(int index) const;
     int frameCount() const { return (int)m_frames.size(); }
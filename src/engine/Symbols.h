@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Erlik {
+
+    // Interned string id. 0 = bos string; id'ler tablo yasadikca sabittir.
+    using Sym = int32_t;
+
+    // String interning: her farkli string bir kez saklanir, calisma aninda id ile karsilastirilir.
+    // intern() yukleme aninda (hash + olasi ekleme); str()/karsilastirma O(1), ayirmasiz.
+    // Tablo sadece buyur: hot reload ayni isimlere ayni id'leri verir (oyun durumu id tutabilir).
+    class SymbolTable {
+    public:
+        SymbolTable() { m_strs.emplace_back(); }
+
+        Sym intern(const std::string& s) {
+            if (s.empty()) return 0;
+            auto it = m_ids.find(s);
+            if (it != m_ids.end()) return it->second;
+            const Sym id = (Sym)m_strs.size();
+            m_strs.push_back(s);
+            m_ids.emplace(s, id);
+            return id;
+        }
+        // Yoksa eklemez; -1 doner
+        Sym find(const std::string& s) const {
+            if (s.empty()) return 0;
+            auto it = m_ids.find(s);
+            return it != m_ids.end() ? it->second : -1;
+        }
+        const std::string& str(Sym id) const { return m_strs[id]; }
+        int size() const { return (int)m_strs.size(); }
+
+    private:
+        std::vector<std::string> m_strs;
+        std::unordered_map<std::string, Sym> m_ids;
+    };
+
+} // namespace Erlik
@@ -0,0 +1,351 @@
+// TMJMap ikili onbellek (.tmjb): parse edilmis haritanin (layer verisi, tileset metadata'si,
+// derlenmis triggerlar, isik/platform/oda tanimlari, collision grid) surumlu dokumu.
+// Dosya mmap ile acilir; diziler 4 bayt hizali oldugu icin eslenmis bellekten tek memcpy ile
+// alinir (layer'lar setTile ile duzenlendigi icin yerinde kullanilmaz, kopyalanir).
+#include "TMJMap.h"
+#include "Tilemap.h"
+#include "MappedFile.h"
+#include <SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <type_traits>
+
+namespace Erlik {
+
+    namespace {
+
+        constexpr char     kMagic[4] = { 'E', 'M', 'A', 'P' };
+        constexpr uint32_t kVersion = 1;
+
+        // POD kayitlar oldugu gibi yazilir; bir struct'in boyutu degisirse eski onbellek gecersizdir
+        static_assert(std::is_trivially_copyable_v<Trigger> && std::is_trivially_copyable_v<TriggerProps> &&
+            std::is_trivially_copyable_v<LightDef> && std::is_trivially_copyable_v<PlatformDef>,
+            "baked kayitlar memcpy ile yazilir");
+        constexpr uint32_t kAbi = (uint32_t)(sizeof(Trigger) + 256u * (sizeof(TriggerProps) +
+            256u * (sizeof(LightDef) + 256u * sizeof(PlatformDef))));
+
+        struct Header {
+            char     magic[4];
+            uint32_t version;
+            uint32_t abi;
+            uint32_t payload;   // header'dan sonraki bayt sayisi
+            uint64_t srcSize;   // kaynak .tmj
+            int64_t  srcMtime;
+            uint64_t srcHash;   // FNV-1a 64: mtime degisip icerik ayniysa onbellek gecerli kalir
+        };
+
+        // TriggerProps icindeki string id'leri: dosyada yerel tabloya, okurken m_syms'e cevrilir
+        constexpr Sym TriggerProps::* kPropSyms[] = {
+            &TriggerProps::name, &TriggerProps::targetName, &TriggerProps::giveKey, &TriggerProps::requiresKey,
+            &TriggerProps::sfx, &TriggerProps::lockedSfx, &TriggerProps::unlockSfx,
+            &TriggerProps::music, &TriggerProps::exitMusic,
+        };
+
+        uint64_t fnv1a(const uint8_t* p, size_t n) {
+            uint64_t h = 1469598103934665603ull;
+            for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+            return h;
+        }
+
+        bool statFile(const std::string& path, uint64_t& size, int64_t& mtime) {
+            std::error_code ec;
+            size = (uint64_t)std::filesystem::file_size(path, ec);
+            if (ec) return false;
+            const auto t = std::filesystem::last_write_time(path, ec);
+            if (ec) return false;
+            mtime = (int64_t)t.time_since_epoch().count();
+            return true;
+        }
+
+        struct Writer {
+            std::vector<uint8_t> b;
+            void raw(const void* p, size_t n) { const uint8_t* s = (const uint8_t*)p; b.insert(b.end(), s, s + n); }
+            template<class T> void pod(const T& v) { raw(&v, sizeof(T)); }
+            void align() { while (b.size() & 3) b.push_back(0); }
+            void str(const std::string& s) { pod((uint32_t)s.size()); raw(s.data(), s.size()); }
+            template<class T> void vec(const std::vector<T>& v) {
+                pod((uint32_t)v.size()); align(); raw(v.data(), v.size() * sizeof(T));
+            }
+        };
+
+        // Sinir kontrollu okuyucu: ilk tasmada ok=false, sonraki okumalar bos doner
+        struct Reader {
+            const uint8_t* base;
+            const uint8_t* p;
+            const uint8_t* end;
+            bool ok = true;
+
+            bool need(size_t n) { if (ok && (size_t)(end - p) < n) ok = false; return ok; }
+            template<class T> T pod() {
+                T v{};
+                if (need(sizeof(T))) { std::memcpy(&v, p, sizeof(T)); p += sizeof(T); }
+                return v;
+            }
+            void align() { while (((p - base) & 3) && p < end) ++p; }
+            std::string str() {
+                const uint32_t n = pod<uint32_t>();
+                if (!need(n)) return {};
+                std::string s((const char*)p, n); p += n;
+                return s;
+            }
+            template<class T> void vec(std::vector<T>& v) {
+                const uint32_t n = pod<uint32_t>();
+                align();
+                if (!need((size_t)n * sizeof(T))) { v.clear(); return; }
+                v.resize(n);
+                if (n) std::memcpy(v.data(), p, (size_t)n * sizeof(T));
+                p += (size_t)n * sizeof(T);
+            }
+        };
+
+    } // namespace
+
+    std::string TMJMap::bakedPathFor(const std::string& tmjPath)
+    {
+        if (tmjPath.size() > 4 && tmjPath.compare(tmjPath.size() - 4, 4, ".tmj") == 0) return tmjPath + "b";
+        return tmjPath + ".tmjb";
+    }
+
+    bool TMJMap::loadBaked(const std::string& bakedPath, const std::string& tmjPath)
+    {
+        const Uint64 t0 = SDL_GetPerformanceCounter();
+        MappedFile mf;
+        if (!mf.open(bakedPath) || mf.size() < sizeof(Header)) return false;
+
+        Header h;
+        std::memcpy(&h, mf.data(), sizeof(h));
+        if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion || h.abi != kAbi ||
+            sizeof(Header) + (size_t)h.payload != mf.size()) {
+            SDL_Log("TMJMap: baked cache stale format, rebuilding: %s", bakedPath.c_str());
+            return false;
+        }
+        uint64_t srcSize = 0; int64_t srcMtime = 0;
+        if (!statFile(tmjPath, srcSize, srcMtime) || srcSize != h.srcSize) return false;
+        bool touch = false;
+        if (srcMtime != h.srcMtime) {
+            // dokunulmus ama icerik ayni olabilir (checkout, kopya): hash karar verir
+            MappedFile src;
+            if (!src.open(tmjPath) || fnv1a(src.data(), src.size()) != h.srcHash) return false;
+            touch = true;
+        }
+
+        Reader rd{ mf.data(), mf.data() + sizeof(Header), mf.data() + mf.size() };
+
+        // Bagimlilik: harici tileset degistiyse (ornegin tile "shape" eklendi) onbellek eskidir
+        const std::string tsx = rd.str();
+        const uint64_t tsxSize = rd.pod<uint64_t>();
+        const int64_t  tsxMtime = rd.pod<int64_t>();
+        if (!tsx.empty()) {
+            uint64_t s = 0; int64_t m = 0;
+            if (!statFile(tsx, s, m) || s != tsxSize || m != tsxMtime) return false;
+        }
+        if (!rd.ok) return false;
+
+        // once=true tetiklenmisler Tiled id ile tasinir (parseTmj ile ayni kural)
+        std::vector<int> firedIds;
+        for (const auto& t : m_triggers) if (t.flags & TRIG_FIRED) firedIds.push_back(t.id);
+        std::sort(firedIds.begin(), firedIds.end());
+
+        // Once yerellere coz: bozuk dosyada canli harita (ve tetiklenmis id'ler) korunur,
+        // cagiran parseTmj'ye temiz durumla duser. Sadece tum kontroller gecerse tasinir.
+        const int32_t cols = rd.pod<int32_t>(), rows = rd.pod<int32_t>();
+        const int32_t tileW = rd.pod<int32_t>(), tileH = rd.pod<int32_t>();
+        const uint32_t firstGid = rd.pod<uint32_t>();
+        const int32_t columns = rd.pod<int32_t>();
+        const int32_t margin = rd.pod<int32_t>(), spacing = rd.pod<int32_t>();
+        std::string imagePath = rd.str();
+        std::vector<uint8_t> tileShape;
+        rd.vec(tileShape);
+        const bool hasAmbient = rd.pod<uint8_t>() != 0;
+        const uint8_t ambR = rd.pod<uint8_t>(), ambG = rd.pod<uint8_t>(), ambB = rd.pod<uint8_t>();
+
+        // Layer'lar
+        const uint32_t nl = rd.pod<uint32_t>();
+        std::vector<Layer> layers(rd.need((size_t)nl) ? nl : 0);
+        for (Layer& L : layers) {
+            L.name = rd.str();
+            L.preset = rd.str();
+            const uint8_t f = rd.pod<uint8_t>();
+            L.visible = (f & 1) != 0;       L.propCollision = (f & 2) != 0;
+            L.propOneWay = (f & 4) != 0;    L.propFG = (f & 8) != 0;
+            L.propStatic = (f & 16) != 0;   L.hasMinimapColor = (f & 32) != 0;
+            L.mmR = rd.pod<uint8_t>(); L.mmG = rd.pod<uint8_t>(); L.mmB = rd.pod<uint8_t>();
+            L.opacity = rd.pod<float>();
+            L.parallaxX = rd.pod<float>(); L.parallaxY = rd.pod<float>();
+            L.offsetX = rd.pod<float>();   L.offsetY = rd.pod<float>();
+            rd.vec(L.data);
+        }
+
+        // Triggerlar: yerel string tablosu -> m_syms (tablo sadece buyur, id'ler reload'lar arasi
+        // sabit; bozuk dosyada fazladan intern edilenler zararsiz)
+        const uint32_t ns = rd.pod<uint32_t>();
+        std::vector<Sym> remap;
+        remap.reserve(rd.need((size_t)ns * 4) ? ns : 0);
+        for (uint32_t i = 0; i < ns && rd.ok; ++i) remap.push_back(m_syms.intern(rd.str()));
+        std::vector<Trigger> triggers;
+        std::vector<TriggerProps> triggerProps;
+        rd.vec(triggers);
+        rd.vec(triggerProps);
+        if (triggerProps.size() != triggers.size()) rd.ok = false;
+        for (TriggerProps& p : triggerProps)
+            for (Sym TriggerProps::* f : kPropSyms) {
+                const Sym local = p.*f;
+                if (local < 0 || local >= (Sym)remap.size()) { rd.ok = false; p.*f = 0; }
+                else p.*f = remap[local];
+            }
+        std::vector<TriggerText> triggerText(rd.ok ? triggers.size() : 0);
+        for (TriggerText& x : triggerText) {
+            x.message = rd.str(); x.lockedMsg = rd.str(); x.unlockMsg = rd.str();
+        }
+
+        std::vector<LightDef> lightDefs;
+        std::vector<PlatformDef> platformDefs;
+        rd.vec(lightDefs);
+        rd.vec(platformDefs);
+        const uint32_t nr = rd.pod<uint32_t>();
+        std::vector<RoomDef> roomDefs(rd.need((size_t)nr * 20) ? nr : 0);
+        for (RoomDef& d : roomDefs) {
+            d.x = rd.pod<float>(); d.y = rd.pod<float>(); d.w = rd.pod<float>(); d.h = rd.pod<float>();
+            d.name = rd.str();
+        }
+
+        std::vector<int8_t>  bakedCol;
+        std::vector<uint8_t> bakedShape;
+        rd.vec(bakedCol);
+        rd.vec(bakedShape);
+        const size_t cells = (cols > 0 && rows > 0) ? (size_t)cols * (size_t)rows : 0;
+        for (const Layer& L : layers) if (L.data.size() != cells) rd.ok = false; // yanlis boyutlu katman
+        if (!rd.ok || cells == 0 || bakedCol.size() != cells) {
+            SDL_Log("TMJMap: baked cache corrupt, rebuilding: %s", bakedPath.c_str());
+            return false;
+        }
+
+        m_tsxPath = tsx;
+        m_mapCols = cols; m_mapRows = rows;
+        m_tileW = tileW; m_tileH = tileH;
+        m_firstGid = firstGid;
+        m_columns = columns;
+        m_margin = margin; m_spacing = spacing;
+        m_imagePath = std::move(imagePath);
+        m_tileShape = std::move(tileShape);
+        m_hasAmbient = hasAmbient;
+        m_ambR = ambR; m_ambG = ambG; m_ambB = ambB;
+        m_layers = std::move(layers);
+        m_triggers = std::move(triggers);
+        m_triggerProps = std::move(triggerProps);
+        m_triggerText = std::move(triggerText);
+        m_lightDefs = std::move(lightDefs);
+        m_platformDefs = std::move(platformDefs);
+        m_roomDefs = std::move(roomDefs);
+        m_bakedCol = std::move(bakedCol);
+        m_bakedShape = std::move(bakedShape);
+
+        for (Trigger& t : m_triggers) {
+            t.flags &= (uint8_t)~TRIG_FIRED;
+            if (std::binary_search(firedIds.begin(), firedIds.end(), t.id)) t.flags |= TRIG_FIRED;
+        }
+        resolveTriggers();
+        buildTriggerGrid();
+
+        const double ms = (double)(SDL_GetPerformanceCounter() - t0) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+        SDL_Log("TMJMap: baked cache %s (%dx%d, %zu layers, %zu triggers) in %.3f ms",
+            bakedPath.c_str(), m_mapCols, m_mapRows, m_layers.size(), m_triggers.size(), ms);
+
+        if (touch) { mf.close(); saveBaked(bakedPath, tmjPath); } // yeni mtime'i kaydet
+        return true;
+    }
+
+    bool TMJMap::saveBaked(const std::string& bakedPath, const std::string& tmjPath) const
+    {
+        Header h{};
+        std::memcpy(h.magic, kMagic, 4);
+        h.version = kVersion;
+        h.abi = kAbi;
+        {
+            MappedFile src;
+            if (!statFile(tmjPath, h.srcSize, h.srcMtime) || !src.open(tmjPath)) return false;
+            h.srcHash = fnv1a(src.data(), src.size());
+        }
+
+        Writer w;
+        uint64_t tsxSize = 0; int64_t tsxMtime = 0;
+        if (!m_tsxPath.empty() && !statFile(m_tsxPath, tsxSize, tsxMtime)) return false;
+        w.str(m_tsxPath); w.pod(tsxSize); w.pod(tsxMtime);
+
+        w.pod((int32_t)m_mapCols); w.pod((int32_t)m_mapRows);
+        w.pod((int32_t)m_tileW);   w.pod((int32_t)m_tileH);
+        w.pod((uint32_t)m_firstGid);
+        w.pod((int32_t)m_columns);
+        w.pod((int32_t)m_margin);  w.pod((int32_t)m_spacing);
+        w.str(m_imagePath);
+        w.vec(m_tileShape);
+        w.pod((uint8_t)(m_hasAmbient ? 1 : 0)); w.pod(m_ambR); w.pod(m_ambG); w.pod(m_ambB);
+
+        w.pod((uint32_t)m_layers.size());
+        for (const Layer& L : m_layers) {
+            w.str(L.name);
+            w.str(L.preset);
+            w.pod((uint8_t)((L.visible ? 1 : 0) | (L.propCollision ? 2 : 0) | (L.propOneWay ? 4 : 0) |
+                (L.propFG ? 8 : 0) | (L.propStatic ? 16 : 0) | (L.hasMinimapColor ? 32 : 0)));
+            w.pod(L.mmR); w.pod(L.mmG); w.pod(L.mmB);
+            w.pod(L.opacity);
+            w.pod(L.parallaxX); w.pod(L.parallaxY);
+            w.pod(L.offsetX);   w.pod(L.offsetY);
+            w.vec(L.data);
+        }
+
+        // Sadece triggerlarin kullandigi semboller, yerel id sirasiyla
+        std::vector<Sym> local(m_syms.size(), 0), order{ 0 };
+        std::vector<TriggerProps> props = m_triggerProps;
+        for (TriggerProps& p : props)
+            for (Sym TriggerProps::* f : kPropSyms) {
+                const Sym s = p.*f;
+                if (s <= 0) continue;
+                if (!local[s]) { local[s] = (Sym)order.size(); order.push_back(s); }
+                p.*f = local[s];
+            }
+        w.pod((uint32_t)order.size());
+        for (Sym s : order) w.str(m_syms.str(s));
+        std::vector<Trigger> hot = m_triggers;
+        for (Trigger& t : hot) t.flags &= (uint8_t)~TRIG_FIRED; // oyun durumu onbellege girmez
+        w.vec(hot);
+        w.vec(props);
+        for (const TriggerText& x : m_triggerText) { w.str(x.message); w.str(x.lockedMsg); w.str(x.unlockMsg); }
+
+        w.vec(m_lightDefs);
+        w.vec(m_platformDefs);
+        w.pod((uint32_t)m_roomDefs.size());
+        for (const RoomDef& d : m_roomDefs) { w.pod(d.x); w.pod(d.y); w.pod(d.w); w.pod(d.h); w.str(d.name); }
+
+        // Collision grid varsayilan katman adlariyla ("collision"/"oneway")
+        if (!m_bakedCol.empty()) { w.vec(m_bakedCol); w.vec(m_bakedShape); }
+        else {
+            std::vector<int> grid; std::vector<uint8_t> shapes; int solids = 0, oneways = 0;
+            collisionGrid("collision", "oneway", grid, shapes, solids, oneways);
+            std::vector<int8_t> cls(grid.begin(), grid.end());
+            w.vec(cls); w.vec(shapes);
+        }
+        h.payload = (uint32_t)w.b.size();
+
+        // Gecici dosya + rename: yarim yazilmis onbellek asla okunmaz
+        const std::string tmp = bakedPath + ".tmp";
+        FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) { SDL_Log("TMJMap: baked cache not writable: %s", tmp.c_str()); return false; }
+        const bool wrote = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+            (w.b.empty() || std::fwrite(w.b.data(), w.b.size(), 1, f) == 1);
+        std::fclose(f);
+        std::error_code ec;
+        if (wrote) std::filesystem::rename(tmp, bakedPath, ec);
+        if (!wrote || ec) {
+            std::filesystem::remove(tmp, ec);
+            SDL_Log("TMJMap: baked cache write failed: %s", bakedPath.c_str());
+            return false;
+        }
+        SDL_Log("TMJMap: baked cache written: %s (%zu KB)", bakedPath.c_str(), (sizeof(h) + w.b.size()) / 1024);
+        return true;
+    }
+
+} // namespace Erlik
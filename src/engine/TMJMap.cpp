@@ -1,161 +1,130 @@
 #include "TMJMap.h"
 #include "Tilemap.h"
-#include <nlohmann/json.hpp>
+#include "AssetLoader.h"
 #include <fstream>
 #include <cmath>
 #include <algorithm>
 #include <SDL.h>
 #include <cctype>
 
-using nlohmann::json;
-
 namespace Erlik {
 
-    static std::string tolower_copy(std::string s) {
-        for (auto& c : s) c = (char)std::tolower((unsigned char)c);
-        return s;
+    std::string TMJMap::dirOf(const std::string& p) {
+        size_t pos = p.find_last_of("/\\");
+        return (pos == std::string::npos) ? std::string() : p.substr(0, pos + 1);
     }
 
-    static bool json_bool_or(const nlohmann::json& o, const char* name, bool defv) {
-        if (!o.contains("properties")) return defv;
-        for (auto& p : o["properties"]) {
-            if (p.value("name", "") == name) {
-                if (p.contains("value") && p["value"].is_boolean()) return p["value"].get<bool>();
-            }
-        }
-        return defv;
+    bool TMJMap::load(SDL_Renderer* r, const std::string& tmjPath)
+    {
+        return readSource(tmjPath) && finishLoad(r);
     }
 
-    static std::string json_str_or(const nlohmann::json& o, const char* name, const std::string& defv) {
-        if (!o.contains("properties")) return defv;
-        for (auto& p : o["properties"]) {
-            if (p.value("name", "") == name) {
-                if (p.contains("value")) {
-                    if (p["value"].is_string())  return p["value"].get<std::string>();
-                    if (p["value"].is_number())  return p["value"].dump(); // sayy stringle
-                }
-            }
-        }
-        return defv;
-    }
+    bool TMJMap::readSource(const std::string& tmjPath)
+    {
+        m_baseDir = dirOf(tmjPath);
+        // Onceki yuklemeden kalmis cache'leri temizle (hot-reload icin)
+        destroyCaches();
 
-    static float json_float_or(const nlohmann::json& o, const char* name, float defv) {
-        if (!o.contains("properties")) return defv;
-        for (auto& p : o["properties"]) {
-            if (p.value("name", "") == name) {
-                if (p.contains("value")) {
-                    if (p["value"].is_number()) return p["value"].get<float>();
-                    if (p["value"].is_string()) { try { return std::stof(p["value"].get<std::string>()); } catch (...) {} }
-                }
-            }
+        // Ikili onbellek kaynakla eslesiyorsa JSON hic acilmaz; yoksa parse edilip yeniden yazilir
+        const std::string baked = bakedPathFor(tmjPath);
+        bool parsed = m_useBaked && loadBaked(baked, tmjPath);
+        if (!parsed) {
+            if (!parseTmj(tmjPath)) return false;
+            if (m_useBaked) saveBaked(baked, tmjPath);
         }
-        return defv;
+        return true;
     }
 
-
-    std::string TMJMap::dirOf(const std::string& p) {
-        size_t pos = p.find_last_of("/\\");
-        return (pos == std::string::npos) ? std::string() : p.substr(0, pos + 1);
+    bool TMJMap::beginLoad(const std::string& tmjPath, AssetLoader& assets)
+    {
+        m_tilesetJob = -1;
+        if (!readSource(tmjPath)) return false;
+        // finishLoad ile ayni iki deneme (oldugu gibi, sonra baseDir ile); worker ikisini de dener
+        m_tilesetJob = assets.loadTexture(m_imagePath, m_baseDir.empty() ? m_imagePath : (m_baseDir + m_imagePath));
+        return m_tilesetJob >= 0;
     }
 
-    static std::string readFileText(const std::string& p) {
-        std::ifstream f(p, std::ios::binary); if (!f) return {};
-        std::string s; f.seekg(0, std::ios::end); s.resize((size_t)f.tellg());
-        f.seekg(0, std::ios::beg); f.read(&s[0], (std::streamsize)s.size()); return s;
-    }
-    static std::string getAttr(const std::string& tag, const std::string& name) {
-        auto p = tag.find(name + "="); if (p == std::string::npos) return {};
-        p += name.size() + 1; if (p >= tag.size()) return {};
-        char q = tag[p]; if (q != '\"' && q != '\'') return {};
-        auto s = p + 1; auto e = tag.find(q, s); if (e == std::string::npos) return {};
-        return tag.substr(s, e - s);
+    bool TMJMap::endLoad(SDL_Renderer* r, AssetLoader& assets)
+    {
+        const AssetLoader::Handle h = m_tilesetJob;
+        m_tilesetJob = -1;
+        if (h < 0) return false;
+        const bool ready = assets.wait(h, r) == AssetLoader::State::Ready;
+        if (ready && assets.path(h) != m_imagePath) SDL_Log("TMJMap: tileset loaded via baseDir: %s", assets.path(h).c_str());
+        if (!ready || !assets.takeTexture(h, m_tileset)) { // take handle'i birakir
+            assets.release(h);
+            SDL_Log("TMJMap: tileset yuklenemedi (\"%s\")", m_imagePath.c_str());
+            return false;
+        }
+        return buildRenderData(r);
     }
-    static int getAttrInt(const std::string& tag, const std::string& name, int def = 0) {
-        auto v = getAttr(tag, name); if (v.empty()) return def; try { return std::stoi(v); }
-        catch (...) { return def; }
+
+    void TMJMap::inheritState(const TMJMap& live)
+    {
+        m_syms = live.m_syms;
+        m_symBase = live.m_syms.size();
+        m_useBaked = live.m_useBaked;
     }
 
-    bool TMJMap::load(SDL_Renderer* r, const std::string& tmjPath)
+    bool TMJMap::prepare(const std::string& tmjPath)
     {
-        // --- TMJ dosyasn oku ---
-        std::ifstream in(tmjPath);
-        if (!in) {
-            SDL_Log("TMJMap: tmj not found: %s", tmjPath.c_str());
+        if (!readSource(tmjPath)) return false;
+        std::string used;
+        m_preparedTileset.reset(AssetLoader::decodeImage(m_imagePath,
+            m_baseDir.empty() ? std::string() : (m_baseDir + m_imagePath), &used));
+        if (!m_preparedTileset) {
+            SDL_Log("TMJMap: tileset yuklenemedi (\"%s\")", m_imagePath.c_str());
             return false;
         }
-        json j; in >> j;
+        // Draw list'ler texture genisligine bakmasin (henuz upload yok)
+        if (m_columns <= 0) m_columns = m_preparedTileset->w / std::max(1, m_tileW);
+        buildDrawLists();
+        return m_mapCols > 0 && m_mapRows > 0;
+    }
 
-        m_baseDir = dirOf(tmjPath);
-        // nceki yklemeden kalm cacheleri temizle (hot-reload iin)
-        destroyCaches();
+    bool TMJMap::finishPrepared(SDL_Renderer* r, const TMJMap& live)
+    {
+        if (!m_preparedTileset) return false;
+        const bool ok = m_tileset.createFromSurface(r, m_preparedTileset.get());
+        m_preparedTileset.reset();
+        if (!ok) return false;
+
+        // once=true trigger'lar Tiled id ile tasinir (hazirlik sirasinda tetiklenenler dahil)
+        std::vector<int> firedIds;
+        for (const auto& t : live.m_triggers) if (t.flags & TRIG_FIRED) firedIds.push_back(t.id);
+        std::sort(firedIds.begin(), firedIds.end());
+        for (auto& t : m_triggers)
+            if (std::binary_search(firedIds.begin(), firedIds.end(), t.id)) t.flags |= TRIG_FIRED;
 
-        // Harita boyutlar
-        m_mapCols = j.value("width", 0);
-        m_mapRows = j.value("height", 0);
-        m_tileW = j.value("tilewidth", 32);
-        m_tileH = j.value("tileheight", 32);
-
-        // --- Tileset (tek tileset bekliyoruz) ---
-        auto tilesets = j["tilesets"];
-        if (!tilesets.is_array() || tilesets.empty()) return false;
-        const auto& ts = tilesets[0];
-        m_firstGid = ts.value("firstgid", 1u);
-
-        std::string image;
-        m_columns = ts.value("columns", 0);
-        m_margin = ts.value("margin", 0);
-        m_spacing = ts.value("spacing", 0);
-
-        if (ts.contains("image")) {
-            // INLINE TILESET (TMJ iinde image alan var)
-            image = ts.value("image", "");
-            // (Varsa TMJ'deki tilewidth/height deerleriyle override edilebilir)
-            m_tileW = j.value("tilewidth", m_tileW);
-            m_tileH = j.value("tileheight", m_tileH);
-        }
-        else if (ts.contains("source")) {
-            // EXTERNAL .TSX
-            std::string tsxRel = ts.value("source", "");
-            std::string tsxPath = m_baseDir.empty() ? tsxRel : (m_baseDir + tsxRel);
-            std::string xml = readFileText(tsxPath);
-            if (xml.empty()) { SDL_Log("TMJMap: tsx not found: %s", tsxPath.c_str()); return false; }
-
-            // <tileset ...>
-            auto p0 = xml.find("<tileset"); if (p0 == std::string::npos) { SDL_Log("TMJMap: tsx invalid"); return false; }
-            auto p1 = xml.find('>', p0);    if (p1 == std::string::npos) { SDL_Log("TMJMap: tsx invalid"); return false; }
-            std::string tstag = xml.substr(p0, p1 - p0 + 1);
-
-            // <image .../>
-            auto i0 = xml.find("<image"); if (i0 == std::string::npos) { SDL_Log("TMJMap: tsx missing <image>"); return false; }
-            auto i1 = xml.find('>', i0);  if (i1 == std::string::npos) { SDL_Log("TMJMap: tsx invalid <image>"); return false; }
-            std::string imgtag = xml.substr(i0, i1 - i0 + 1);
-
-            // znitelikler
-            int tw = getAttrInt(tstag, "tilewidth", m_tileW);
-            int th = getAttrInt(tstag, "tileheight", m_tileH);
-            int mar = getAttrInt(tstag, "margin", 0);
-            int sp = getAttrInt(tstag, "spacing", 0);
-            int cols = getAttrInt(tstag, "columns", 0);
-
-            std::string imgRel = getAttr(imgtag, "source");
-            std::string imgPath = imgRel;
-            if (!m_baseDir.empty() && !imgRel.empty()) imgPath = m_baseDir + imgRel;
-
-            // Uygula
-            m_tileW = tw; m_tileH = th; m_margin = mar; m_spacing = sp; m_columns = cols;
-            image = imgPath;
-
-            SDL_Log("TMJMap: tsx parsed (tw=%d th=%d margin=%d spacing=%d columns=%d image=%s)",
-                m_tileW, m_tileH, m_margin, m_spacing, m_columns, image.c_str());
-        }
-        else {
-            SDL_Log("TMJMap: tileset has neither image nor source");
-            return false;
+        buildStaticCaches(r);
+        return true;
+    }
+
+    bool TMJMap::bake(const std::string& tmjPath, const std::string& outPath)
+    {
+        TMJMap m;
+        return m.parse(tmjPath) && m.saveBaked(outPath.empty() ? bakedPathFor(tmjPath) : outPath, tmjPath);
+    }
+
+    // Isim -> indeks (ayni isimde ilk trigger), sonra door hedefleri
+    void TMJMap::resolveTriggers()
+    {
+        m_symTrigger.assign(m_syms.size(), -1);
+        for (int i = (int)m_triggers.size() - 1; i >= 0; --i)
+            if (m_triggerProps[i].name > 0) m_symTrigger[m_triggerProps[i].name] = i;
+        for (int i = 0; i < (int)m_triggers.size(); ++i) {
+            TriggerProps& p = m_triggerProps[i];
+            p.target = findTrigger(p.targetName);
+            if (m_triggers[i].type == TriggerType::Door && p.targetName > 0 && p.target < 0)
+                SDL_Log("WARN: door target not found: %s", m_syms.str(p.targetName).c_str());
         }
+    }
 
+    bool TMJMap::finishLoad(SDL_Renderer* r)
+    {
         // Grseli ykle (iki deneme: olduu gibi, sonra baseDir ile)
-        std::string try1 = image;
-        std::string try2 = m_baseDir.empty() ? image : (m_baseDir + image);
+        std::string try1 = m_imagePath;
+        std::string try2 = m_baseDir.empty() ? m_imagePath : (m_baseDir + m_imagePath);
         bool ok = m_tileset.loadFromFile(r, try1);
         if (!ok && try2 != try1) {
             ok = m_tileset.loadFromFile(r, try2);
@@ -165,443 +134,182 @@ namespace Erlik {
             SDL_Log("TMJMap: tileset yuklenemedi (tried \"%s\" and \"%s\")", try1.c_str(), try2.c_str());
             return false;
         }
+        return buildRenderData(r);
+    }
 
-        // --- Parse object layer "triggers" ---
-        m_triggers.clear();
-        if (j.contains("layers") && j["layers"].is_array()) {
-            for (const auto& L : j["layers"]) {
-                if (L.value("type", "") != "objectgroup") continue;
-                if (tolower_copy(L.value("name", "")) != "triggers") continue;
-                if (!L.contains("objects") || !L["objects"].is_array()) continue;
-
-                for (const auto& O : L["objects"]) {
-                    Trigger t;
-                    t.id = O.value("id", 0);
-                    t.name = O.value("name", "");
-                    t.type = tolower_copy(O.value("type", ""));
-                    t.x = O.value("x", 0.0f);
-                    t.y = O.value("y", 0.0f);
-                    t.w = O.value("width", 0.0f);
-                    t.h = O.value("height", 0.0f);
-                    t.once = json_bool_or(O, "once", false);
-                    t.target = json_str_or(O, "target", "");
-                    t.message = json_str_or(O, "message", "");
-                    t.zoom = json_float_or(O, "zoom", 0.0f);
-                    // door props (opsiyonel)
-                    t.sfx = json_str_or(O, "sfx", "");
-                    t.fadeInMs = json_float_or(O, "fadeInMs", 0.0f);
-                    t.fadeOutMs = json_float_or(O, "fadeOutMs", 0.0f);
-                    t.shake = json_float_or(O, "shake", 0.0f);
-
-                    // keys/locked
-                    t.giveKey = json_str_or(O, "giveKey", "");
-                    t.requiresKey = json_str_or(O, "requiresKey", "");
-                    t.consumeKey = json_bool_or(O, "consumeKey", true);
-                    t.lockedMsg = json_str_or(O, "lockedMsg", "");
-                    t.unlockMsg = json_str_or(O, "unlockMsg", "");
-                    t.lockedSfx = json_str_or(O, "lockedSfx", "");
-                    t.unlockSfx = json_str_or(O, "unlockSfx", "");
-
-                    // music region props (opsiyonel)
-                    t.music = json_str_or(O, "music", "");
-                    t.exitMusic = json_str_or(O, "exitMusic", "");
-                    t.musicVol = json_float_or(O, "musicVol", 1.0f);
-                    t.musicFadeMs = json_float_or(O, "musicFadeMs", 0.0f);
-                    t.musicFadeInMs = json_float_or(O, "musicFadeInMs", 0.0f);
-                    t.musicFadeOutMs = json_float_or(O, "musicFadeOutMs", 0.0f);
-
-                    // fallback: sadece musicFadeMs verilmise iki tarafa da uygula
-                    if (t.musicFadeInMs <= 0.f && t.musicFadeOutMs <= 0.f && t.musicFadeMs > 0.f) {
-                        t.musicFadeInMs = t.musicFadeMs;
-                        t.musicFadeOutMs = t.musicFadeMs;
-                    }
-
-
-                    if (!t.type.empty() && t.w > 0 && t.h > 0)
-                        m_triggers.push_back(std::move(t));
-
-                    if (!t.giveKey.empty())     t.giveKey = tolower_copy(t.giveKey);
-                    if (!t.requiresKey.empty()) t.requiresKey = tolower_copy(t.requiresKey);
-                }
-            }
-        }
-        SDL_Log("INFO: TMJ triggers loaded: %d", (int)m_triggers.size());
-
-
-        // --- Katmanlar oku ---
-        // --- Katmanlar oku ---
-        m_layers.clear();
-        if (j.contains("layers") && j["layers"].is_array()) {
-            for (const auto& lj : j["layers"]) {
-                if (lj.value("type", std::string()) != "tilelayer") continue;
-
-                Layer L;
-                L.name = lj.value("name", std::string());
-                L.visible = lj.value("visible", true);
-                L.opacity = (float)lj.value("opacity", 1.0);
-                L.offsetX = (float)lj.value("offsetx", 0.0);
-                L.offsetY = (float)lj.value("offsety", 0.0);
-                if (lj.contains("parallaxx")) L.parallaxX = (float)lj["parallaxx"].get<double>();
-                if (lj.contains("parallaxy")) L.parallaxY = (float)lj["parallaxy"].get<double>();
-
-                // Data
-                const auto& arr = lj["data"];
-                L.data.resize(arr.size());
-                for (size_t i = 0; i < arr.size(); ++i) L.data[i] = arr[i].get<uint32_t>();
-
-                // (ZATEN VARSA) Layer properties: collision/oneway (bool)
-                if (lj.contains("properties") && lj["properties"].is_array()) {
-                    for (const auto& pj : lj["properties"]) {
-                        std::string pname = pj.value("name", std::string());
-                        if (!pj.contains("value")) continue;
-                        
-                            // --- bool bayraklar ---
-                            if (pj["value"].is_boolean()) {
-                            bool pval = pj["value"].get<bool>();
-                            if (pname == "collision" && pval) L.propCollision = true;
-                            if (pname == "oneway" && pval) L.propOneWay = true;
-                            if (pname == "fg" && pval) L.propFG = true;
-                            if (pname == "static" && pval) L.propStatic = true;
-                            continue;
-                            
-                        }
-                        // --- string preset ---
-                            if (pj["value"].is_string()) {
-                            std::string sval = pj["value"].get<std::string>();
-                                                        // normalletir
-                                for (auto& c : sval) c = (char)std::tolower((unsigned char)c);
-                            if (pname == "preset") {
-                                L.preset = sval; // uygulamay birazdan yapacaz
-                                
-                            }
-                            continue;
-                        }
-                            // --- saysal override'lar ---
-                            if (pj["value"].is_number()) {
-                            double d = pj["value"].get<double>();
-                            if (pname == "parallaxx") L.parallaxX = (float)d;
-                            if (pname == "parallaxy") L.parallaxY = (float)d;
-                            if (pname == "offsetx")   L.offsetX = (float)d;
-                            if (pname == "offsety")   L.offsetY = (float)d;
-                            if (pname == "opacity")   L.opacity = (float)d;
-                            continue;
-                        }
-                    }
-                }
-
-                // --- Editor-side Parallax Presets ---
-                if (!L.preset.empty()) {
-                    const std::string & p = L.preset;
-                    // nerilen isimler:
-                    // "bg_sky", "bg_far", "bg_mid", "bg_near", "game", "fg"
-                    if (p == "bg_sky") { L.parallaxX = 0.20f; L.parallaxY = 0.10f; /*L.opacity=1.0f;*/ }
-                    else if (p == "bg_far") { L.parallaxX = 0.40f; L.parallaxY = 0.30f; }
-                    else if (p == "bg_mid") { L.parallaxX = 0.65f; L.parallaxY = 0.60f; }
-                    else if (p == "bg_near") { L.parallaxX = 0.85f; L.parallaxY = 0.85f; }
-                    else if (p == "game") { L.parallaxX = 1.00f; L.parallaxY = 1.00f; }
-                    else if (p == "fg") { L.parallaxX = 1.00f; L.parallaxY = 1.00f; L.propFG = true; }
-                    // steyen layer property ile (parallaxx/parallaxy) preset'in stn ezebilir.
-                }
-
-                // SMDEN otomatik bayraklar (property eklemeyi unutsan da alsn)
-                {
-                    std::string lname = L.name;
-                    std::transform(lname.begin(), lname.end(), lname.begin(),
-                        [](unsigned char c) { return (char)std::tolower(c); });
-
-                    if (lname == "fg" || lname == "foreground")
-                        L.propFG = true;
-
-                    if (lname == "collision" || lname == "collisions" || lname == "solid")
-                        L.propCollision = true;
-
-                    if (lname == "oneway" || lname == "one-way" || lname == "platforms")
-                        L.propOneWay = true;
-                }
-                m_layers.push_back(std::move(L));
-            }
-        }
-
-        SDL_Log("TMJMap: map=%dx%d tile=%dx%d layers=%zu firstgid=%u columns=%d",
-            m_mapCols, m_mapRows, m_tileW, m_tileH, m_layers.size(),
-            (unsigned)m_firstGid, m_columns);
-
-        // Statik cacheleri ina et (destekliyse)
+    bool TMJMap::buildRenderData(SDL_Renderer* r)
+    {
+        // Chunk draw list'leri + statik cache'leri insa et (destekliyse)
+        buildDrawLists();
         buildStaticCaches(r);
         return (m_mapCols > 0 && m_mapRows > 0 && m_tileset.sdl() != nullptr);
     }
 
 
     void TMJMap::draw(Renderer2D& r2d) const {
+        drawLayers(r2d, DrawPass::All);       // hepsi (debug, fizik katmanlari dahil)
+    }
+
+    void TMJMap::drawBelowPlayer(Renderer2D& r2d) const {
+        drawLayers(r2d, DrawPass::Below);     // fg=false
+    }
+
+    void TMJMap::drawAbovePlayer(Renderer2D& r2d) const {
+        drawLayers(r2d, DrawPass::Above);     // fg=true
+    }
+
+    void TMJMap::drawLayers(Renderer2D& r2d, DrawPass pass) const {
         if (!m_tileset.sdl()) return;
 
-        // Ana kamera
+        // Ana kamera (aktif viewport'un kamerasi olabilir)
         const Camera2D base = r2d.camera();
         int vw, vh; r2d.outputSize(vw, vh);
 
-        // Tileset stun says
-        int tilesPerRow = (m_columns > 0) ? m_columns : (m_tileset.width() / m_tileW);
+        const float halfW = m_tileW * 0.5f, halfH = m_tileH * 0.5f;
+        const float chunkW = (float)(CHUNK_TILES * m_tileW);
+        const float chunkH = (float)(CHUNK_TILES * m_tileH);
 
-        // Her katman iin
         for (const auto& L : m_layers) {
             if (!L.visible || L.opacity <= 0.f) continue;
+            if (pass != DrawPass::All) {
+                // Fizik katmanlarini ASLA cizme
+                if (L.propCollision || L.propOneWay) continue;
+                if ((pass == DrawPass::Above) != L.propFG) continue;
+            }
 
-            // Parallax iin katmana zel kamera
+            // Parallax icin katmana ozel kamera
             Camera2D cam = base;
             cam.x = base.x * L.parallaxX;
             cam.y = base.y * L.parallaxY;
-
             r2d.setCamera(cam);
 
-      
-            // Eer statik cache varsa tek blit ile iz ve devam et
+            const Uint8 alpha = (Uint8)std::round(std::clamp(L.opacity, 0.f, 1.f) * 255.f);
+
+            // Statik cache varsa tek blit ile ciz ve devam et
             if (L.propStatic && L.cacheTex.sdl()) {
-                Uint8 alpha = (Uint8)std::round(std::clamp(L.opacity, 0.f, 1.f) * 255.f);
-                L.cacheTex.setAlpha(alpha);
-                // Tm harita boyutunda cache (merkezden iziyoruz)
+                r2d.setTextureAlpha(L.cacheTex.sdl(), alpha);
+                // Tum harita boyutunda cache (merkezden ciziyoruz)
                 const float mapW = (float)(m_mapCols * m_tileW);
                 const float mapH = (float)(m_mapRows * m_tileH);
                 const float cx = mapW * 0.5f + L.offsetX;
                 const float cy = mapH * 0.5f + L.offsetY;
                 r2d.drawTextureSDL(L.cacheTex.sdl(), nullptr, cx, cy, 1.0f, 0.0f, SDL_FLIP_NONE);
-                L.cacheTex.setAlpha(255);
+                r2d.setTextureAlpha(L.cacheTex.sdl(), 255);
                 continue;
-                
             }
+            if (L.chunks.empty()) continue;
 
-            // Culling cach yoksa normal yol ile yap
-            float left = cam.x, top = cam.y;
-            float right = cam.x + vw / cam.zoom, bottom = cam.y + vh / cam.zoom;
-            int tx0 = (int)std::floor(left / m_tileW);
-            int ty0 = (int)std::floor(top / m_tileH);
-            int tx1 = (int)std::floor((right - 1) / m_tileW);
-            int ty1 = (int)std::floor((bottom - 1) / m_tileH);
-            if (tx0 < 0) tx0 = 0; if (ty0 < 0) ty0 = 0;
-            if (tx1 >= m_mapCols) tx1 = m_mapCols - 1; if (ty1 >= m_mapRows) ty1 = m_mapRows - 1;
-
-            // Opacity (alpha mod)
-            Uint8 alpha = (Uint8)std::round(std::clamp(L.opacity, 0.f, 1.f) * 255.f);
-            SDL_SetTextureAlphaMod(m_tileset.sdl(), alpha);
-
-            for (int ty = ty0; ty <= ty1; ++ty) {
-                for (int tx = tx0; tx <= tx1; ++tx) {
-                    size_t idx = (size_t)ty * (size_t)m_mapCols + (size_t)tx;
-                    uint32_t gidRaw = (idx < L.data.size()) ? L.data[idx] : 0u;
-                    if (gidRaw == 0u) continue;
-
-                    // Flip bayraklar ayrtr
-                    uint32_t gid = gidRaw & GID_MASK;
-                    const bool flipH = (gidRaw & FLIP_H) != 0;
-                    const bool flipV = (gidRaw & FLIP_V) != 0;
-                    // Diagonal flip'i imdilik grmezden geliyoruz
-
-                    int local = (int)gid - (int)m_firstGid; // tileset ii index
-                    if (local < 0) continue;
+            // Gorunen dunya dikdortgeni (TileCmd merkezleri offset'i zaten icerir)
+            const float left = cam.x, top = cam.y;
+            const float right = cam.x + vw / cam.zoom, bottom = cam.y + vh / cam.zoom;
 
-                    int sx = m_margin + (local % tilesPerRow) * (m_tileW + m_spacing);
-                    int sy = m_margin + (local / tilesPerRow) * (m_tileH + m_spacing);
-
-                    SDL_Rect src{ sx, sy, m_tileW, m_tileH };
+            // Chunk seviyesinde culling
+            int cx0 = (int)std::floor((left - L.offsetX) / chunkW);
+            int cy0 = (int)std::floor((top - L.offsetY) / chunkH);
+            int cx1 = (int)std::floor((right - L.offsetX - 1) / chunkW);
+            int cy1 = (int)std::floor((bottom - L.offsetY - 1) / chunkH);
+            cx0 = std::max(cx0, 0); cy0 = std::max(cy0, 0);
+            cx1 = std::min(cx1, L.chunkCols - 1); cy1 = std::min(cy1, L.chunkRows - 1);
+            if (cx1 < cx0 || cy1 < cy0) continue;
 
-                    float cx = tx * (float)m_tileW + m_tileW * 0.5f + L.offsetX;
-                    float cy = ty * (float)m_tileH + m_tileH * 0.5f + L.offsetY;
-
-                    SDL_RendererFlip flip = SDL_FLIP_NONE;
-                    if (flipH) flip = (SDL_RendererFlip)(flip | SDL_FLIP_HORIZONTAL);
-                    if (flipV) flip = (SDL_RendererFlip)(flip | SDL_FLIP_VERTICAL);
-
-                    r2d.drawTextureRegion(m_tileset, src, cx, cy, 1.0f, 0.0f, flip);
+            // Opacity (alpha mod)
+            r2d.setTextureAlpha(m_tileset.sdl(), alpha);
+
+            for (int chy = cy0; chy <= cy1; ++chy) {
+                for (int chx = cx0; chx <= cx1; ++chx) {
+                    for (const TileCmd& c : L.chunks[(size_t)chy * L.chunkCols + chx]) {
+                        // Kenar chunk'lar icin tile seviyesinde culling
+                        if (c.cx + halfW <= left || c.cx - halfW >= right) continue;
+                        if (c.cy + halfH <= top || c.cy - halfH >= bottom) continue;
+                        r2d.drawTextureRegion(m_tileset, c.src, c.cx, c.cy, 1.0f, 0.0f, c.flip);
+                    }
                 }
             }
 
-            // Alpha modunu sfrla
-            SDL_SetTextureAlphaMod(m_tileset.sdl(), 255);
+            // Alpha modunu sifirla
+            r2d.setTextureAlpha(m_tileset.sdl(), 255);
         }
 
-
-        // Ana kameray geri koy
+        // Ana kamerayi geri koy
         r2d.setCamera(base);
     }
-    void TMJMap::drawBelowPlayer(Renderer2D& r2d) const {
-        if (!m_tileset.sdl()) return;
-        const Camera2D base = r2d.camera();
-        int vw, vh; r2d.outputSize(vw, vh);
-        int tilesPerRow = (m_columns > 0) ? m_columns : (m_tileset.width() / m_tileW);
-
-        for (const auto& L : m_layers) {
-            if (!L.visible || L.opacity <= 0.f) continue;
-
-            // Fizik katmanlarn ASLA izme
-            if (L.propCollision || L.propOneWay) continue;
-
-            // Sadece FG OLMAYANLAR burada izilecek
-            if (L.propFG) continue;
-
-            Camera2D cam = base;
-            cam.x = base.x * L.parallaxX;
-            cam.y = base.y * L.parallaxY;
-
-            r2d.setCamera(cam);
-
-            // Eer statik cache varsa tek blit ile iz ve devam et
-            if (L.propStatic && L.cacheTex.sdl()) {
-                Uint8 alpha = (Uint8)std::round(std::clamp(L.opacity, 0.f, 1.f) * 255.f);
-                L.cacheTex.setAlpha(alpha);
-                // Tm harita boyutunda cache (merkezden iziyoruz)
-                const float mapW = (float)(m_mapCols * m_tileW);
-                const float mapH = (float)(m_mapRows * m_tileH);
-                const float cx = mapW * 0.5f + L.offsetX;
-                const float cy = mapH * 0.5f + L.offsetY;
-                r2d.drawTextureSDL(L.cacheTex.sdl(), nullptr, cx, cy, 1.0f, 0.0f, SDL_FLIP_NONE);
-                L.cacheTex.setAlpha(255);
-                continue;
-
-            }
-
-            float left = cam.x, top = cam.y;
-            float right = cam.x + vw / cam.zoom, bottom = cam.y + vh / cam.zoom;
-            int tx0 = (int)std::floor(left / m_tileW);
-            int ty0 = (int)std::floor(top / m_tileH);
-            int tx1 = (int)std::floor((right - 1) / m_tileW);
-            int ty1 = (int)std::floor((bottom - 1) / m_tileH);
-            if (tx0 < 0) tx0 = 0; if (ty0 < 0) ty0 = 0;
-            if (tx1 >= m_mapCols) tx1 = m_mapCols - 1; if (ty1 >= m_mapRows) ty1 = m_mapRows - 1;
-
-            Uint8 alpha = (Uint8)std::round(std::clamp(L.opacity, 0.f, 1.f) * 255.f);
-            SDL_SetTextureAlphaMod(m_tileset.sdl(), alpha);
-
-            for (int ty = ty0; ty <= ty1; ++ty) {
-                for (int tx = tx0; tx <= tx1; ++tx) {
-                    size_t idx = (size_t)ty * (size_t)m_mapCols + (size_t)tx;
-                    uint32_t gidRaw = (idx < L.data.size()) ? L.data[idx] : 0u;
-                    if (gidRaw == 0u) continue;
-
-                    uint32_t gid = gidRaw & GID_MASK;
-                    const bool flipH = (gidRaw & FLIP_H) != 0;
-                    const bool flipV = (gidRaw & FLIP_V) != 0;
 
-                    int local = (int)gid - (int)m_firstGid;
-                    if (local < 0) continue;
-
-                    int sx = m_margin + (local % tilesPerRow) * (m_tileW + m_spacing);
-                    int sy = m_margin + (local / tilesPerRow) * (m_tileH + m_spacing);
-                    SDL_Rect src{ sx, sy, m_tileW, m_tileH };
-
-                    float cx = tx * (float)m_tileW + m_tileW * 0.5f + L.offsetX;
-                    float cy = ty * (float)m_tileH + m_tileH * 0.5f + L.offsetY;
-
-                    SDL_RendererFlip flip = SDL_FLIP_NONE;
-                    if (flipH) flip = (SDL_RendererFlip)(flip | SDL_FLIP_HORIZONTAL);
-                    if (flipV) flip = (SDL_RendererFlip)(flip | SDL_FLIP_VERTICAL);
-
-                    r2d.drawTextureRegion(m_tileset, src, cx, cy, 1.0f, 0.0f, flip);
-                }
+    void TMJMap::buildChunk(Layer& L, int chx, int chy) const {
+        auto& cmds = L.chunks[(size_t)chy * L.chunkCols + chx];
+        cmds.clear();
+        const int tilesPerRow = (m_columns > 0) ? m_columns : (m_tileset.width() / std::max(1, m_tileW));
+        if (tilesPerRow <= 0) return;
+
+        const int tx0 = chx * CHUNK_TILES, ty0 = chy * CHUNK_TILES;
+        const int tx1 = std::min(tx0 + CHUNK_TILES, m_mapCols);
+        const int ty1 = std::min(ty0 + CHUNK_TILES, m_mapRows);
+        for (int ty = ty0; ty < ty1; ++ty) {
+            for (int tx = tx0; tx < tx1; ++tx) {
+                size_t idx = (size_t)ty * (size_t)m_mapCols + (size_t)tx;
+                uint32_t gidRaw = (idx < L.data.size()) ? L.data[idx] : 0u;
+                if (gidRaw == 0u) continue;
+
+                // Flip bayraklarini ayristir (diagonal flip simdilik yok sayiliyor)
+                uint32_t gid = gidRaw & GID_MASK;
+                int local = (int)gid - (int)m_firstGid; // tileset ici index
+                if (local < 0) continue;
+
+                TileCmd c;
+                c.src.x = m_margin + (local % tilesPerRow) * (m_tileW + m_spacing);
+                c.src.y = m_margin + (local / tilesPerRow) * (m_tileH + m_spacing);
+                c.src.w = m_tileW; c.src.h = m_tileH;
+                c.cx = tx * (float)m_tileW + m_tileW * 0.5f + L.offsetX;
+                c.cy = ty * (float)m_tileH + m_tileH * 0.5f + L.offsetY;
+                int flip = SDL_FLIP_NONE;
+                if (gidRaw & FLIP_H) flip |= SDL_FLIP_HORIZONTAL;
+                if (gidRaw & FLIP_V) flip |= SDL_FLIP_VERTICAL;
+                c.flip = (SDL_RendererFlip)flip;
+                cmds.push_back(c);
             }
-            SDL_SetTextureAlphaMod(m_tileset.sdl(), 255);
         }
-        r2d.setCamera(base);
     }
 
-    void TMJMap::drawAbovePlayer(Renderer2D& r2d) const {
-        if (!m_tileset.sdl()) return;
-        const Camera2D base = r2d.camera();
-        int vw, vh; r2d.outputSize(vw, vh);
-        int tilesPerRow = (m_columns > 0) ? m_columns : (m_tileset.width() / m_tileW);
-
-        for (const auto& L : m_layers) {
-            if (!L.visible || L.opacity <= 0.f) continue;
-
-            // Fizik katmanlarn ASLA izme
-            if (L.propCollision || L.propOneWay) continue;
-
-            // Sadece FG OLANLAR burada izilecek
-            if (!L.propFG) continue;
-
-            Camera2D cam = base;
-            cam.x = base.x * L.parallaxX;
-            cam.y = base.y * L.parallaxY;
-
-            r2d.setCamera(cam);
-
-            // Eer statik cache varsa tek blit ile iz ve devam et
-            if (L.propStatic && L.cacheTex.sdl()) {
-                Uint8 alpha = (Uint8)std::round(std::clamp(L.opacity, 0.f, 1.f) * 255.f);
-                L.cacheTex.setAlpha(alpha);
-                // Tm harita boyutunda cache (merkezden iziyoruz)
-                const float mapW = (float)(m_mapCols * m_tileW);
-                const float mapH = (float)(m_mapRows * m_tileH);
-                const float cx = mapW * 0.5f + L.offsetX;
-                const float cy = mapH * 0.5f + L.offsetY;
-                r2d.drawTextureSDL(L.cacheTex.sdl(), nullptr, cx, cy, 1.0f, 0.0f, SDL_FLIP_NONE);
-                L.cacheTex.setAlpha(255);
-                continue;
-
-            }
-
-            float left = cam.x, top = cam.y;
-            float right = cam.x + vw / cam.zoom, bottom = cam.y + vh / cam.zoom;
-            int tx0 = (int)std::floor(left / m_tileW);
-            int ty0 = (int)std::floor(top / m_tileH);
-            int tx1 = (int)std::floor((right - 1) / m_tileW);
-            int ty1 = (int)std::floor((bottom - 1) / m_tileH);
-            if (tx0 < 0) tx0 = 0; if (ty0 < 0) ty0 = 0;
-            if (tx1 >= m_mapCols) tx1 = m_mapCols - 1; if (ty1 >= m_mapRows) ty1 = m_mapRows - 1;
-
-            Uint8 alpha = (Uint8)std::round(std::clamp(L.opacity, 0.f, 1.f) * 255.f);
-            SDL_SetTextureAlphaMod(m_tileset.sdl(), alpha);
-
-            for (int ty = ty0; ty <= ty1; ++ty) {
-                for (int tx = tx0; tx <= tx1; ++tx) {
-                    size_t idx = (size_t)ty * (size_t)m_mapCols + (size_t)tx;
-                    uint32_t gidRaw = (idx < L.data.size()) ? L.data[idx] : 0u;
-                    if (gidRaw == 0u) continue;
-
-                    uint32_t gid = gidRaw & GID_MASK;
-                    const bool flipH = (gidRaw & FLIP_H) != 0;
-                    const bool flipV = (gidRaw & FLIP_V) != 0;
-
-                    int local = (int)gid - (int)m_firstGid;
-                    if (local < 0) continue;
-
-                    int sx = m_margin + (local % tilesPerRow) * (m_tileW + m_spacing);
-                    int sy = m_margin + (local / tilesPerRow) * (m_tileH + m_spacing);
-                    SDL_Rect src{ sx, sy, m_tileW, m_tileH };
-
-                    float cx = tx * (float)m_tileW + m_tileW * 0.5f + L.offsetX;
-                    float cy = ty * (float)m_tileH + m_tileH * 0.5f + L.offsetY;
-
-                    SDL_RendererFlip flip = SDL_FLIP_NONE;
-                    if (flipH) flip = (SDL_RendererFlip)(flip | SDL_FLIP_HORIZONTAL);
-                    if (flipV) flip = (SDL_RendererFlip)(flip | SDL_FLIP_VERTICAL);
-
-                    r2d.drawTextureRegion(m_tileset, src, cx, cy, 1.0f, 0.0f, flip);
+    void TMJMap::buildDrawLists() {
+        size_t total = 0;
+        for (auto& L : m_layers) {
+            L.chunkCols = (m_mapCols + CHUNK_TILES - 1) / CHUNK_TILES;
+            L.chunkRows = (m_mapRows + CHUNK_TILES - 1) / CHUNK_TILES;
+            L.chunks.assign((size_t)L.chunkCols * (size_t)L.chunkRows, {});
+            L.chunkDirty.assign(L.chunks.size(), 0);
+            L.dirtyChunks.clear();
+            L.dirtyCacheTiles.clear();
+            for (int chy = 0; chy < L.chunkRows; ++chy)
+                for (int chx = 0; chx < L.chunkCols; ++chx) {
+                    buildChunk(L, chx, chy);
+                    total += L.chunks[(size_t)chy * L.chunkCols + chx].size();
                 }
-            }
-            SDL_SetTextureAlphaMod(m_tileset.sdl(), 255);
         }
-        r2d.setCamera(base);
+        SDL_Log("TMJMap: draw lists built (%zu tiles, chunk=%d)", total, CHUNK_TILES);
+        m_pendingEdits = false;
     }
 
 
-    bool TMJMap::buildCollision(Tilemap& out,
-        const std::string& collisionLayerName,
-        const std::string& oneWayLayerName) const
+    void TMJMap::collisionGrid(const std::string& collisionLayerName, const std::string& oneWayLayerName,
+        std::vector<int>& grid, std::vector<uint8_t>& shapes, int& solids, int& oneways) const
     {
-        if (m_mapCols <= 0 || m_mapRows <= 0) return false;
-        std::vector<int> grid(m_mapCols * m_mapRows, -1);
-
-        int solids = 0, oneways = 0;
+        grid.assign((size_t)m_mapCols * m_mapRows, -1);
+        solids = oneways = 0;
+        // Sekil sadece tileset'te "shape" property'si varsa izlenir
+        shapes.clear();
+        if (!m_tileShape.empty()) shapes.assign(grid.size(), Tilemap::SHAPE_FULL);
 
         auto applyCollisionLayer = [&](const Layer& L) {
             for (size_t i = 0; i < L.data.size() && i < grid.size(); ++i) {
                 uint32_t gid = (L.data[i] & GID_MASK);
                 if (gid != 0u) { grid[i] = 0; ++solids; } // 0 = solid
+                if (gid != 0u && !shapes.empty()) shapes[i] = shapeOfGid(L.data[i]);
             }
         };
         auto applyOneWayLayer = [&](const Layer& L) {
             for (size_t i = 0; i < L.data.size() && i < grid.size(); ++i) {
                 uint32_t gid = (L.data[i] & GID_MASK);
                 if (gid != 0u) { grid[i] = 1; ++oneways; } // 1 = oneway
+                if (gid != 0u && !shapes.empty()) shapes[i] = Tilemap::SHAPE_FULL;
             }
         };
 
@@ -615,31 +323,298 @@ namespace Erlik {
             if (L.propCollision) applyCollisionLayer(L);
             if (L.propOneWay)    applyOneWayLayer(L);
         }
+    }
+
+    bool TMJMap::buildCollision(Tilemap& out,
+        const std::string& collisionLayerName,
+        const std::string& oneWayLayerName)
+    {
+        if (m_mapCols <= 0 || m_mapRows <= 0) return false;
+        m_colLayerName = collisionLayerName;
+        m_owLayerName = oneWayLayerName;
+        std::vector<int> grid;
+        std::vector<uint8_t> shapes;
+        int solids = 0, oneways = 0, shaped = 0;
+
+        if (!m_bakedCol.empty() && collisionLayerName == "collision" && oneWayLayerName == "oneway") {
+            // onbellekten: katman taramasi yok
+            grid.resize(m_bakedCol.size());
+            for (size_t i = 0; i < grid.size(); ++i) {
+                grid[i] = m_bakedCol[i];
+                solids += grid[i] == 0; oneways += grid[i] == 1;
+            }
+            shapes = m_bakedShape;
+        }
+        else collisionGrid(collisionLayerName, oneWayLayerName, grid, shapes, solids, oneways);
 
         SDL_Log("TMJMap: collision build -> solids=%d, oneways=%d (map=%dx%d)",
             solids, oneways, m_mapCols, m_mapRows);
 
         bool ok = out.adoptGrid(m_mapCols, m_mapRows, m_tileW, std::move(grid));
+        if (ok && !shapes.empty()) {
+            for (size_t i = 0; i < shapes.size(); ++i)
+                if (shapes[i] != Tilemap::SHAPE_FULL) {
+                    out.setShape((int)(i % m_mapCols), (int)(i / m_mapCols), shapes[i]);
+                    ++shaped;
+                }
+            SDL_Log("TMJMap: collision shapes=%d", shaped);
+        }
+        if (ok) {
+            out.bakeRects();   // debug view / AI / ray sorgulari icin birlesik dikdortgenler
+            SDL_Log("TMJMap: collision rects=%zu", out.rects().size());
+        }
         return ok && (solids > 0 || oneways > 0);
     }
 
     
 
+    uint8_t TMJMap::shapeOfGid(uint32_t rawGid) const {
+        const uint32_t gid = rawGid & GID_MASK;
+        if (gid < m_firstGid || gid - m_firstGid >= m_tileShape.size()) return Tilemap::SHAPE_FULL;
+        const uint8_t s = m_tileShape[gid - m_firstGid];
+        return (rawGid & FLIP_H) ? Tilemap::mirrorShape(s) : s;
+    }
+
+    int TMJMap::collisionClass(int tx, int ty, uint8_t* shape) const {
+        const size_t idx = (size_t)ty * (size_t)m_mapCols + (size_t)tx;
+        auto has = [&](const Layer& L) { return idx < L.data.size() && (L.data[idx] & GID_MASK) != 0u; };
+        int c = -1;
+        uint8_t s = Tilemap::SHAPE_FULL;
+        // buildCollision ile ayni sira: once isimler, sonra property'ler (sonra gelen ezer)
+        for (const auto& L : m_layers) {
+            if (L.name == m_colLayerName && has(L)) { c = 0; s = shapeOfGid(L.data[idx]); }
+            if (L.name == m_owLayerName && has(L))  { c = 1; s = Tilemap::SHAPE_FULL; }
+        }
+        for (const auto& L : m_layers) {
+            if (L.propCollision && has(L)) { c = 0; s = shapeOfGid(L.data[idx]); }
+            if (L.propOneWay && has(L))    { c = 1; s = Tilemap::SHAPE_FULL; }
+        }
+        if (shape) *shape = s;
+        return c;
+    }
+
+    int TMJMap::layerIndex(const std::string& name) const {
+        for (size_t i = 0; i < m_layers.size(); ++i)
+            if (m_layers[i].name == name) return (int)i;
+        return -1;
+    }
+
+    uint32_t TMJMap::tileAt(int layer, int tx, int ty) const {
+        if (layer < 0 || layer >= (int)m_layers.size()) return 0u;
+        if (tx < 0 || ty < 0 || tx >= m_mapCols || ty >= m_mapRows) return 0u;
+        const auto& data = m_layers[layer].data;
+        const size_t idx = (size_t)ty * (size_t)m_mapCols + (size_t)tx;
+        return idx < data.size() ? data[idx] : 0u;
+    }
+
+    bool TMJMap::setTile(int layer, int tx, int ty, uint32_t gid, Tilemap* collision) {
+        if (layer < 0 || layer >= (int)m_layers.size()) return false;
+        if (tx < 0 || ty < 0 || tx >= m_mapCols || ty >= m_mapRows) return false;
+        Layer& L = m_layers[layer];
+        const size_t idx = (size_t)ty * (size_t)m_mapCols + (size_t)tx;
+        if (idx >= L.data.size()) return false;
+        if (L.data[idx] == gid) return true;
+        L.data[idx] = gid;
+
+        // Fizik katmani: hucre sinifini tum katmanlardan yeniden hesapla (tek hucre)
+        const bool physics = L.propCollision || L.propOneWay || L.name == m_colLayerName || L.name == m_owLayerName;
+        if (physics && !m_bakedCol.empty()) { m_bakedCol.clear(); m_bakedShape.clear(); } // artik katmanlardan
+        if (physics && collision) {
+            uint8_t shape = Tilemap::SHAPE_FULL;
+            collision->setCell(tx, ty, collisionClass(tx, ty, &shape));
+            collision->setShape(tx, ty, shape);
+        }
+
+        // Cizim: sadece kirli isaretle, flushEdits toplu yeniler
+        if (!L.chunkDirty.empty()) {
+            const int c = (ty / CHUNK_TILES) * L.chunkCols + (tx / CHUNK_TILES);
+            if (!L.chunkDirty[c]) { L.chunkDirty[c] = 1; L.dirtyChunks.push_back(c); }
+        }
+        if (L.cacheTex.sdl()) L.dirtyCacheTiles.push_back((int)idx);
+        m_pendingEdits = true;
+        return true;
+    }
+
+    void TMJMap::flushEdits(SDL_Renderer* r, Tilemap* collision) {
+        if (collision && collision->rectsDirty()) collision->bakeDirtyRects();
+        if (!m_pendingEdits) return;
+        m_pendingEdits = false;
+        for (auto& L : m_layers) {
+            for (int c : L.dirtyChunks) {
+                buildChunk(L, c % L.chunkCols, c / L.chunkCols);
+                L.chunkDirty[c] = 0;
+            }
+            L.dirtyChunks.clear();
+            if (!L.dirtyCacheTiles.empty()) {
+                if (r) redrawCacheTiles(r, L);
+                L.dirtyCacheTiles.clear();
+            }
+        }
+    }
+
+    // Static cache'te sadece degisen hucreler: once seffaf sil (blend yok), sonra tile'i bas.
+    // Katman basina tek render-target gecisi; hedef, blend modu ve cizim rengi geri yuklenir.
+    void TMJMap::redrawCacheTiles(SDL_Renderer* r, Layer& L) {
+        const int tilesPerRow = (m_columns > 0) ? m_columns : (m_tileset.width() / std::max(1, m_tileW));
+        if (tilesPerRow <= 0 || !m_tileset.sdl()) return;
+
+        auto& tiles = L.dirtyCacheTiles;
+        std::sort(tiles.begin(), tiles.end());
+        tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+
+        SDL_Texture* prev = SDL_GetRenderTarget(r);
+        SDL_BlendMode prevBlend = SDL_BLENDMODE_BLEND;
+        SDL_GetRenderDrawBlendMode(r, &prevBlend);
+        Uint8 pr = 0, pg = 0, pb = 0, pa = 0;
+        SDL_GetRenderDrawColor(r, &pr, &pg, &pb, &pa);
+
+        SDL_SetRenderTarget(r, L.cacheTex.sdl());
+        SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(r, 0, 0, 0, 0);
+        for (int idx : tiles) {
+            const int tx = idx % m_mapCols, ty = idx / m_mapCols;
+            const SDL_FRect dst{
+                tx * (float)m_tileW + L.offsetX,
+                ty * (float)m_tileH + L.offsetY,
+                (float)m_tileW, (float)m_tileH
+            };
+            SDL_RenderFillRectF(r, &dst);
+
+            const uint32_t gidRaw = L.data[idx];
+            const int local = (int)(gidRaw & GID_MASK) - (int)m_firstGid;
+            if (gidRaw == 0u || local < 0) continue;
+            const SDL_Rect src{
+                m_margin + (local % tilesPerRow) * (m_tileW + m_spacing),
+                m_margin + (local / tilesPerRow) * (m_tileH + m_spacing),
+                m_tileW, m_tileH };
+            int flip = SDL_FLIP_NONE;
+            if (gidRaw & FLIP_H) flip |= SDL_FLIP_HORIZONTAL;
+            if (gidRaw & FLIP_V) flip |= SDL_FLIP_VERTICAL;
+            SDL_RenderCopyExF(r, m_tileset.sdl(), &src, &dst, 0.0, nullptr, (SDL_RendererFlip)flip);
+        }
+        SDL_SetRenderTarget(r, prev);
+        SDL_SetRenderDrawBlendMode(r, prevBlend);
+        SDL_SetRenderDrawColor(r, pr, pg, pb, pa);
+    }
+
     void TMJMap::drawTriggersDebug(Renderer2D& r2d) const {
-        for (auto& t : m_triggers) {
+        int vw, vh; r2d.outputSize(vw, vh);
+        const Camera2D& cam = r2d.camera();
+        std::vector<int> vis; // debug cizimi: kare basina ayirma sorun degil
+        queryTriggers(cam.x, cam.y, cam.x + vw / cam.zoom, cam.y + vh / cam.zoom, vis);
+        for (int i : vis) {
+            const Trigger& t = m_triggers[i];
             SDL_Color c{ 180,120,40,90 }; // region
-            if (t.type == "checkpoint") c = SDL_Color{ 80,180,80,90 };
-            else if (t.type == "door")  c = SDL_Color{ 80,120,200,90 };
+            if (t.type == TriggerType::Checkpoint) c = SDL_Color{ 80,180,80,90 };
+            else if (t.type == TriggerType::Door)  c = SDL_Color{ 80,120,200,90 };
             r2d.fillRect(t.x, t.y, t.w, t.h, c);
         }
     }
 
     const Trigger* TMJMap::findTriggerByName(const std::string& name) const {
-        if (name.empty()) return nullptr;
+        const int i = findTrigger(m_syms.find(name));
+        return i >= 0 ? &m_triggers[i] : nullptr;
+    }
+
+    void TMJMap::buildTriggerGrid() {
+        m_trigStart.clear(); m_trigItems.clear();
+        m_trigCols = m_trigRows = 0;
+        if (m_triggers.empty()) return;
+
+        float x0 = m_triggers[0].x, y0 = m_triggers[0].y;
+        float x1 = x0 + m_triggers[0].w, y1 = y0 + m_triggers[0].h;
+        for (const auto& t : m_triggers) {
+            x0 = std::min(x0, t.x);       y0 = std::min(y0, t.y);
+            x1 = std::max(x1, t.x + t.w); y1 = std::max(y1, t.y + t.h);
+        }
+        m_trigOriginX = x0; m_trigOriginY = y0;
+        m_trigCols = (int)std::floor((x1 - x0) / TRIGGER_CELL_PX) + 1;
+        m_trigRows = (int)std::floor((y1 - y0) / TRIGGER_CELL_PX) + 1;
+
+        auto cellSpan = [&](const Trigger& t, int& cx0, int& cy0, int& cx1, int& cy1) {
+            cx0 = (int)std::floor((t.x - m_trigOriginX) / TRIGGER_CELL_PX);
+            cy0 = (int)std::floor((t.y - m_trigOriginY) / TRIGGER_CELL_PX);
+            cx1 = std::min(m_trigCols - 1, (int)std::floor((t.x + t.w - m_trigOriginX) / TRIGGER_CELL_PX));
+            cy1 = std::min(m_trigRows - 1, (int)std::floor((t.y + t.h - m_trigOriginY) / TRIGGER_CELL_PX));
+        };
+
+        // iki gecis: say, sonra yerlestir
+        m_trigStart.assign((size_t)m_trigCols * m_trigRows + 1, 0);
         for (const auto& t : m_triggers) {
-            if (t.name == name) return &t;
+            int cx0, cy0, cx1, cy1; cellSpan(t, cx0, cy0, cx1, cy1);
+            for (int cy = cy0; cy <= cy1; ++cy)
+                for (int cx = cx0; cx <= cx1; ++cx) ++m_trigStart[(size_t)cy * m_trigCols + cx + 1];
+        }
+        for (size_t c = 1; c < m_trigStart.size(); ++c) m_trigStart[c] += m_trigStart[c - 1];
+        m_trigItems.resize(m_trigStart.back());
+        std::vector<int> fill(m_trigStart.begin(), m_trigStart.end() - 1);
+        for (int i = 0; i < (int)m_triggers.size(); ++i) {
+            int cx0, cy0, cx1, cy1; cellSpan(m_triggers[i], cx0, cy0, cx1, cy1);
+            for (int cy = cy0; cy <= cy1; ++cy)
+                for (int cx = cx0; cx <= cx1; ++cx) m_trigItems[fill[(size_t)cy * m_trigCols + cx]++] = i;
+        }
+    }
+
+    void TMJMap::queryTriggerCells(float x0, float y0, float x1, float y1, std::vector<int>& out) const {
+        if (m_trigCols == 0) return;
+        const int cx0 = std::max(0, (int)std::floor((x0 - m_trigOriginX) / TRIGGER_CELL_PX));
+        const int cy0 = std::max(0, (int)std::floor((y0 - m_trigOriginY) / TRIGGER_CELL_PX));
+        const int cx1 = std::min(m_trigCols - 1, (int)std::floor((x1 - m_trigOriginX) / TRIGGER_CELL_PX));
+        const int cy1 = std::min(m_trigRows - 1, (int)std::floor((y1 - m_trigOriginY) / TRIGGER_CELL_PX));
+        if (cx0 > cx1 || cy0 > cy1) return;
+
+        const size_t first = out.size();
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const size_t c = (size_t)cy * m_trigCols + cx;
+                for (int k = m_trigStart[c]; k < m_trigStart[c + 1]; ++k) {
+                    const Trigger& t = m_triggers[m_trigItems[k]];
+                    if (t.x <= x1 && x0 <= t.x + t.w && t.y <= y1 && y0 <= t.y + t.h)
+                        out.push_back(m_trigItems[k]);
+                }
+            }
+        // birden cok hucreye yazilmis triggerlar; sira = harita sirasi (dispatch sirasi degismez)
+        if (cx0 != cx1 || cy0 != cy1) {
+            std::sort(out.begin() + first, out.end());
+            out.erase(std::unique(out.begin() + first, out.end()), out.end());
+        }
+    }
+
+    void TMJMap::queryTriggers(float x0, float y0, float x1, float y1, std::vector<int>& out) const {
+        out.clear();
+        queryTriggerCells(x0, y0, x1, y1, out);
+    }
+
+    void TMJMap::queryTriggers(const TriggerBox* boxes, int count, std::vector<int>& out, std::vector<int>& start) const {
+        out.clear();
+        start.resize((size_t)std::max(0, count) + 1);
+        start[0] = 0;
+        for (int i = 0; i < count; ++i) {
+            queryTriggerCells(boxes[i].x0, boxes[i].y0, boxes[i].x1, boxes[i].y1, out);
+            start[i + 1] = (int)out.size();
+        }
+    }
+
+    bool TMJMap::minimapColor(int tx, int ty, uint8_t& r, uint8_t& g, uint8_t& b) const {
+        if (tx < 0 || ty < 0 || tx >= m_mapCols || ty >= m_mapRows) return false;
+        const size_t idx = (size_t)ty * (size_t)m_mapCols + (size_t)tx;
+
+        // Ustten alta: ilk dolu gorunur katman kazanir
+        for (auto it = m_layers.rbegin(); it != m_layers.rend(); ++it) {
+            const Layer& L = *it;
+            if (!L.visible || L.opacity <= 0.f) continue;
+            if (L.propCollision || L.propOneWay) continue;
+            if (idx >= L.data.size() || (L.data[idx] & GID_MASK) == 0u) continue;
+
+            if (L.hasMinimapColor) { r = L.mmR; g = L.mmG; b = L.mmB; return true; }
+            // Renk verilmemis: parallax derinligine gore koyulasan gri-mavi
+            const float depth = std::clamp(std::min(L.parallaxX, L.parallaxY), 0.f, 1.f);
+            r = (uint8_t)(28 + 52 * depth);
+            g = (uint8_t)(30 + 54 * depth);
+            b = (uint8_t)(42 + 58 * depth);
+            return true;
         }
-        return nullptr;
+        return false;
     }
 
     void TMJMap::destroyCaches() {
@@ -676,6 +651,10 @@ namespace Erlik {
             }
 
             SDL_Texture* prev = SDL_GetRenderTarget(r);
+            SDL_BlendMode prevBlend = SDL_BLENDMODE_BLEND;
+            SDL_GetRenderDrawBlendMode(r, &prevBlend);
+            Uint8 pr = 0, pg = 0, pb = 0, pa = 0;
+            SDL_GetRenderDrawColor(r, &pr, &pg, &pb, &pa);
             SDL_SetRenderTarget(r, rt.sdl());
             // effaf temizle
             SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_BLEND);
@@ -715,6 +694,8 @@ namespace Erlik {
             }
 
             SDL_SetRenderTarget(r, prev);
+            SDL_SetRenderDrawBlendMode(r, prevBlend);
+            SDL_SetRenderDrawColor(r, pr, pg, pb, pa);
             L.cacheTex = std::move(rt); // move-assign
             built++;
         }
@@ -1,41 +1,75 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <memory>
 #include "Texture.h"
 #include "Renderer2D.h"
+#include "Symbols.h"
 
 namespace Erlik {
 
+    class AssetLoader;
+
+    // Trigger turu: TMJ "type" yuklemede cozulur. giveKey'li (checkpoint olmayan) her trigger Key olur.
+    enum class TriggerType : uint8_t { Region, Checkpoint, Key, Door, Custom };
+
+    enum TriggerFlags : uint8_t {
+        TRIG_ONCE = 1,          // properties.once
+        TRIG_CONSUME_KEY = 2,   // properties.consumeKey (varsayilan acik)
+        TRIG_FIRED = 4,         // once=true ve tetiklendi (hot reload'da Tiled id ile korunur)
+    };
+
+    // Sicak kayit: kare basina dokunulan her sey (rect + tur + bayraklar), 24 bayt.
+    // Olay verisi triggerProps(i), metinler triggerText(i) ayni indeksle.
     struct Trigger {
-        int         id = 0;   // Tiled object id
-        std::string type;       // "checkpoint" | "door" | "region" (lowercase)
-        std::string name;       // obje ad (ops.)
-        std::string target;     // properties.target (ops.)
-        std::string message;    // properties.message (ops.)
-        bool        once = false; // properties.once
         float       x = 0, y = 0, w = 0, h = 0; // world-space rect (top-left + size)
-        float       zoom = 0.0f;   // Region iin kamera zoom deeri
-        // Door-specific (opsiyonel)
-        std::string sfx;       // alnacak sfx ad
-        float       fadeInMs = 0.f;   // ms
-        float       fadeOutMs = 0.f;   // ms
-        float       shake = 0.f;   // 0..1
-        // --- Music Region (opsiyonel) ---
-        std::string music;       // enter: alnacak mzik ad (Audio::loadMusic ile yklenmi)
-        std::string exitMusic;   // exit: bo deilse buna dn (bosa nceki mzie dner)
-        float       musicVol = 1.0f;   // 0..1
-        float       musicFadeMs = 0.0f;     // (ops.) tek deer verildiyse fallback
-        float       musicFadeInMs = 0.0f;   // (ops.) ayr fade-in
-        float       musicFadeOutMs = 0.0f;  // (ops.) ayr fade-out
-
-        // --- Key / Locked Doors ---
-        std::string giveKey;        // bu triggere girince verilecek anahtar ad (rn. "red")
-        std::string requiresKey;    // bu kapy amak iin gereken anahtar (rn. "red")
-        bool consumeKey = true; // anahtar kullandktan sonra silinsin mi?
-        std::string lockedMsg;      // kilitliyken gsterilecek mesaj
-        std::string unlockMsg;      // alrken gsterilecek mesaj (ops.)
-        std::string lockedSfx;      // kilitli sesi (ops.), default: "locked"
-        std::string unlockSfx;      // kilit ama sesi (ops.), default: "door"
+        TriggerType type = TriggerType::Region;
+        uint8_t     flags = 0;
+        int         id = 0;     // Tiled object id
+    };
+
+    // Olay verisi (enter/exit aninda okunur). String'ler SymbolTable id'si (0 = yok);
+    // anahtarlar kucuk harfe indirgenmis, sfx varsayilanlari yuklemede doldurulmus.
+    struct TriggerProps {
+        int   target = -1;      // door: hedef trigger indeksi (yuklemede cozulur; yoksa -1)
+        Sym   name = 0, targetName = 0;
+        Sym   giveKey = 0;      // Key: verilecek anahtar (giveKey, yoksa obje adi)
+        Sym   requiresKey = 0;
+        Sym   sfx = 0, lockedSfx = 0, unlockSfx = 0;
+        Sym   music = 0, exitMusic = 0;
+        float zoom = 0.f, shake = 0.f;
+        float fadeInMs = 0.f, fadeOutMs = 0.f;
+        float musicVol = 1.f;
+        int   musicFadeInMs = 400, musicFadeOutMs = 250; // musicFadeMs fallback'i uygulanmis
+    };
+
+    // Soguk tablo: sadece toast/log icin
+    struct TriggerText {
+        std::string message, lockedMsg, unlockMsg;
+    };
+
+    // "lights" object layer'indaki isik tanimi (nokta ya da rect merkezi)
+    struct LightDef {
+        float   x = 0, y = 0;        // world-space merkez
+        float   radius = 160.f;      // properties.radius
+        uint8_t r = 255, g = 220, b = 170; // properties.color (#rrggbb / #aarrggbb)
+        float   intensity = 1.0f;    // properties.intensity
+        bool    shadows = true;      // properties.shadows
+    };
+
+    // "platforms" object layer'indaki hareketli platform (rect = A konumu)
+    struct PlatformDef {
+        float x = 0, y = 0, w = 0, h = 0;   // A: sol-ust + boyut
+        float dx = 0, dy = 0;               // properties.dx/dy: B = A + (dx,dy) px
+        float speed = 80.f;                 // properties.speed (px/s)
+        float phase = 0.f;                  // properties.phase (0..1)
+        bool  oneWay = true;                // properties.oneway
+    };
+
+    // "rooms" object layer'indaki oda rect'i (aktivite/uyku bolgesi)
+    struct RoomDef {
+        float x = 0, y = 0, w = 0, h = 0;
+        std::string name;
     };
 
     class TMJMap {
@@ -45,15 +79,75 @@ namespace Erlik {
         void drawBelowPlayer(Renderer2D& r2d) const;  // fg=false olanlar izer
         void drawAbovePlayer(Renderer2D& r2d) const;  // fg=true olanlar izer
         const std::vector<Trigger>& triggers() const { return m_triggers; }
+        const TriggerProps& triggerProps(int i) const { return m_triggerProps[i]; }
+        const TriggerText&  triggerText(int i) const { return m_triggerText[i]; }
+        void markFired(int i) { m_triggers[i].flags |= TRIG_FIRED; }
         void drawTriggersDebug(class Renderer2D& r2d) const;
+        // Ada gore trigger indeksi (-1 yok); Sym surumu O(1) ve ayirmasiz
+        int  findTrigger(Sym name) const { return name > 0 && name < (int)m_symTrigger.size() ? m_symTrigger[name] : -1; }
         const Trigger* findTriggerByName(const std::string& name) const;
+        // Trigger/oyun string'leri (anahtar, muzik, sfx, isim). Reload'lar arasi id'ler sabit.
+        SymbolTable&       symbols() { return m_syms; }
+        const SymbolTable& symbols() const { return m_syms; }
+        // Trigger uzaysal indeksi (yuklemede kurulan uniform grid): kutu [x0,x1]x[y0,y1] ile
+        // kesisen trigger indeksleri (triggers() sirasi, tekrarsiz). Maliyet kutunun degdigi
+        // hucrelerdeki trigger sayisi kadar; haritadaki toplam trigger sayisindan bagimsiz.
+        void queryTriggers(float x0, float y0, float x1, float y1, std::vector<int>& out) const;
+        // Toplu sorgu (birden cok aktor): kutu i'nin sonuclari out[start[i] .. start[i+1])
+        struct TriggerBox { float x0, y0, x1, y1; };
+        void queryTriggers(const TriggerBox* boxes, int count, std::vector<int>& out, std::vector<int>& start) const;
+        const std::vector<LightDef>& lights() const { return m_lightDefs; }
+        const std::vector<PlatformDef>& platforms() const { return m_platformDefs; }
+        const std::vector<RoomDef>& rooms() const { return m_roomDefs; }
+        // Harita property'si "ambient" (renk) verildiyse true
+        bool ambient(uint8_t& r, uint8_t& g, uint8_t& b) const {
+            if (!m_hasAmbient) return false;
+            r = m_ambR; g = m_ambG; b = m_ambB; return true;
+        }
+
+        // --- Ikili onbellek (.tmjb) ---
+        // load() kaynagin yanindaki onbellegi mmap ile okur (layer basina tek memcpy); boyut+mtime
+        // (mtime farkliysa icerik hash'i) tutmazsa TMJ parse edilir ve onbellek yeniden yazilir.
+        void setBakedCache(bool on) { m_useBaked = on; }
+        static std::string bakedPathFor(const std::string& tmjPath); // "x.tmj" -> "x.tmjb"
+        // Offline donusturucu (renderer gerekmez); outPath bos ise bakedPathFor(tmjPath)
+        static bool bake(const std::string& tmjPath, const std::string& outPath = std::string());
+        // Sadece TMJ parse (onbellege bakmaz, GPU yok): araclar ve bench icin
+        bool parse(const std::string& tmjPath);
+        // Iki asamali yukleme: beginLoad haritayi okur (onbellek/parse) ve tileset decode'unu
+        // loader'in worker'ina verir; endLoad tileset'i bekler (hazirsa beklemez), draw list ve
+        // cache'leri kurar. Arada font/atlas/ses yuklemeleri ilerler.
+        bool beginLoad(const std::string& tmjPath, AssetLoader& assets);
+        bool endLoad(SDL_Renderer* r, AssetLoader& assets);
+        // Arka planda hazirlama (hot reload, cift tampon): canli haritaya dokunmadan yeni bir
+        // TMJMap doldurulur, kare sinirinda takas edilir.
+        //  inheritState (ana thread): canli haritanin symbol tablosu -> id'ler reload sonrasi ayni
+        //  prepare (herhangi bir thread): okuma/parse + tileset decode + draw list'ler; GPU yok
+        //  inheritsFrom: canli tablo o zamandan beri buyumediyse true (buyuduyse id'ler kayabilir)
+        //  finishPrepared (ana thread): tetiklenmis trigger'lari tasir, tileset upload + static cache
+        void inheritState(const TMJMap& live);
+        bool prepare(const std::string& tmjPath);
+        bool inheritsFrom(const TMJMap& live) const { return live.m_syms.size() == m_symBase; }
+        bool finishPrepared(SDL_Renderer* r, const TMJMap& live);
 
 
         // Fizik iin collision grid ret (Tilemape doldurur)
-        // collisionLayerName="collision", oneWayLayerName="oneway"
+        // collisionLayerName="collision", oneWayLayerName="oneway"; adlar setTile icin saklanir
         bool buildCollision(class Tilemap& out,
             const std::string& collisionLayerName = "collision",
-            const std::string& oneWayLayerName = "oneway") const;
+            const std::string& oneWayLayerName = "oneway");
+
+        // --- Runtime tile edit (kirilan blok, acilan kapi, switch) ---
+        // setTile katman verisini gunceller; fizik katmaniysa 'collision' hucresini aninda yamalar.
+        // Cizim tarafi (draw-list chunk'i / static cache bolgesi) sadece kirli isaretlenir;
+        // flushEdits() kare basina bir kez toplu yeniler (yuzlerce edit = chunk basina tek rebuild,
+        // cache'li katman basina tek render-target gecisi).
+        int      layerIndex(const std::string& name) const;      // yoksa -1
+        int      layerCount() const { return (int)m_layers.size(); }
+        uint32_t tileAt(int layer, int tx, int ty) const;        // ham gid (flip bayraklariyla)
+        bool     setTile(int layer, int tx, int ty, uint32_t gid, class Tilemap* collision = nullptr);
+        void     flushEdits(SDL_Renderer* r, class Tilemap* collision = nullptr);
+        bool     hasPendingEdits() const { return m_pendingEdits; }
 
         // Bilgiler
         int cols() const { return m_mapCols; }
@@ -61,7 +155,19 @@ namespace Erlik {
         int tileW() const { return m_tileW; }
         int tileH() const { return m_tileH; }
 
+        // Minimap icin hucre rengi: en ustteki gorunur (fizik olmayan) dolu katmanin rengi.
+        // Hicbir katman dolu degilse false.
+        bool minimapColor(int tx, int ty, uint8_t& r, uint8_t& g, uint8_t& b) const;
+
     private:
+        // Yuklemede hazirlanan tile komutu (world-space merkez + tileset src)
+        struct TileCmd {
+            SDL_Rect src;
+            float    cx, cy;
+            SDL_RendererFlip flip;
+        };
+        static constexpr int CHUNK_TILES = 16; // draw list chunk boyutu (tile)
+
         struct Layer {
             std::string name;
             std::vector<uint32_t> data; // gid (flip bayraklar maskelenmemi ham gid)
@@ -78,7 +184,20 @@ namespace Erlik {
             bool propOneWay = false;
             bool propFG = false;   // <-- FG katman m?
             bool propStatic = false; // <-- statik mi?
+            // Minimap rengi: property "minimap" ya da Tiled "tintcolor"
+            bool    hasMinimapColor = false;
+            uint8_t mmR = 0, mmG = 0, mmB = 0;
             Texture cacheTex;   // RAII: otomatik yok olur
+
+            // Chunk'lanmis draw list'ler: her viewport/frame ayni listeleri kullanir,
+            // sadece gorunen chunk'lar gezilir.
+            std::vector<std::vector<TileCmd>> chunks;
+            int chunkCols = 0, chunkRows = 0;
+
+            // Runtime edit kirlileri (flushEdits'te bosalir)
+            std::vector<uint8_t> chunkDirty;     // chunk basina bayrak (tekrar eklemeyi engeller)
+            std::vector<int>     dirtyChunks;
+            std::vector<int>     dirtyCacheTiles; // static cache'te yeniden cizilecek hucre indeksleri
         };
 
         // Tiled gid flip bayraklar
@@ -93,15 +212,65 @@ namespace Erlik {
         int  m_columns = 0;
         int  m_margin = 0, m_spacing = 0;
         uint32_t m_firstGid = 1;
+        std::vector<uint8_t> m_tileShape; // yerel tile id -> Tilemap::TileShape (property "shape")
 
         int  m_mapCols = 0, m_mapRows = 0;
 
         std::string m_baseDir; // resim yolu zmek iin
         std::vector<Layer> m_layers;
         std::vector<Trigger> m_triggers;
+        std::vector<TriggerProps> m_triggerProps;
+        std::vector<TriggerText>  m_triggerText;
+        std::vector<int> m_symTrigger;  // isim Sym -> trigger indeksi (-1)
+        SymbolTable m_syms;
+        std::vector<LightDef> m_lightDefs;
+        std::vector<PlatformDef> m_platformDefs;
+        std::vector<RoomDef> m_roomDefs;
+        std::string m_imagePath;   // tileset gorseli (dosyadaki hali; finishLoad baseDir ile cozer)
+        std::string m_tsxPath;     // harici tileset (onbellek bagimliligi); inline ise bos
+        bool        m_useBaked = true;
+        int         m_tilesetJob = -1; // beginLoad -> endLoad arasi AssetLoader handle'i
+        // prepare -> finishPrepared arasi decode edilmis tileset (upload ana thread'de)
+        struct SurfaceFree { void operator()(SDL_Surface* s) const { SDL_FreeSurface(s); } };
+        std::unique_ptr<SDL_Surface, SurfaceFree> m_preparedTileset;
+        int         m_symBase = 0;     // inheritState aninda canli symbol tablosu boyu
+        // Onbellekten gelen collision grid ("collision"/"oneway" adlariyla); setTile gecersiz kilar
+        std::vector<int8_t>  m_bakedCol;
+        std::vector<uint8_t> m_bakedShape;
+
+        // Trigger grid (CSR): hucre c'nin triggerlari m_trigItems[m_trigStart[c] .. m_trigStart[c+1])
+        static constexpr float TRIGGER_CELL_PX = 256.f;
+        float m_trigOriginX = 0.f, m_trigOriginY = 0.f;
+        int   m_trigCols = 0, m_trigRows = 0;
+        std::vector<int> m_trigStart, m_trigItems;
+        bool    m_pendingEdits = false;
+        // buildCollision'da kullanilan katman adlari (setTile hucre sinifini ayni kurala gore hesaplar)
+        std::string m_colLayerName = "collision", m_owLayerName = "oneway";
+        bool    m_hasAmbient = false;
+        uint8_t m_ambR = 0, m_ambG = 0, m_ambB = 0;
 
         // Yardmclar
         static std::string dirOf(const std::string& path);
+        enum class DrawPass { All, Below, Above };
+        void drawLayers(Renderer2D& r2d, DrawPass pass) const;
+        void buildDrawLists();                // tum katmanlarin chunk draw list'leri
+        void buildChunk(Layer& L, int chx, int chy) const;
+        int  collisionClass(int tx, int ty, uint8_t* shape = nullptr) const; // -1 bos, 0 solid, 1 one-way (buildCollision sirasi)
+        uint8_t shapeOfGid(uint32_t rawGid) const; // Tilemap::TileShape; FLIP_H egimi aynalar
+        void redrawCacheTiles(SDL_Renderer* r, Layer& L);
+        struct Sax;                                   // TMJParse.cpp: akisli (SAX) TMJ okuyucu
+        bool parseTmj(const std::string& tmjPath);    // JSON (+tsx) -> uye diziler; GPU yok
+        bool readSource(const std::string& tmjPath);  // onbellek ya da parse (+onbellegi yaz)
+        bool finishLoad(SDL_Renderer* r);             // tileset texture + draw list + cache
+        bool buildRenderData(SDL_Renderer* r);        // draw list + cache (tileset hazir)
+        void resolveTriggers();                       // isim -> indeks, door hedefleri
+        bool loadBaked(const std::string& bakedPath, const std::string& tmjPath); // TMJBaked.cpp
+        bool saveBaked(const std::string& bakedPath, const std::string& tmjPath) const;
+        // Collision sinifi (-1 bos, 0 solid, 1 one-way) + sekil; shapes bos = sekil yok
+        void collisionGrid(const std::string& colName, const std::string& owName,
+            std::vector<int>& grid, std::vector<uint8_t>& shapes, int& solids, int& oneways) const;
+        void buildTriggerGrid();
+        void queryTriggerCells(float x0, float y0, float x1, float y1, std::vector<int>& out) const; // out'a ekler
         void destroyCaches();                 // RAII olsa da hot-reload iin temizle
         bool buildStaticCaches(SDL_Renderer*); // static=true layerlar bir kez iz
     };
@@ -0,0 +1,681 @@
+// TMJ (Tiled JSON) okuyucu: nlohmann SAX arayuzu ile akisli parse, DOM kurulmaz.
+// Layer "data" sayilari dogrudan (onceki layer boyutuyla ayrilmis) tile dizisine yazilir,
+// base64 (+zlib/gzip/zstd) veri layer bitince boyutu belli diziye acilir;
+// her property adi okunurken bir kez slot'a cozulur, obje donusumu slot tablosundan okur.
+#include "TMJMap.h"
+#include "Tilemap.h"
+#include "LayerCodec.h"
+#include "MappedFile.h"
+#include <nlohmann/json.hpp>
+#include <SDL.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string_view>
+#include <utility>
+
+namespace Erlik {
+
+    namespace {
+
+        std::string tolower_copy(std::string s) {
+            for (auto& c : s) c = (char)std::tolower((unsigned char)c);
+            return s;
+        }
+
+        // Tiled renk stringi: "#rrggbb" ya da "#aarrggbb"
+        bool parse_color(const std::string& s, uint8_t& r, uint8_t& g, uint8_t& b) {
+            if (s.size() != 7 && s.size() != 9) return false;
+            if (s[0] != '#') return false;
+            unsigned long v = 0;
+            try { v = std::stoul(s.substr(1), nullptr, 16); }
+            catch (...) { return false; }
+            r = (uint8_t)((v >> 16) & 0xFF); g = (uint8_t)((v >> 8) & 0xFF); b = (uint8_t)(v & 0xFF);
+            return true;
+        }
+
+        std::string readFileText(const std::string& p) {
+            std::ifstream f(p, std::ios::binary); if (!f) return {};
+            std::string s; f.seekg(0, std::ios::end); s.resize((size_t)f.tellg());
+            f.seekg(0, std::ios::beg); f.read(&s[0], (std::streamsize)s.size()); return s;
+        }
+        std::string getAttr(const std::string& tag, const std::string& name) {
+            auto p = tag.find(name + "="); if (p == std::string::npos) return {};
+            p += name.size() + 1; if (p >= tag.size()) return {};
+            char q = tag[p]; if (q != '\"' && q != '\'') return {};
+            auto s = p + 1; auto e = tag.find(q, s); if (e == std::string::npos) return {};
+            return tag.substr(s, e - s);
+        }
+        int getAttrInt(const std::string& tag, const std::string& name, int def = 0) {
+            auto v = getAttr(tag, name); if (v.empty()) return def; try { return std::stoi(v); }
+            catch (...) { return def; }
+        }
+
+        // Motorun okudugu property adlari (map/layer/obje/tile). Digerleri okunurken atilir.
+        enum Prop : uint8_t {
+            P_AMBIENT, P_COLLISION, P_COLOR, P_CONSUME_KEY, P_DX, P_DY, P_EXIT_MUSIC,
+            P_FADE_IN_MS, P_FADE_OUT_MS, P_FG, P_GIVE_KEY, P_INTENSITY, P_LOCKED_MSG, P_LOCKED_SFX,
+            P_MESSAGE, P_MINIMAP, P_MUSIC, P_MUSIC_FADE_IN_MS, P_MUSIC_FADE_MS, P_MUSIC_FADE_OUT_MS,
+            P_MUSIC_VOL, P_OFFSETX, P_OFFSETY, P_ONCE, P_ONEWAY, P_OPACITY, P_PARALLAXX, P_PARALLAXY,
+            P_PHASE, P_PRESET, P_RADIUS, P_REQUIRES_KEY, P_SFX, P_SHADOWS, P_SHAKE, P_SHAPE, P_SPEED,
+            P_STATIC, P_TARGET, P_UNLOCK_MSG, P_UNLOCK_SFX, P_ZOOM,
+            P_COUNT
+        };
+
+        // Ada gore sirali (ikili arama). Tiled property adlari buyuk/kucuk harf duyarli.
+        constexpr std::pair<std::string_view, Prop> kProps[] = {
+            { "ambient", P_AMBIENT }, { "collision", P_COLLISION }, { "color", P_COLOR },
+            { "consumeKey", P_CONSUME_KEY }, { "dx", P_DX }, { "dy", P_DY }, { "exitMusic", P_EXIT_MUSIC },
+            { "fadeInMs", P_FADE_IN_MS }, { "fadeOutMs", P_FADE_OUT_MS }, { "fg", P_FG },
+            { "giveKey", P_GIVE_KEY }, { "intensity", P_INTENSITY }, { "lockedMsg", P_LOCKED_MSG },
+            { "lockedSfx", P_LOCKED_SFX }, { "message", P_MESSAGE }, { "minimap", P_MINIMAP },
+            { "music", P_MUSIC }, { "musicFadeInMs", P_MUSIC_FADE_IN_MS }, { "musicFadeMs", P_MUSIC_FADE_MS },
+            { "musicFadeOutMs", P_MUSIC_FADE_OUT_MS }, { "musicVol", P_MUSIC_VOL }, { "offsetx", P_OFFSETX },
+            { "offsety", P_OFFSETY }, { "once", P_ONCE }, { "oneway", P_ONEWAY }, { "opacity", P_OPACITY },
+            { "parallaxx", P_PARALLAXX }, { "parallaxy", P_PARALLAXY }, { "phase", P_PHASE },
+            { "preset", P_PRESET }, { "radius", P_RADIUS }, { "requiresKey", P_REQUIRES_KEY },
+            { "sfx", P_SFX }, { "shadows", P_SHADOWS }, { "shake", P_SHAKE }, { "shape", P_SHAPE },
+            { "speed", P_SPEED }, { "static", P_STATIC }, { "target", P_TARGET },
+            { "unlockMsg", P_UNLOCK_MSG }, { "unlockSfx", P_UNLOCK_SFX }, { "zoom", P_ZOOM },
+        };
+        constexpr bool propsSorted() {
+            for (size_t i = 1; i < std::size(kProps); ++i) if (!(kProps[i - 1].first < kProps[i].first)) return false;
+            return std::size(kProps) == P_COUNT;
+        }
+        static_assert(propsSorted(), "kProps sirali ve tam olmali");
+
+        Prop propOf(std::string_view name) {
+            const auto it = std::lower_bound(std::begin(kProps), std::end(kProps), name,
+                [](const std::pair<std::string_view, Prop>& e, std::string_view n) { return e.first < n; });
+            return it != std::end(kProps) && it->first == name ? it->second : P_COUNT;
+        }
+
+        struct PropVal {
+            enum Kind : uint8_t { None, Bool, Num, Str };
+            Kind   kind = None;
+            bool   b = false;
+            double n = 0.0;
+            std::string s;      // Str: deger; Num: dosyadaki yazimi (string olarak istenirse)
+        };
+        using PropList = std::vector<std::pair<Prop, PropVal>>;
+
+        // Bir sahibin property'leri slot'a gore; PropList'ten tek geciste kurulur (ayni ad: ilki)
+        struct PropView {
+            const PropVal* v[P_COUNT] = {};
+            explicit PropView(const PropList& l) { for (const auto& e : l) if (!v[e.first]) v[e.first] = &e.second; }
+
+            bool boolOr(Prop p, bool d) const { return v[p] && v[p]->kind == PropVal::Bool ? v[p]->b : d; }
+            std::string strOr(Prop p, const char* d) const {
+                return v[p] && (v[p]->kind == PropVal::Str || v[p]->kind == PropVal::Num) ? v[p]->s : std::string(d);
+            }
+            float floatOr(Prop p, float d) const {
+                if (!v[p]) return d;
+                if (v[p]->kind == PropVal::Num) return (float)v[p]->n;
+                if (v[p]->kind == PropVal::Str) { try { return std::stof(v[p]->s); } catch (...) {} }
+                return d;
+            }
+        };
+
+        struct ObjRec {
+            int   id = 0;
+            float x = 0, y = 0, w = 0, h = 0;
+            std::string name, type;
+            PropList props;
+        };
+
+        // Ilk tileset; layer'lardan sonra geldigi icin parse bitince uygulanir
+        struct TilesetRec {
+            int      count = 0;
+            uint32_t firstGid = 1;
+            int      columns = 0, margin = 0, spacing = 0;
+            bool     hasImage = false, hasSource = false;
+            std::string image, source;
+            std::vector<std::pair<int, std::string>> shapes; // inline "tiles": id -> property "shape"
+        };
+
+    } // namespace
+
+    // SAX olay isleyici (nlohmann::json::sax_parse). Yigin, icinde bulunulan JSON yolunun
+    // motor icin anlamli kismini tutar; ilgisiz alt agaclar Skip olarak gecilir.
+    struct TMJMap::Sax {
+        using json = nlohmann::json;
+        enum class Ctx : uint8_t { Root, Layers, Layer, Data, Objects, Object, Props, Prop, Tilesets, Tileset, Tiles, Tile, Skip };
+        struct Frame { Ctx ctx; Ctx owner; };
+
+        TMJMap& m;
+        std::vector<Frame> st;
+        std::string field;          // son okunan anahtar
+        std::string error;
+
+        Layer       layer;          // okunmakta olan layer (tilelayer ise m_layers'a tasinir)
+        std::string layerType, tint;
+        std::string encoding, compression, encoded; // base64 "data" (width/height sonra gelir)
+        int         layerW = 0, layerH = 0;
+        std::vector<uint8_t> scratch;               // sikistirilmis bayt (layer'lar arasi tekrar kullanilir)
+        PropList    layerProps, mapProps, tileProps;
+        std::vector<ObjRec> objs;   // objectgroup objeleri (grup adi/turu sonda kesinlesir)
+        TilesetRec  ts;
+        int         tileId = -1;
+        std::string propName;
+        PropVal     propVal;
+        size_t      dataHint = 0;   // onceki tilelayer boyutu: sonrakiler tek ayirmayla dolar
+        std::vector<int> firedIds;  // once=true tetiklenmisler (Tiled id, sirali)
+
+        explicit Sax(TMJMap& map) : m(map) {}
+
+        Ctx top() const { return st.empty() ? Ctx::Skip : st.back().ctx; }
+
+        // --- Skalerler ---
+        bool null() { return true; }
+        bool binary(json::binary_t&) { return true; }
+
+        bool boolean(bool v) {
+            const Ctx c = top();
+            if (c == Ctx::Layer && field == "visible") layer.visible = v;
+            else if (c == Ctx::Prop && field == "value") { propVal.kind = PropVal::Bool; propVal.b = v; }
+            return true;
+        }
+        bool number_unsigned(json::number_unsigned_t v) {
+            if (top() == Ctx::Data) return pushGid(v <= UINT32_MAX, (uint32_t)v, nullptr);
+            return number((double)v, nullptr);
+        }
+        bool number_integer(json::number_integer_t v) {
+            if (top() == Ctx::Data) return pushGid(v >= 0 && v <= (json::number_integer_t)UINT32_MAX, (uint32_t)v, nullptr);
+            return number((double)v, nullptr);
+        }
+        bool number_float(json::number_float_t v, const std::string& raw) {
+            // gid tam sayi olmali: kesirli/negatif/tasan degerin uint32 donusumu tanimsiz
+            if (top() == Ctx::Data) {
+                const bool ok = v >= 0.0 && v <= (double)UINT32_MAX && v == std::floor(v);
+                return pushGid(ok, ok ? (uint32_t)v : 0u, &raw);
+            }
+            return number(v, &raw);
+        }
+
+        bool pushGid(bool ok, uint32_t gid, const std::string* raw) {
+            if (!ok) {
+                error = "layer data: invalid gid " + (raw ? *raw : std::string("(out of range)")) +
+                    " at index " + std::to_string(layer.data.size());
+                return false;
+            }
+            layer.data.push_back(gid);
+            return true;
+        }
+
+        bool number(double v, const std::string* raw) {
+            switch (top()) {
+            case Ctx::Root:
+                if (field == "width") m.m_mapCols = (int)v;
+                else if (field == "height") m.m_mapRows = (int)v;
+                else if (field == "tilewidth") m.m_tileW = (int)v;
+                else if (field == "tileheight") m.m_tileH = (int)v;
+                break;
+            case Ctx::Layer:
+                if (field == "opacity") layer.opacity = (float)v;
+                else if (field == "width") layerW = (int)v;
+                else if (field == "height") layerH = (int)v;
+                else if (field == "offsetx") layer.offsetX = (float)v;
+                else if (field == "offsety") layer.offsetY = (float)v;
+                else if (field == "parallaxx") layer.parallaxX = (float)v;
+                else if (field == "parallaxy") layer.parallaxY = (float)v;
+                break;
+            case Ctx::Object: {
+                ObjRec& o = objs.back();
+                if (field == "id") o.id = (int)v;
+                else if (field == "x") o.x = (float)v;
+                else if (field == "y") o.y = (float)v;
+                else if (field == "width") o.w = (float)v;
+                else if (field == "height") o.h = (float)v;
+                break;
+            }
+            case Ctx::Tileset:
+                if (field == "firstgid") ts.firstGid = (uint32_t)v;
+                else if (field == "columns") ts.columns = (int)v;
+                else if (field == "margin") ts.margin = (int)v;
+                else if (field == "spacing") ts.spacing = (int)v;
+                break;
+            case Ctx::Tile:
+                if (field == "id") tileId = (int)v;
+                break;
+            case Ctx::Prop:
+                if (field == "value") {
+                    propVal.kind = PropVal::Num; propVal.n = v;
+                    propVal.s = raw ? *raw : std::to_string((long long)v);
+                }
+                break;
+            default: break;
+            }
+            return true;
+        }
+
+        bool string(std::string& s) {
+            switch (top()) {
+            case Ctx::Layer:
+                if (field == "name") layer.name = std::move(s);
+                else if (field == "type") layerType = std::move(s);
+                else if (field == "tintcolor") tint = std::move(s);
+                else if (field == "data") encoded = std::move(s);
+                else if (field == "encoding") encoding = std::move(s);
+                else if (field == "compression") compression = std::move(s);
+                break;
+            case Ctx::Object:
+                if (field == "name") objs.back().name = std::move(s);
+                else if (field == "type") objs.back().type = std::move(s);
+                break;
+            case Ctx::Tileset:
+                if (field == "image") { ts.image = std::move(s); ts.hasImage = true; }
+                else if (field == "source") { ts.source = std::move(s); ts.hasSource = true; }
+                break;
+            case Ctx::Prop:
+                if (field == "name") propName = std::move(s);
+                else if (field == "value") { propVal.kind = PropVal::Str; propVal.s = std::move(s); }
+                break;
+            default: break;
+            }
+            return true;
+        }
+
+        bool key(std::string& k) { field.swap(k); return true; }
+
+        // --- Yapilar ---
+        bool start_object(std::size_t) {
+            Ctx c = Ctx::Skip;
+            const Ctx p = top();
+            if (st.empty()) c = Ctx::Root;
+            else switch (p) {
+            case Ctx::Layers:   c = Ctx::Layer; beginLayer(); break;
+            case Ctx::Objects:  c = Ctx::Object; objs.emplace_back(); break;
+            case Ctx::Tilesets: c = ts.count++ == 0 ? Ctx::Tileset : Ctx::Skip; break; // tek tileset
+            case Ctx::Tiles:    c = Ctx::Tile; tileId = -1; tileProps.clear(); break;
+            case Ctx::Props:    c = Ctx::Prop; propName.clear(); propVal.kind = PropVal::None; break;
+            default: break;
+            }
+            st.push_back({ c, p });
+            return true;
+        }
+
+        bool start_array(std::size_t) {
+            Ctx c = Ctx::Skip;
+            const Ctx p = top();
+            switch (p) {
+            case Ctx::Root:
+                if (field == "layers") c = Ctx::Layers;
+                else if (field == "properties") c = Ctx::Props;
+                else if (field == "tilesets") c = Ctx::Tilesets;
+                break;
+            case Ctx::Layer:
+                if (field == "data") {
+                    c = Ctx::Data;
+                    layer.data.clear();
+                    layer.data.reserve(std::max(dataHint, (size_t)std::max(0, m.m_mapCols) * (size_t)std::max(0, m.m_mapRows)));
+                }
+                else if (field == "objects") c = Ctx::Objects;
+                else if (field == "properties") c = Ctx::Props;
+                break;
+            case Ctx::Object:
+            case Ctx::Tile:
+                if (field == "properties") c = Ctx::Props;
+                break;
+            case Ctx::Tileset:
+                if (field == "tiles") c = Ctx::Tiles;
+                break;
+            default: break;
+            }
+            st.push_back({ c, p });
+            return true;
+        }
+
+        bool end_array() { st.pop_back(); return true; }
+
+        bool end_object() {
+            const Frame f = st.back();
+            st.pop_back();
+            if (f.ctx == Ctx::Layer) return endLayer();
+            else if (f.ctx == Ctx::Prop) endProp(st.back().owner);
+            else if (f.ctx == Ctx::Tile) {
+                const PropView P(tileProps);
+                if (tileId >= 0 && P.v[P_SHAPE] && P.v[P_SHAPE]->kind == PropVal::Str)
+                    ts.shapes.emplace_back(tileId, P.v[P_SHAPE]->s);
+            }
+            return true;
+        }
+
+        bool parse_error(std::size_t pos, const std::string&, const nlohmann::detail::exception& ex) {
+            error = "byte " + std::to_string(pos) + ": " + ex.what();
+            return false;
+        }
+
+        // Property {name,type,value} bitti: bilinen ad ise sahibinin listesine slot olarak eklenir
+        void endProp(Ctx owner) {
+            const Prop k = propOf(propName);
+            if (k == P_COUNT || propVal.kind == PropVal::None) return;
+            PropList* out = owner == Ctx::Root ? &mapProps : owner == Ctx::Layer ? &layerProps :
+                owner == Ctx::Object ? &objs.back().props : owner == Ctx::Tile ? &tileProps : nullptr;
+            if (out) out->emplace_back(k, std::move(propVal));
+            propVal = PropVal();
+        }
+
+        void beginLayer() {
+            layer = Layer();
+            layerType.clear(); tint.clear();
+            encoding.clear(); compression.clear(); encoded.clear();
+            layerW = layerH = 0;
+            layerProps.clear(); objs.clear();
+        }
+
+        bool endLayer() {
+            if (layerType == "tilelayer") return endTileLayer();
+            if (layerType != "objectgroup") return true;
+            const std::string n = tolower_copy(layer.name);
+            if (n == "triggers") addTriggers();
+            else if (n == "lights") addLights();
+            else if (n == "platforms") addPlatforms();
+            else if (n == "rooms") addRooms();
+            return true;
+        }
+
+        bool endTileLayer() {
+            Layer& L = layer;
+            // encoding "base64": boyut artik belli, veri tek geciste layer dizisine acilir
+            if (encoding == "base64") {
+                LayerCompression c;
+                if (!parseLayerCompression(compression, c) || !layerCompressionSupported(c)) {
+                    error = "layer '" + L.name + "': unsupported compression '" + compression + "'";
+                    return false;
+                }
+                L.data.resize((size_t)std::max(0, layerW) * (size_t)std::max(0, layerH));
+                std::string err;
+                if (!decodeLayerData(encoded, c, L.data.data(), L.data.size(), scratch, err)) {
+                    error = "layer '" + L.name + "': " + err;
+                    return false;
+                }
+                encoded.clear();
+            }
+            else if (!encoding.empty() && encoding != "csv") {
+                error = "layer '" + L.name + "': unsupported encoding '" + encoding + "'";
+                return false;
+            }
+            else if (L.data.size() != (size_t)std::max(0, layerW) * (size_t)std::max(0, layerH)) {
+                // Dizi verisi: base64 yoluyla ayni kural (kisa/uzun veri satirlari kaydirir)
+                error = "layer '" + L.name + "': size mismatch (" + std::to_string(L.data.size()) + " gids, expected " +
+                    std::to_string(layerW) + "x" + std::to_string(layerH) + ")";
+                return false;
+            }
+            if (!tint.empty()) L.hasMinimapColor = parse_color(tint, L.mmR, L.mmG, L.mmB);
+
+            // Layer properties: bool bayraklar, string preset/minimap, sayisal override'lar
+            for (const auto& [k, v] : layerProps) {
+                if (v.kind == PropVal::Bool) {
+                    if (!v.b) continue;
+                    if (k == P_COLLISION) L.propCollision = true;
+                    else if (k == P_ONEWAY) L.propOneWay = true;
+                    else if (k == P_FG) L.propFG = true;
+                    else if (k == P_STATIC) L.propStatic = true;
+                }
+                else if (v.kind == PropVal::Str) {
+                    if (k == P_MINIMAP) L.hasMinimapColor = parse_color(tolower_copy(v.s), L.mmR, L.mmG, L.mmB);
+                    else if (k == P_PRESET) L.preset = tolower_copy(v.s);
+                }
+                else if (v.kind == PropVal::Num) {
+                    if (k == P_PARALLAXX) L.parallaxX = (float)v.n;
+                    else if (k == P_PARALLAXY) L.parallaxY = (float)v.n;
+                    else if (k == P_OFFSETX) L.offsetX = (float)v.n;
+                    else if (k == P_OFFSETY) L.offsetY = (float)v.n;
+                    else if (k == P_OPACITY) L.opacity = (float)v.n;
+                }
+            }
+
+            // Editor-side parallax preset'leri ("bg_sky", "bg_far", "bg_mid", "bg_near", "game", "fg")
+            if (!L.preset.empty()) {
+                const std::string& p = L.preset;
+                if (p == "bg_sky") { L.parallaxX = 0.20f; L.parallaxY = 0.10f; }
+                else if (p == "bg_far") { L.parallaxX = 0.40f; L.parallaxY = 0.30f; }
+                else if (p == "bg_mid") { L.parallaxX = 0.65f; L.parallaxY = 0.60f; }
+                else if (p == "bg_near") { L.parallaxX = 0.85f; L.parallaxY = 0.85f; }
+                else if (p == "game") { L.parallaxX = 1.00f; L.parallaxY = 1.00f; }
+                else if (p == "fg") { L.parallaxX = 1.00f; L.parallaxY = 1.00f; L.propFG = true; }
+            }
+
+            // Isimden otomatik bayraklar (property eklemeyi unutsan da calissin)
+            const std::string lname = tolower_copy(L.name);
+            if (lname == "fg" || lname == "foreground") L.propFG = true;
+            if (lname == "collision" || lname == "collisions" || lname == "solid") L.propCollision = true;
+            if (lname == "oneway" || lname == "one-way" || lname == "platforms") L.propOneWay = true;
+
+            dataHint = std::max(dataHint, L.data.size());
+            m.m_layers.push_back(std::move(L));
+            return true;
+        }
+
+        // Tur string'i enum'a, anahtar/muzik/sfx/isimler Sym'e cevrilir (door hedefi resolveTriggers'ta)
+        void addTriggers() {
+            for (const ObjRec& O : objs) {
+                const std::string type = tolower_copy(O.type);
+                Trigger t;
+                t.id = O.id;
+                t.x = O.x; t.y = O.y; t.w = O.w; t.h = O.h;
+                if (type.empty() || t.w <= 0 || t.h <= 0) continue;
+
+                const PropView P(O.props);
+                TriggerProps p;
+                TriggerText  x;
+                const std::string giveKey = tolower_copy(P.strOr(P_GIVE_KEY, ""));
+                p.name = m.m_syms.intern(O.name);
+
+                if (type == "checkpoint") t.type = TriggerType::Checkpoint;
+                else if (type == "key" || !giveKey.empty()) {
+                    t.type = TriggerType::Key;
+                    p.giveKey = m.m_syms.intern(giveKey.empty() ? tolower_copy(O.name) : giveKey);
+                }
+                else if (type == "door")   t.type = TriggerType::Door;
+                else if (type == "region") t.type = TriggerType::Region;
+                else                       t.type = TriggerType::Custom;
+
+                if (P.boolOr(P_ONCE, false))       t.flags |= TRIG_ONCE;
+                if (P.boolOr(P_CONSUME_KEY, true)) t.flags |= TRIG_CONSUME_KEY;
+                if (std::binary_search(firedIds.begin(), firedIds.end(), t.id)) t.flags |= TRIG_FIRED;
+
+                p.targetName = m.m_syms.intern(P.strOr(P_TARGET, ""));
+                p.requiresKey = m.m_syms.intern(tolower_copy(P.strOr(P_REQUIRES_KEY, "")));
+
+                // sfx (Key: "key", kilitli kapi: "locked" varsayilan)
+                const std::string sfx = P.strOr(P_SFX, "");
+                const std::string lockedSfx = P.strOr(P_LOCKED_SFX, "");
+                p.sfx = m.m_syms.intern(sfx.empty() && t.type == TriggerType::Key ? std::string("key") : sfx);
+                p.lockedSfx = m.m_syms.intern(lockedSfx.empty() ? std::string("locked") : lockedSfx);
+                p.unlockSfx = m.m_syms.intern(P.strOr(P_UNLOCK_SFX, ""));
+
+                p.zoom = P.floatOr(P_ZOOM, 0.0f);
+                p.shake = P.floatOr(P_SHAKE, 0.0f);
+                p.fadeInMs = P.floatOr(P_FADE_IN_MS, 0.0f);
+                p.fadeOutMs = P.floatOr(P_FADE_OUT_MS, 0.0f);
+
+                // music region: musicFadeMs sadece ayri in/out verilmediyse gecerli
+                p.music = m.m_syms.intern(P.strOr(P_MUSIC, ""));
+                p.exitMusic = m.m_syms.intern(P.strOr(P_EXIT_MUSIC, ""));
+                p.musicVol = std::clamp(P.floatOr(P_MUSIC_VOL, 1.0f), 0.0f, 1.0f);
+                const float fadeMs = P.floatOr(P_MUSIC_FADE_MS, 0.0f);
+                const float fin = P.floatOr(P_MUSIC_FADE_IN_MS, 0.0f);
+                const float fout = P.floatOr(P_MUSIC_FADE_OUT_MS, 0.0f);
+                p.musicFadeInMs = fin > 0.f ? (int)fin : fadeMs > 0.f ? (int)fadeMs : 400;
+                p.musicFadeOutMs = fout > 0.f ? (int)fout : fadeMs > 0.f ? (int)fadeMs : 250;
+
+                x.message = P.strOr(P_MESSAGE, "");
+                x.lockedMsg = P.strOr(P_LOCKED_MSG, "");
+                x.unlockMsg = P.strOr(P_UNLOCK_MSG, "");
+
+                m.m_triggers.push_back(t);
+                m.m_triggerProps.push_back(p);
+                m.m_triggerText.push_back(std::move(x));
+            }
+        }
+
+        void addLights() {
+            for (const ObjRec& O : objs) {
+                const PropView P(O.props);
+                LightDef d;
+                // point objelerde w/h = 0; rect'lerde merkezi al
+                d.x = O.x + O.w * 0.5f;
+                d.y = O.y + O.h * 0.5f;
+                d.radius = P.floatOr(P_RADIUS, 160.0f);
+                d.intensity = P.floatOr(P_INTENSITY, 1.0f);
+                d.shadows = P.boolOr(P_SHADOWS, true);
+                parse_color(P.strOr(P_COLOR, ""), d.r, d.g, d.b);
+                if (d.radius > 0.f) m.m_lightDefs.push_back(d);
+            }
+        }
+
+        void addPlatforms() {
+            for (const ObjRec& O : objs) {
+                const PropView P(O.props);
+                PlatformDef d;
+                d.x = O.x; d.y = O.y; d.w = O.w; d.h = O.h;
+                d.dx = P.floatOr(P_DX, 0.0f);
+                d.dy = P.floatOr(P_DY, 0.0f);
+                d.speed = P.floatOr(P_SPEED, 80.0f);
+                d.phase = P.floatOr(P_PHASE, 0.0f);
+                d.oneWay = P.boolOr(P_ONEWAY, true);
+                if (d.w > 0.f && d.h > 0.f) m.m_platformDefs.push_back(d);
+            }
+        }
+
+        void addRooms() {
+            for (ObjRec& O : objs) {
+                RoomDef d;
+                d.x = O.x; d.y = O.y; d.w = O.w; d.h = O.h;
+                d.name = std::move(O.name);
+                if (d.w > 0.f && d.h > 0.f) m.m_roomDefs.push_back(std::move(d));
+            }
+        }
+    };
+
+    bool TMJMap::parse(const std::string& tmjPath)
+    {
+        m_baseDir = dirOf(tmjPath);
+        return parseTmj(tmjPath);
+    }
+
+    bool TMJMap::parseTmj(const std::string& tmjPath)
+    {
+        // --- TMJ dosyasini esle (okuma tamponu/DOM yok) ---
+        MappedFile file;
+        if (!file.open(tmjPath)) {
+            SDL_Log("TMJMap: tmj not found: %s", tmjPath.c_str());
+            return false;
+        }
+
+        // once=true tetiklenmisler Tiled id ile tasinir (hot reload ilerlemeyi sifirlamaz)
+        Sax sax(*this);
+        for (const auto& t : m_triggers) if (t.flags & TRIG_FIRED) sax.firedIds.push_back(t.id);
+        std::sort(sax.firedIds.begin(), sax.firedIds.end());
+
+        m_mapCols = m_mapRows = 0;
+        m_tileW = m_tileH = 32;
+        m_layers.clear();
+        m_triggers.clear(); m_triggerProps.clear(); m_triggerText.clear();
+        m_lightDefs.clear(); m_platformDefs.clear(); m_roomDefs.clear();
+
+        const char* text = (const char*)file.data();
+        if (!nlohmann::json::sax_parse(text, text + file.size(), &sax)) {
+            SDL_Log("TMJMap: tmj parse error: %s (%s)", tmjPath.c_str(), sax.error.c_str());
+            return false;
+        }
+        file.close();
+
+        // --- Tileset (tek tileset bekliyoruz) ---
+        const TilesetRec& ts = sax.ts;
+        if (ts.count == 0) return false;
+        m_firstGid = ts.firstGid;
+
+        std::string image;
+        m_tsxPath.clear();
+        // Tile property "shape" (half, slope45_r, ...): collision hucresinin sekli
+        m_tileShape.clear();
+        auto addShape = [&](int id, const std::string& name) {
+            const uint8_t s = Tilemap::shapeFromName(name);
+            if (id < 0 || s == Tilemap::SHAPE_FULL) return;
+            if ((size_t)id >= m_tileShape.size()) m_tileShape.resize((size_t)id + 1, Tilemap::SHAPE_FULL);
+            m_tileShape[id] = s;
+        };
+        m_columns = ts.columns;
+        m_margin = ts.margin;
+        m_spacing = ts.spacing;
+
+        if (ts.hasImage) {
+            // INLINE TILESET (TMJ icinde image alani var)
+            image = ts.image;
+            for (const auto& [id, shape] : ts.shapes) addShape(id, shape);
+        }
+        else if (ts.hasSource) {
+            // EXTERNAL .TSX
+            std::string tsxPath = m_baseDir.empty() ? ts.source : (m_baseDir + ts.source);
+            std::string xml = readFileText(tsxPath);
+            m_tsxPath = tsxPath;
+            if (xml.empty()) { SDL_Log("TMJMap: tsx not found: %s", tsxPath.c_str()); return false; }
+
+            // <tileset ...>
+            auto p0 = xml.find("<tileset"); if (p0 == std::string::npos) { SDL_Log("TMJMap: tsx invalid"); return false; }
+            auto p1 = xml.find('>', p0);    if (p1 == std::string::npos) { SDL_Log("TMJMap: tsx invalid"); return false; }
+            std::string tstag = xml.substr(p0, p1 - p0 + 1);
+
+            // <image .../>
+            auto i0 = xml.find("<image"); if (i0 == std::string::npos) { SDL_Log("TMJMap: tsx missing <image>"); return false; }
+            auto i1 = xml.find('>', i0);  if (i1 == std::string::npos) { SDL_Log("TMJMap: tsx invalid <image>"); return false; }
+            std::string imgtag = xml.substr(i0, i1 - i0 + 1);
+
+            // Oznitelikler
+            int tw = getAttrInt(tstag, "tilewidth", m_tileW);
+            int th = getAttrInt(tstag, "tileheight", m_tileH);
+            int mar = getAttrInt(tstag, "margin", 0);
+            int sp = getAttrInt(tstag, "spacing", 0);
+            int cols = getAttrInt(tstag, "columns", 0);
+
+            std::string imgRel = getAttr(imgtag, "source");
+            std::string imgPath = imgRel;
+            if (!m_baseDir.empty() && !imgRel.empty()) imgPath = m_baseDir + imgRel;
+
+            // Uygula
+            m_tileW = tw; m_tileH = th; m_margin = mar; m_spacing = sp; m_columns = cols;
+            image = imgPath;
+
+            // <tile id=".."><properties><property name="shape" value=".."/>
+            for (size_t t0 = xml.find("<tile "); t0 != std::string::npos; t0 = xml.find("<tile ", t0 + 1)) {
+                const size_t t1 = xml.find('>', t0);
+                if (t1 == std::string::npos) break;
+                if (xml[t1 - 1] == '/') continue; // govdesiz <tile .../>
+                const size_t tEnd = xml.find("</tile>", t1);
+                const std::string body = xml.substr(t1, tEnd == std::string::npos ? std::string::npos : tEnd - t1);
+                const size_t q0 = body.find("<property name=\"shape\"");
+                if (q0 == std::string::npos) continue;
+                const std::string ptag = body.substr(q0, body.find('>', q0) - q0 + 1);
+                addShape(getAttrInt(xml.substr(t0, t1 - t0 + 1), "id", -1), getAttr(ptag, "value"));
+            }
+
+            SDL_Log("TMJMap: tsx parsed (tw=%d th=%d margin=%d spacing=%d columns=%d image=%s)",
+                m_tileW, m_tileH, m_margin, m_spacing, m_columns, image.c_str());
+        }
+        else {
+            SDL_Log("TMJMap: tileset has neither image nor source");
+            return false;
+        }
+        m_imagePath = image;
+
+        // Harita ambient'i + trigger isim/hedef cozumu
+        m_hasAmbient = parse_color(PropView(sax.mapProps).strOr(P_AMBIENT, ""), m_ambR, m_ambG, m_ambB);
+        resolveTriggers();
+        buildTriggerGrid();
+        SDL_Log("INFO: TMJ triggers loaded: %d (grid %dx%d)", (int)m_triggers.size(), m_trigCols, m_trigRows);
+        SDL_Log("INFO: TMJ lights loaded: %d", (int)m_lightDefs.size());
+        SDL_Log("INFO: TMJ platforms loaded: %d", (int)m_platformDefs.size());
+        SDL_Log("INFO: TMJ rooms loaded: %d", (int)m_roomDefs.size());
+
+        SDL_Log("TMJMap: map=%dx%d tile=%dx%d layers=%zu firstgid=%u columns=%d",
+            m_mapCols, m_mapRows, m_tileW, m_tileH, m_layers.size(),
+            (unsigned)m_firstGid, m_columns);
+        m_bakedCol.clear(); m_bakedShape.clear(); // collision grid buildCollision'da hesaplanir
+        return m_mapCols > 0 && m_mapRows > 0;
+    }
+
+} // namespace Erlik
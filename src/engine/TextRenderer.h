@@ -16,6 +16,8 @@ namespace Erlik {
             if (m_font) { TTF_CloseFont(m_font); m_font = nullptr; }
             // TTF_Quit()i burada armak istemiyorsan bo brak
         }
+        // Dogrudan SDL'e cizer (Renderer2D'yi atlar): glyph texture'i cagri basina olusur,
+        // kayit/frameHash'e girmez. Render bench'i metin cizmez.
         void draw(const char* text, int x, int y, SDL_Color col, float scale = 1.f) {
             if (!m_font || !m_r || !text) return;
             SDL_Surface* s = TTF_RenderUTF8_Blended(m_font, text, col);
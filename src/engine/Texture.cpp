@@ -15,10 +15,16 @@ bool Texture::loadFromFile(SDL_Renderer* r, const std::string& path){
     destroy();
     SDL_Surface* surf = IMG_Load(path.c_str());
     if(!surf){ std::fprintf(stderr, "IMG_Load failed: %s\n", IMG_GetError()); return false; }
+    const bool ok = createFromSurface(r, surf);
+    SDL_FreeSurface(surf); return ok;
+}
+
+bool Texture::createFromSurface(SDL_Renderer* r, SDL_Surface* surf){
+    destroy();
     SDL_Texture* tex = SDL_CreateTextureFromSurface(r, surf);
-    if(!tex){ std::fprintf(stderr, "CreateTextureFromSurface failed: %s\n", SDL_GetError()); SDL_FreeSurface(surf); return false; }
+    if(!tex){ std::fprintf(stderr, "CreateTextureFromSurface failed: %s\n", SDL_GetError()); return false; }
     SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
-    m_tex = tex; m_w = surf->w; m_h = surf->h; SDL_FreeSurface(surf); return true;
+    m_tex = tex; m_w = surf->w; m_h = surf->h; return true;
 }
 
 bool Texture::createRenderTarget(SDL_Renderer* r, int w, int h, Uint32 fmt) {
@@ -29,5 +35,13 @@ bool Texture::createRenderTarget(SDL_Renderer* r, int w, int h, Uint32 fmt) {
     m_tex = tex; m_w = w; m_h = h; return true;
 }
 
+bool Texture::createStreaming(SDL_Renderer* r, int w, int h, Uint32 fmt) {
+    destroy();
+    SDL_Texture * tex = SDL_CreateTexture(r, fmt, SDL_TEXTUREACCESS_STREAMING, w, h);
+    if (!tex) { std::fprintf(stderr, "CreateTexture(STREAMING) failed: %s\n", SDL_GetError()); return false; }
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+    m_tex = tex; m_w = w; m_h = h; return true;
+}
+
 void Texture::destroy(){ if(m_tex){ SDL_DestroyTexture(m_tex); m_tex=nullptr; } m_w=m_h=0; }
 } // namespace Erlik
\ No newline at end of file
@@ -13,9 +13,14 @@ public:
     Texture(Texture&&) noexcept;
     Texture & operator=(Texture&&) noexcept;
     bool loadFromFile(SDL_Renderer* renderer, const std::string& path);
+    // Hazir surface'ten upload (surface cagirana ait kalir; AssetLoader decode'u baska thread'de yapar)
+    bool createFromSurface(SDL_Renderer* renderer, SDL_Surface* surf);
     // Render target (offscreen) olutur
     bool createRenderTarget(SDL_Renderer * renderer, int w, int h,
         Uint32 fmt = SDL_PIXELFORMAT_RGBA8888);
+    // CPU'dan SDL_UpdateTexture ile guncellenen (streaming) texture
+    bool createStreaming(SDL_Renderer * renderer, int w, int h,
+        Uint32 fmt = SDL_PIXELFORMAT_RGBA8888);
     void destroy();
     SDL_Texture* sdl() const { return m_tex; }
     int width() const { return m_w; }
@@ -2,6 +2,9 @@
 #include <fstream>
 #include <sstream>
 #include <SDL.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
 
 namespace Erlik {
 
@@ -24,7 +27,10 @@ bool Tilemap::loadCSV(const std::string& path){
         rows++;
     }
     m_cols = cols; m_rows = rows;
-    return (m_cols>0 && m_rows>0);
+    if(m_cols<=0 || m_rows<=0) return false;
+    rebuildBits(m_data);
+    bakeRects();
+    return true;
 }
 
 bool Tilemap::loadTileset(SDL_Renderer* r, const std::string& path, int tileSize, int margin, int spacing){
@@ -35,10 +41,98 @@ bool Tilemap::loadTileset(SDL_Renderer* r, const std::string& path, int tileSize
 bool Tilemap::adoptGrid(int cols, int rows, int tileSize, std::vector<int> data) {
     if (cols <= 0 || rows <= 0 || tileSize <= 0) return false;
     m_cols = cols; m_rows = rows; m_tile = tileSize;
-    m_data = std::move(data);
+    // Grid sadece collision sinifi (-1/0/1) tasiyor: bitplane'ler yeterli, int grid tutulmaz
+    rebuildBits(data);
+    m_data.clear(); m_data.shrink_to_fit();
+    SDL_Log("Tilemap: collision bits %zu bytes (int grid: %zu)",
+        collisionBytes(), (size_t)cols * (size_t)rows * sizeof(int));
     return true;
 }
 
+void Tilemap::rebuildBits(const std::vector<int>& cells) {
+    m_words = (m_cols + 63) / 64;
+    m_rects.clear(); m_rectStart.clear(); m_rectItems.clear(); // bakeRects ile yeniden
+    m_rectCols = m_rectRows = 0;
+    m_solid.assign((size_t)m_rows * m_words, 0u);
+    m_oneWay.assign((size_t)m_rows * m_words, 0u);
+    m_shaped.assign((size_t)m_rows * m_words, 0u);
+    m_shape.clear(); // sekiller (TMJ) setShape ile sonradan gelir
+    buildProfiles();
+    const size_t n = std::min(cells.size(), (size_t)m_cols * (size_t)m_rows);
+    for (size_t i = 0; i < n; ++i) {
+        const int idx = cells[i];
+        if (idx < 0) continue;
+        const size_t ty = i / m_cols, tx = i % m_cols;
+        const uint64_t b = 1ull << (tx & 63);
+        if (isSolid(idx))  m_solid[ty * m_words + (tx >> 6)] |= b;
+        else if (isOneWay(idx)) m_oneWay[ty * m_words + (tx >> 6)] |= b;
+    }
+}
+
+// [tx0,tx1] araligini word'lere bol: w icin gecerli bit maskesi
+static inline uint64_t spanMask(int w, int w0, int w1, int tx0, int tx1) {
+    uint64_t m = ~0ull;
+    if (w == w0) m &= ~0ull << (tx0 & 63);
+    if (w == w1) m &= ~0ull >> (63 - (tx1 & 63));
+    return m;
+}
+
+bool Tilemap::anyInRow(int ty, int tx0, int tx1, uint8_t mask) const {
+    if (ty < 0 || ty >= m_rows) return false;
+    tx0 = std::max(tx0, 0); tx1 = std::min(tx1, m_cols - 1);
+    if (tx1 < tx0) return false;
+    const int w0 = tx0 >> 6, w1 = tx1 >> 6;
+    for (int w = w0; w <= w1; ++w)
+        if (rowWord(ty, w, mask) & spanMask(w, w0, w1, tx0, tx1)) return true;
+    return false;
+}
+
+int Tilemap::firstInRow(int ty, int tx0, int tx1, uint8_t mask) const {
+    if (ty < 0 || ty >= m_rows) return -1;
+    tx0 = std::max(tx0, 0); tx1 = std::min(tx1, m_cols - 1);
+    if (tx1 < tx0) return -1;
+    const int w0 = tx0 >> 6, w1 = tx1 >> 6;
+    for (int w = w0; w <= w1; ++w) {
+        const uint64_t bits = rowWord(ty, w, mask) & spanMask(w, w0, w1, tx0, tx1);
+        if (bits) return w * 64 + std::countr_zero(bits);
+    }
+    return -1;
+}
+
+int Tilemap::lastInRow(int ty, int tx0, int tx1, uint8_t mask) const {
+    if (ty < 0 || ty >= m_rows) return -1;
+    tx0 = std::max(tx0, 0); tx1 = std::min(tx1, m_cols - 1);
+    if (tx1 < tx0) return -1;
+    const int w0 = tx0 >> 6, w1 = tx1 >> 6;
+    for (int w = w1; w >= w0; --w) {
+        const uint64_t bits = rowWord(ty, w, mask) & spanMask(w, w0, w1, tx0, tx1);
+        if (bits) return w * 64 + 63 - std::countl_zero(bits);
+    }
+    return -1;
+}
+
+bool Tilemap::anyInCol(int tx, int ty0, int ty1, uint8_t mask) const {
+    if (tx < 0 || tx >= m_cols) return false;
+    ty0 = std::max(ty0, 0); ty1 = std::min(ty1, m_rows - 1);
+    const int w = tx >> 6;
+    const uint64_t b = 1ull << (tx & 63);
+    for (int ty = ty0; ty <= ty1; ++ty)
+        if (rowWord(ty, w, mask) & b) return true;
+    return false;
+}
+
+int Tilemap::scanRows(int tx0, int tx1, int tyFrom, int tyTo, uint8_t mask) const {
+    const int dir = (tyTo >= tyFrom) ? 1 : -1;
+    // Grid disindaki satirlari atla
+    if (dir > 0) { tyFrom = std::max(tyFrom, 0); tyTo = std::min(tyTo, m_rows - 1); if (tyTo < tyFrom) return -1; }
+    else         { tyFrom = std::min(tyFrom, m_rows - 1); tyTo = std::max(tyTo, 0); if (tyFrom < tyTo) return -1; }
+    for (int ty = tyFrom; ; ty += dir) {
+        if (anyInRow(ty, tx0, tx1, mask)) return ty;
+        if (ty == tyTo) break;
+    }
+    return -1;
+}
+
 void Tilemap::draw(Renderer2D& r2d) const{
     if(!m_tileset.sdl() || m_cols<=0 || m_rows<=0) return;
 
@@ -73,4 +167,562 @@ void Tilemap::draw(Renderer2D& r2d) const{
     }
 }
 
+void Tilemap::setCell(int tx, int ty, int idx) {
+    if (!inside(tx, ty)) return;
+    if (!m_data.empty()) m_data[(size_t)ty * m_cols + tx] = idx;
+    const size_t w = (size_t)ty * m_words + (size_t)(tx >> 6);
+    const uint64_t b = 1ull << (tx & 63);
+    m_solid[w] &= ~b; m_oneWay[w] &= ~b; m_shaped[w] &= ~b;
+    if (!m_shape.empty()) m_shape[(size_t)ty * m_cols + tx] = SHAPE_FULL;
+    if (idx >= 0) {
+        if (isSolid(idx)) m_solid[w] |= b;
+        else if (isOneWay(idx)) m_oneWay[w] |= b;
+    }
+    markRectsDirty(ty);
+}
+
+// Profil tablosu: her sekil icin piksel sutunu -> alttan dolu yukseklik (0..tile).
+// _L sekilleri _R'nin aynasi; 22.5 derece cifti tile basina yarim tile yukselir.
+void Tilemap::buildProfiles() {
+    const int T = m_tile;
+    m_profile.assign((size_t)SHAPE_COUNT * T, 0);
+    auto prof = [&](uint8_t s) { return m_profile.data() + (size_t)s * T; };
+    for (int x = 0; x < T; ++x) {
+        prof(SHAPE_FULL)[x]         = (uint16_t)T;
+        prof(SHAPE_HALF)[x]         = (uint16_t)(T / 2);
+        prof(SHAPE_SLOPE45_R)[x]    = (uint16_t)(x + 1);
+        prof(SHAPE_SLOPE22_R_LO)[x] = (uint16_t)((x + 1) / 2);
+        prof(SHAPE_SLOPE22_R_HI)[x] = (uint16_t)(T / 2 + (x + 1) / 2);
+    }
+    const uint8_t pairs[3][2] = { { SHAPE_SLOPE45_L, SHAPE_SLOPE45_R },
+        { SHAPE_SLOPE22_L_LO, SHAPE_SLOPE22_R_LO }, { SHAPE_SLOPE22_L_HI, SHAPE_SLOPE22_R_HI } };
+    for (const auto& pr : pairs)
+        for (int x = 0; x < T; ++x) prof(pr[0])[x] = prof(pr[1])[T - 1 - x];
+}
+
+uint8_t Tilemap::shapeFromName(const std::string& name) {
+    static const char* names[SHAPE_COUNT] = { "full", "half", "slope45_r", "slope45_l",
+        "slope22_r_lo", "slope22_r_hi", "slope22_l_lo", "slope22_l_hi" };
+    for (int i = 0; i < SHAPE_COUNT; ++i) if (name == names[i]) return (uint8_t)i;
+    return SHAPE_FULL;
+}
+
+uint8_t Tilemap::mirrorShape(uint8_t shape) {
+    switch (shape) {
+    case SHAPE_SLOPE45_R:    return SHAPE_SLOPE45_L;
+    case SHAPE_SLOPE45_L:    return SHAPE_SLOPE45_R;
+    case SHAPE_SLOPE22_R_LO: return SHAPE_SLOPE22_L_LO;
+    case SHAPE_SLOPE22_L_LO: return SHAPE_SLOPE22_R_LO;
+    case SHAPE_SLOPE22_R_HI: return SHAPE_SLOPE22_L_HI;
+    case SHAPE_SLOPE22_L_HI: return SHAPE_SLOPE22_R_HI;
+    default:                 return shape;
+    }
+}
+
+void Tilemap::setShape(int tx, int ty, uint8_t shape) {
+    if (!inside(tx, ty) || shape >= SHAPE_COUNT) return;
+    const size_t w = (size_t)ty * m_words + (size_t)(tx >> 6);
+    const uint64_t b = 1ull << (tx & 63);
+    if (!((m_solid[w] | m_shaped[w]) & b)) return; // sadece solid hucreler sekil alir
+    if (m_shape.empty()) {
+        if (shape == SHAPE_FULL) return;
+        m_shape.assign((size_t)m_cols * m_rows, SHAPE_FULL);
+    }
+    m_shape[(size_t)ty * m_cols + tx] = shape;
+    if (shape == SHAPE_FULL) { m_shaped[w] &= ~b; m_solid[w] |= b; }
+    else                     { m_solid[w] &= ~b; m_shaped[w] |= b; }
+    markRectsDirty(ty);
+}
+
+void Tilemap::bakeRects() {
+    m_rects.clear();
+    bakeBand(0, m_rows - 1);
+    indexRects();
+}
+
+// Kirli satirlar ardisik kosulara ayrilir; kosulara degen dikdortgenler cikarilir, kosu
+// disinda kalan satir parcalari (hucreleri degismedi) aynen geri eklenir, kosular yeniden
+// birlestirilir. Ilk bake'e gore biraz daha parcali olabilir; CSR index rect sayisinda lineer.
+void Tilemap::bakeDirtyRects() {
+    if (!m_rectsDirty) return;
+    if (m_rectCols == 0) { bakeRects(); return; }
+    std::sort(m_dirtyRows.begin(), m_dirtyRows.end());
+    m_dirtyRows.erase(std::unique(m_dirtyRows.begin(), m_dirtyRows.end()), m_dirtyRows.end());
+    std::vector<std::pair<int, int>> runs;
+    for (int y : m_dirtyRows) {
+        if (!runs.empty() && runs.back().second + 1 == y) runs.back().second = y;
+        else runs.emplace_back(y, y);
+    }
+
+    std::vector<int> drop, hit;
+    for (const auto& [a, b] : runs) {
+        rectsIn(0, a, m_cols - 1, b, MASK_ANY, hit);
+        drop.insert(drop.end(), hit.begin(), hit.end());
+    }
+    std::sort(drop.begin(), drop.end());
+    drop.erase(std::unique(drop.begin(), drop.end()), drop.end());
+
+    std::vector<CollisionRect> pieces;
+    for (int i : drop) {
+        const CollisionRect r = m_rects[i];
+        const int end = r.ty + r.th - 1;
+        int y = r.ty;
+        for (const auto& [a, b] : runs) {
+            if (b < y) continue;
+            if (a > end) break;
+            if (a > y) pieces.push_back(CollisionRect{ r.tx, (int16_t)y, r.tw, (int16_t)(a - y), r.kind });
+            y = b + 1;
+        }
+        if (y <= end) pieces.push_back(CollisionRect{ r.tx, (int16_t)y, r.tw, (int16_t)(end - y + 1), r.kind });
+    }
+    size_t keep = 0, k = 0;
+    for (size_t i = 0; i < m_rects.size(); ++i) {
+        if (k < drop.size() && drop[k] == (int)i) { ++k; continue; }
+        m_rects[keep++] = m_rects[i];
+    }
+    m_rects.resize(keep);
+    m_rects.insert(m_rects.end(), pieces.begin(), pieces.end());
+    for (const auto& [a, b] : runs) bakeBand(a, b);
+    indexRects();
+}
+
+// Greedy merge: her satirda kalan ilk bitten baslayan kosu (word-wide ctz), solid'de asagi
+// dogru tam dolu satirlar boyunca (bant sonuna kadar) uzatilir; kullanilan bitler silinir.
+void Tilemap::bakeBand(int ty0, int ty1) {
+    if (ty1 < ty0) return;
+    auto bake = [&](const std::vector<uint64_t>& plane, uint8_t kind, bool vertical) {
+        std::vector<uint64_t> left(plane.begin() + (size_t)ty0 * m_words, plane.begin() + (size_t)(ty1 + 1) * m_words);
+        auto word = [&](int ty, int w) -> uint64_t& { return left[(size_t)(ty - ty0) * m_words + (size_t)w]; };
+        auto spanFull = [&](int ty, int x0, int x1) {
+            const int w0 = x0 >> 6, w1 = x1 >> 6;
+            for (int w = w0; w <= w1; ++w) {
+                const uint64_t m = spanMask(w, w0, w1, x0, x1);
+                if ((word(ty, w) & m) != m) return false;
+            }
+            return true;
+        };
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int w = 0; w < m_words; ++w) {
+                while (word(ty, w)) {
+                    const int x0 = w * 64 + std::countr_zero(word(ty, w));
+                    // kosunun sonu: x0'dan sonraki ilk bos bit
+                    int x1 = m_cols - 1;
+                    uint64_t gap = ~word(ty, w) & (~0ull << (x0 & 63));
+                    for (int ww = w; ww < m_words; ++ww) {
+                        if (ww != w) gap = ~word(ty, ww);
+                        if (gap) { x1 = std::min(m_cols - 1, ww * 64 + std::countr_zero(gap) - 1); break; }
+                    }
+                    int y1 = ty;
+                    if (vertical) while (y1 + 1 <= ty1 && spanFull(y1 + 1, x0, x1)) ++y1;
+
+                    const int w0 = x0 >> 6, w1 = x1 >> 6;
+                    for (int y = ty; y <= y1; ++y)
+                        for (int ww = w0; ww <= w1; ++ww) word(y, ww) &= ~spanMask(ww, w0, w1, x0, x1);
+                    m_rects.push_back(CollisionRect{ (int16_t)x0, (int16_t)ty,
+                        (int16_t)(x1 - x0 + 1), (int16_t)(y1 - ty + 1), kind });
+                }
+            }
+        }
+    };
+    bake(m_solid, MASK_SOLID, true);
+    bake(m_oneWay, MASK_ONEWAY, false);
+    bake(m_shaped, MASK_SHAPED, false);
+}
+
+void Tilemap::indexRects() {
+    // CSR grid index: say, sonra yerlestir
+    m_rectCols = (m_cols + RECT_CELL - 1) / RECT_CELL;
+    m_rectRows = (m_rows + RECT_CELL - 1) / RECT_CELL;
+    m_rectStart.assign((size_t)m_rectCols * m_rectRows + 1, 0);
+    auto each = [&](const CollisionRect& r, auto&& fn) {
+        for (int cy = r.ty / RECT_CELL; cy <= (r.ty + r.th - 1) / RECT_CELL; ++cy)
+            for (int cx = r.tx / RECT_CELL; cx <= (r.tx + r.tw - 1) / RECT_CELL; ++cx)
+                fn((size_t)cy * m_rectCols + cx);
+    };
+    for (const CollisionRect& r : m_rects) each(r, [&](size_t c) { ++m_rectStart[c + 1]; });
+    for (size_t c = 1; c < m_rectStart.size(); ++c) m_rectStart[c] += m_rectStart[c - 1];
+    m_rectItems.resize(m_rectStart.back());
+    std::vector<int> fill(m_rectStart.begin(), m_rectStart.end() - 1);
+    for (int i = 0; i < (int)m_rects.size(); ++i)
+        each(m_rects[i], [&](size_t c) { m_rectItems[fill[c]++] = i; });
+
+    m_rectsDirty = false;
+    m_dirtyRows.clear();
+}
+
+void Tilemap::rectsIn(int tx0, int ty0, int tx1, int ty1, uint8_t mask, std::vector<int>& out) const {
+    out.clear();
+    if (m_rectCols == 0) return;
+    const int cx0 = std::max(0, tx0 / RECT_CELL), cy0 = std::max(0, ty0 / RECT_CELL);
+    const int cx1 = std::min(m_rectCols - 1, tx1 / RECT_CELL), cy1 = std::min(m_rectRows - 1, ty1 / RECT_CELL);
+    if (tx1 < 0 || ty1 < 0 || cx0 > cx1 || cy0 > cy1) return;
+    for (int cy = cy0; cy <= cy1; ++cy)
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            const size_t c = (size_t)cy * m_rectCols + cx;
+            for (int k = m_rectStart[c]; k < m_rectStart[c + 1]; ++k) {
+                const CollisionRect& r = m_rects[m_rectItems[k]];
+                if (!(r.kind & mask)) continue;
+                if (r.tx > tx1 || r.tx + r.tw - 1 < tx0 || r.ty > ty1 || r.ty + r.th - 1 < ty0) continue;
+                out.push_back(m_rectItems[k]);
+            }
+        }
+    if (cx0 != cx1 || cy0 != cy1) {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
+
+void Tilemap::drawCollisionDebug(Renderer2D& r2d) const {
+    int vw, vh; r2d.outputSize(vw, vh);
+    const Camera2D& cam = r2d.camera();
+    const int tx0 = (int)std::floor(cam.x / m_tile), ty0 = (int)std::floor(cam.y / m_tile);
+    const int tx1 = (int)std::floor((cam.x + vw / cam.zoom) / m_tile);
+    const int ty1 = (int)std::floor((cam.y + vh / cam.zoom) / m_tile);
+
+    std::vector<int> vis; // debug cizimi: kare basina ayirma sorun degil
+    rectsIn(tx0, ty0, tx1, ty1, MASK_BLOCK, vis); // sekilliler asagida profil seritleriyle
+    for (int i : vis) {
+        const CollisionRect& r = m_rects[i];
+        const SDL_Color c = (r.kind == MASK_SOLID) ? SDL_Color{ 220,60,60,70 } : SDL_Color{ 60,160,230,90 };
+        r2d.fillRect((float)(r.tx * m_tile), (float)(r.ty * m_tile),
+            (float)(r.tw * m_tile), (float)(r.th * m_tile), c);
+    }
+    // Sekilli hucreler: profil 4 seritle yaklasik
+    if (!hasShapes()) return;
+    const int strips = 4, sw = std::max(1, m_tile / strips);
+    for (int ty = std::max(ty0, 0); ty <= std::min(ty1, m_rows - 1); ++ty)
+        for (int tx = firstInRow(ty, tx0, tx1, MASK_SHAPED); tx >= 0;
+             tx = (tx < tx1) ? firstInRow(ty, tx + 1, tx1, MASK_SHAPED) : -1) {
+            const uint16_t* prof = m_profile.data() + (size_t)shapeAt(tx, ty) * m_tile;
+            for (int k = 0; k < strips; ++k) {
+                const int h = prof[std::min(m_tile - 1, k * sw + sw / 2)];
+                r2d.fillRect((float)(tx * m_tile + k * sw), (float)((ty + 1) * m_tile - h),
+                    (float)sw, (float)h, SDL_Color{ 230,160,60,90 });
+            }
+        }
+}
+
+// --- Sahne sorgulari ---
+
+// std::floor SSE4.1 olmadan kutuphane cagrisi: sicak dongulerde int donusumu + duzeltme
+static inline int floorToInt(float v) {
+    const int i = (int)v;
+    return i - (v < (float)i);
+}
+
+static inline void setHit(Tilemap::RayHit& h, float t, float x, float y, float nx, float ny, int tx, int ty, uint8_t kind) {
+    h.hit = true; h.t = t; h.x = x; h.y = y; h.nx = nx; h.ny = ny; h.tx = tx; h.ty = ty; h.kind = kind;
+}
+
+float Tilemap::shapeTop(int tx, int ty, float x0, float x1) const {
+    const int base = tx * m_tile;
+    const int a = std::clamp(floorToInt(x0) - base, 0, m_tile - 1);
+    const int b = std::clamp(floorToInt(x1) - base, 0, m_tile - 1);
+    const uint16_t* prof = m_profile.data() + (size_t)shapeAt(tx, ty) * m_tile;
+    return (float)((ty + 1) * m_tile - std::max(prof[a], prof[b]));
+}
+
+// Egim yuzeyinin normali (yukari bakan); yarim/tam blok duz
+static void shapeNormal(uint8_t shape, float& nx, float& ny) {
+    switch (shape) {
+    case Tilemap::SHAPE_SLOPE45_R:    nx = -0.70710678f; ny = -0.70710678f; break;
+    case Tilemap::SHAPE_SLOPE45_L:    nx =  0.70710678f; ny = -0.70710678f; break;
+    case Tilemap::SHAPE_SLOPE22_R_LO:
+    case Tilemap::SHAPE_SLOPE22_R_HI: nx = -0.44721360f; ny = -0.89442719f; break;
+    case Tilemap::SHAPE_SLOPE22_L_LO:
+    case Tilemap::SHAPE_SLOPE22_L_HI: nx =  0.44721360f; ny = -0.89442719f; break;
+    default:                          nx = 0.f; ny = -1.f; break;
+    }
+}
+
+// Isinin hucre icindeki parcasi piksel sutunlari boyunca: sutunda yuzey sabit, isin y'si
+// dogrusal; sutun girisinde zaten altindaysa o an, degilse yuzeyi kestigi an.
+bool Tilemap::shapeRayHit(int tx, int ty, float x, float y, float dx, float dy, float ta, float tb,
+    float enx, float eny, float& t, float& nx, float& ny) const {
+    if (tb < ta) return false;
+    const int T = m_tile, base = tx * T;
+    const float bottom = (float)((ty + 1) * T);
+    const uint16_t* prof = m_profile.data() + (size_t)shapeAt(tx, ty) * T;
+    const int sx = (dx > 0.f) ? 1 : -1;
+    const int pa = std::clamp(floorToInt(x + dx * ta) - base, 0, T - 1);
+    const int pb = (dx == 0.f) ? pa : std::clamp(floorToInt(x + dx * tb) - base, 0, T - 1);
+    float t0 = ta;
+    for (int p = pa; ; p += sx) {
+        const float t1 = (p == pb) ? tb : std::min(tb, ((float)(base + p + (sx > 0)) - x) / dx);
+        if (prof[p] > 0) {
+            const float s = bottom - (float)prof[p];
+            if (y + dy * t0 >= s) {
+                t = t0;
+                if (t0 == ta) { nx = enx; ny = eny; } else { nx = (float)-sx; ny = 0.f; }
+                return true;
+            }
+            if (y + dy * t1 >= s) { // dy > 0: yuzeye ustten
+                t = std::max(t0, (s - y) / dy);
+                shapeNormal(shapeAt(tx, ty), nx, ny);
+                return true;
+            }
+        }
+        if (p == pb) return false;
+        t0 = t1;
+    }
+}
+
+// [x0,x1]x[y0,y1] kutusu (kapali, cagiran iceri cekmis) profilin dolu kismina giriyor mu
+bool Tilemap::shapeBoxOverlaps(int tx, int ty, float x0, float y0, float x1, float y1) const {
+    const float tile = (float)m_tile;
+    if (x1 < tx * tile || x0 >= (tx + 1) * tile || y1 < ty * tile || y0 >= (ty + 1) * tile) return false;
+    return y1 >= shapeTop(tx, ty, x0, x1);
+}
+
+// Kutu hucre kutusuyla [tin,tout] araliginda kesisir (slab testi); bu aralikta piksel adimiyla
+// orneklenir, ilk temasli ornek ile oncekinin arasi ikiye bolmeyle daraltilir.
+bool Tilemap::shapeBoxHit(int tx, int ty, float cx, float cy, float halfW, float halfH, float dx, float dy,
+    float& t, float& nx, float& ny) const {
+    const float tile = (float)m_tile, eps = 0.01f;
+    const float hw = halfW - eps, hh = halfH - eps;
+    float tin = 0.f, tout = 1.f, tinX = -1.f, tinY = -1.f;
+    auto slab = [&](float c, float h, float d, float lo, float hi, float& tEnter) {
+        if (d == 0.f) return c + h >= lo && c - h < hi;
+        float a = (lo - (c + h)) / d, b = (hi - (c - h)) / d;
+        if (a > b) std::swap(a, b);
+        tEnter = a;
+        tin = std::max(tin, a); tout = std::min(tout, b);
+        return tin <= tout;
+    };
+    if (!slab(cx, hw, dx, tx * tile, (tx + 1) * tile, tinX)) return false;
+    if (!slab(cy, hh, dy, ty * tile, (ty + 1) * tile, tinY)) return false;
+
+    auto hits = [&](float s) {
+        const float x = cx + dx * s, y = cy + dy * s;
+        return shapeBoxOverlaps(tx, ty, x - hw, y - hh, x + hw, y + hh);
+    };
+    const int n = std::max(1, (int)std::ceil((tout - tin) * std::max(std::fabs(dx), std::fabs(dy))));
+    float prev = tin;
+    for (int i = 0; i <= n; ++i) {
+        const float s = tin + (tout - tin) * (float)i / (float)n;
+        if (!hits(s)) { prev = s; continue; }
+        if (i == 0) {
+            t = tin;
+            if (tin <= 0.f)      { nx = 0.f; ny = 0.f; }
+            else if (tinX > tinY) { nx = (dx > 0.f) ? -1.f : 1.f; ny = 0.f; }
+            else                  { nx = 0.f; ny = (dy > 0.f) ? -1.f : 1.f; }
+            return true;
+        }
+        float lo = prev, hi = s;
+        for (int k = 0; k < 12; ++k) {
+            const float mid = 0.5f * (lo + hi);
+            if (hits(mid)) hi = mid; else lo = mid;
+        }
+        t = lo; // temasin hemen oncesi: kutu profile gomulmez
+        shapeNormal(shapeAt(tx, ty), nx, ny);
+        return true;
+    }
+    return false;
+}
+
+void Tilemap::pointMasks(const float* x, const float* y, int n, uint8_t* out) const {
+    const float inv = 1.f / (float)m_tile;
+    const uint64_t* solid = m_solid.data();
+    const uint64_t* oneWay = m_oneWay.data();
+    const uint64_t* shaped = m_shaped.data();
+    for (int i = 0; i < n; ++i) {
+        const int tx = floorToInt(x[i] * inv), ty = floorToInt(y[i] * inv);
+        if ((unsigned)tx >= (unsigned)m_cols || (unsigned)ty >= (unsigned)m_rows) { out[i] = 0; continue; }
+        const size_t w = (size_t)ty * m_words + (size_t)(tx >> 6);
+        const int b = tx & 63;
+        out[i] = (uint8_t)(((solid[w] >> b) & 1u) * MASK_SOLID | ((oneWay[w] >> b) & 1u) * MASK_ONEWAY
+                         | ((shaped[w] >> b) & 1u) * MASK_SHAPED);
+    }
+}
+
+// firstInRow/lastInRow'un sadece solid, sinir kontrolsuz (ty gecerli) hali: span walk'un ic dongusu
+inline int Tilemap::spanFirst(int ty, int tx0, int tx1) const {
+    tx0 = std::max(tx0, 0); tx1 = std::min(tx1, m_cols - 1);
+    if (tx1 < tx0) return -1;
+    const uint64_t* row = m_solid.data() + (size_t)ty * m_words;
+    const int w0 = tx0 >> 6, w1 = tx1 >> 6;
+    for (int w = w0; w <= w1; ++w)
+        if (const uint64_t b = row[w] & spanMask(w, w0, w1, tx0, tx1)) return w * 64 + std::countr_zero(b);
+    return -1;
+}
+
+inline int Tilemap::spanLast(int ty, int tx0, int tx1) const {
+    tx0 = std::max(tx0, 0); tx1 = std::min(tx1, m_cols - 1);
+    if (tx1 < tx0) return -1;
+    const uint64_t* row = m_solid.data() + (size_t)ty * m_words;
+    const int w0 = tx0 >> 6, w1 = tx1 >> 6;
+    for (int w = w1; w >= w0; --w)
+        if (const uint64_t b = row[w] & spanMask(w, w0, w1, tx0, tx1)) return w * 64 + 63 - std::countl_zero(b);
+    return -1;
+}
+
+// Span walk: isin satir satir ilerler. Her satirda isinin gectigi sutun araligi tek bir
+// word-wide firstInRow/lastInRow ile test edilir (hucre basina adim yok); satira giris hucresi
+// ayrica (ustten girisle one-way de sayilir). Sekilli hucreler satirdaki solid isabetinden
+// once, isin sirasiyla profil testine girer. Harita disina cikan isin iska.
+bool Tilemap::raycast(float x, float y, float dx, float dy, float maxDist, uint8_t mask, RayHit& out) const {
+    out = RayHit{};
+    if (m_cols <= 0 || maxDist < 0.f || (dx == 0.f && dy == 0.f)) return false;
+    const float tile = (float)m_tile;
+    const int tx = (int)std::floor(x / tile), ty = (int)std::floor(y / tile);
+    if (!inside(tx, ty)) return false;
+    if (cellMask(tx, ty) & mask & MASK_SOLID) { setHit(out, 0.f, x, y, 0.f, 0.f, tx, ty, MASK_SOLID); return true; }
+
+    const uint8_t side = mask & MASK_SOLID;   // one-way yandan/alttan gecilir
+    const bool shapes = (mask & MASK_SHAPED) && hasShapes();
+    const float invTile = 1.f / tile;
+    const int sx = (dx > 0.f) ? 1 : -1, sy = (dy > 0.f) ? 1 : -1;
+    const uint8_t entry = ((sy > 0) ? mask : side) & MASK_BLOCK;
+    const float tdy = (dy != 0.f) ? tile / std::fabs(dy) : 1e30f;
+    float tRow = (dy != 0.f) ? ((sy > 0) ? (ty + 1) * tile - y : y - ty * tile) / std::fabs(dy) : 1e30f;
+    float tA = 0.f;
+    int r = ty, ca = tx;
+
+    for (;;) {
+        // satira giris hucresi (ilk satirda baslangic hucresi: zaten bos)
+        if (r != ty) {
+            if (const uint8_t k = cellMask(ca, r) & entry) {
+                setHit(out, tA, x + dx * tA, y + dy * tA, 0.f, (float)-sy, ca, r, k);
+                return true;
+            }
+        }
+        // satir icindeki sutun gecisleri: [ca+sx .. cb]
+        const float tB = std::min(tRow, maxDist);
+        int cb = floorToInt((x + dx * tB) * invTile);
+        cb = (sx > 0) ? std::max(cb, ca) : std::min(cb, ca);
+        int c = -1;
+        if (side && cb != ca) c = (sx > 0) ? spanFirst(r, ca + 1, cb) : spanLast(r, cb, ca - 1);
+        if (shapes) {
+            // [ca .. c) (solid yoksa cb'ye kadar) araligindaki sekilli hucreler, isin sirasiyla
+            const int end = (c >= 0) ? c - sx : cb;
+            const int lo = std::min(ca, end), hi = std::max(ca, end);
+            for (int s = (sx > 0) ? firstInRow(r, lo, hi, MASK_SHAPED) : lastInRow(r, lo, hi, MASK_SHAPED);
+                 s >= 0;
+                 s = (sx > 0) ? firstInRow(r, s + 1, hi, MASK_SHAPED) : lastInRow(r, lo, s - 1, MASK_SHAPED)) {
+                // hucreye giris: satir basi (ust/alt kenar, ilk satirda baslangic) ya da yan kenar
+                const bool first = (s == ca);
+                const float ta = first ? tA : ((sx > 0) ? s * tile - x : (s + 1) * tile - x) / dx;
+                const float tb = (dx == 0.f) ? tB : std::min(tB, ((sx > 0) ? (s + 1) * tile - x : s * tile - x) / dx);
+                const float enx = first ? 0.f : (float)-sx, eny = (first && r != ty) ? (float)-sy : 0.f;
+                float t, nx, ny;
+                if (shapeRayHit(s, r, x, y, dx, dy, ta, tb, enx, eny, t, nx, ny)) {
+                    setHit(out, t, x + dx * t, y + dy * t, nx, ny, s, r, MASK_SHAPED);
+                    return true;
+                }
+            }
+        }
+        if (c >= 0) {
+            const float t = ((sx > 0) ? c * tile - x : (c + 1) * tile - x) / dx;
+            setHit(out, t, x + dx * t, y + dy * t, (float)-sx, 0.f, c, r, MASK_SOLID);
+            return true;
+        }
+        if (tRow >= maxDist || cb < 0 || cb >= m_cols) return false;
+        r += sy;
+        if (r < 0 || r >= m_rows) return false;
+        tA = tRow; tRow += tdy; ca = cb;
+    }
+}
+
+void Tilemap::raycastBatch(const Ray* rays, int count, uint8_t mask, RayHit* out) const {
+    for (int i = 0; i < count; ++i) {
+        const Ray& r = rays[i];
+        raycast(r.x, r.y, r.dx, r.dy, r.maxDist, mask, out[i]);
+    }
+}
+
+// Swept AABB: on kenarlarin girdigi sutun/satir olaylari zaman sirasiyla; her olayda o anki
+// dik span (hafif iceriden) span sorgusuyla test edilir. Sekilli hucreler once ayri gecisle
+// (sweep kutusundaki her biri profil testiyle); tam bloklar o zamana kadar aranir.
+bool Tilemap::boxcast(float cx, float cy, float halfW, float halfH, float dx, float dy, uint8_t mask, RayHit& out) const {
+    out = RayHit{};
+    if (m_cols <= 0) return false;
+    const float tile = (float)m_tile, eps = 0.01f;
+    auto cell = [&](float v) { return (int)std::floor(v / tile); };
+
+    if ((mask & MASK_SOLID) && scanRows(cell(cx - halfW + eps), cell(cx + halfW - eps),
+            cell(cy - halfH + eps), cell(cy + halfH - eps), MASK_SOLID) >= 0) {
+        setHit(out, 0.f, cx, cy, 0.f, 0.f, -1, -1, MASK_SOLID);
+        return true;
+    }
+
+    float tShape = 2.f, snx = 0.f, sny = 0.f;
+    if ((mask & MASK_SHAPED) && hasShapes()) {
+        const int tx0 = cell(std::min(cx, cx + dx) - halfW + eps), tx1 = cell(std::max(cx, cx + dx) + halfW - eps);
+        const int ty0 = std::max(0, cell(std::min(cy, cy + dy) - halfH + eps));
+        const int ty1 = std::min(m_rows - 1, cell(std::max(cy, cy + dy) + halfH - eps));
+        for (int ty = ty0; ty <= ty1; ++ty)
+            for (int c = firstInRow(ty, tx0, tx1, MASK_SHAPED); c >= 0; c = firstInRow(ty, c + 1, tx1, MASK_SHAPED)) {
+                float t, nx, ny;
+                if (shapeBoxHit(c, ty, cx, cy, halfW, halfH, dx, dy, t, nx, ny) && t < tShape) {
+                    tShape = t; snx = nx; sny = ny;
+                }
+            }
+    }
+
+    const float INF = 1e30f;
+    const uint8_t flat = mask & MASK_BLOCK;
+    const int sx = (dx > 0.f) ? 1 : -1, sy = (dy > 0.f) ? 1 : -1;
+    int col = 0, row = 0;
+    float tcol = INF, trow = INF, tdx = INF, tdy = INF;
+    if (dx != 0.f) {
+        const float e = cx + sx * halfW;
+        if (sx > 0) { col = (int)std::ceil(e / tile); tcol = (col * tile - e) / dx; }
+        else        { const int b = cell(e); col = b - 1; tcol = (e - b * tile) / -dx; }
+        tdx = tile / std::fabs(dx);
+    }
+    if (dy != 0.f) {
+        const float e = cy + sy * halfH;
+        if (sy > 0) { row = (int)std::ceil(e / tile); trow = (row * tile - e) / dy; }
+        else        { const int b = cell(e); row = b - 1; trow = (e - b * tile) / -dy; }
+        tdy = tile / std::fabs(dy);
+    }
+
+    while (std::min(tcol, trow) <= std::min(1.f, tShape)) {
+        if (tcol <= trow) {
+            const float t = tcol, y = cy + dy * t;
+            if ((mask & MASK_SOLID) && anyInCol(col, cell(y - halfH + eps), cell(y + halfH - eps), MASK_SOLID)) {
+                setHit(out, t, cx + dx * t, y, (float)-sx, 0.f, -1, -1, MASK_SOLID);
+                return true;
+            }
+            col += sx; tcol += tdx;
+        }
+        else {
+            const float t = trow, x = cx + dx * t;
+            const uint8_t m = (sy > 0) ? flat : (flat & MASK_SOLID);
+            const int x0 = cell(x - halfW + eps), x1 = cell(x + halfW - eps);
+            if (m && anyInRow(row, x0, x1, m)) {
+                const uint8_t k = anyInRow(row, x0, x1, m & MASK_SOLID) ? MASK_SOLID : MASK_ONEWAY;
+                setHit(out, t, x, cy + dy * t, 0.f, (float)-sy, -1, -1, k);
+                return true;
+            }
+            row += sy; trow += tdy;
+        }
+    }
+    if (tShape > 1.f) return false;
+    setHit(out, tShape, cx + dx * tShape, cy + dy * tShape, snx, sny, -1, -1, MASK_SHAPED);
+    return true;
+}
+
+bool Tilemap::overlap(float x0, float y0, float x1, float y1, uint8_t mask) const {
+    if (x1 <= x0 || y1 <= y0) return false;
+    const float tile = (float)m_tile;
+    const int tx0 = (int)std::floor(x0 / tile), tx1 = (int)std::ceil(x1 / tile) - 1;
+    const int ty0 = (int)std::floor(y0 / tile), ty1 = (int)std::ceil(y1 / tile) - 1;
+    if ((mask & MASK_BLOCK) && scanRows(tx0, tx1, ty0, ty1, mask & MASK_BLOCK) >= 0) return true;
+    if (!(mask & MASK_SHAPED) || !hasShapes()) return false;
+    // sekilli hucrelerde profil: yari acik bolge, ust sinirlar hafif iceri
+    for (int ty = std::max(ty0, 0); ty <= std::min(ty1, m_rows - 1); ++ty)
+        for (int c = firstInRow(ty, tx0, tx1, MASK_SHAPED); c >= 0; c = firstInRow(ty, c + 1, tx1, MASK_SHAPED))
+            if (shapeBoxOverlaps(c, ty, x0, y0, x1 - 0.01f, y1 - 0.01f)) return true;
+    return false;
+}
+
+void Tilemap::overlapRects(float x0, float y0, float x1, float y1, uint8_t mask, std::vector<int>& out) const {
+    out.clear();
+    if (x1 <= x0 || y1 <= y0) return;
+    const float tile = (float)m_tile;
+    rectsIn((int)std::floor(x0 / tile), (int)std::floor(y0 / tile),
+        (int)std::ceil(x1 / tile) - 1, (int)std::ceil(y1 / tile) - 1, mask, out);
+}
+
 } // namespace Erlik
\ No newline at end of file
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include "Texture.h"
@@ -20,22 +22,152 @@ public:
     int cols() const { return m_cols; }
     int rows() const { return m_rows; }
     int tileSize() const { return m_tile; }
-    int get(int tx, int ty) const { if(tx<0||ty<0||tx>=m_cols||ty>=m_rows) return -1; return m_data[ty*m_cols + tx]; }
+    // CSV'den yuklendiyse tile index; TMJ grid'i (adoptGrid) bitplane'lerden turetilir: -1/0/1
+    int get(int tx, int ty) const {
+        if(tx<0||ty<0||tx>=m_cols||ty>=m_rows) return -1;
+        if(!m_data.empty()) return m_data[ty*m_cols + tx];
+        return (bit(m_solid, tx, ty) || bit(m_shaped, tx, ty)) ? 0 : (bit(m_oneWay, tx, ty) ? 1 : -1);
+    }
     // Tilemap.h (class Tilemap iinde, public:)
     bool isSolid(int idx)   const { return idx == 0 || idx >= 2; } // 0 ve 2..N: tam blok
     bool isOneWay(int idx)  const { return idx == 1; }             // 1: tek ynl
-    bool solidAtTile(int tx, int ty) const { return isSolid(get(tx, ty)); }
-    bool oneWayAtTile(int tx, int ty) const { return isOneWay(get(tx, ty)); }
+    // Tam blok ya da sekilli solid (hucre bazinda kaba test: LOS, minimap, kirma)
+    bool solidAtTile(int tx, int ty) const { return inside(tx, ty) && (bit(m_solid, tx, ty) || bit(m_shaped, tx, ty)); }
+    bool oneWayAtTile(int tx, int ty) const { return inside(tx, ty) && bit(m_oneWay, tx, ty); }
+
+    // Bit-packed span sorgulari (satir basina 64-bit word, maske + ctz/clz).
+    // Sinir disi hucreler bos sayilir; araliklar dahil ([tx0,tx1]).
+    // MASK_SOLID sadece tam bloklar; sekilli hucreler MASK_SHAPED. MASK_BLOCK = tam blok |
+    // one-way (profil okumayan dar faz), MASK_ANY hepsi.
+    enum : uint8_t { MASK_SOLID = 1, MASK_ONEWAY = 2, MASK_BLOCK = 3, MASK_SHAPED = 4, MASK_ANY = 7 };
+    bool anyInRow(int ty, int tx0, int tx1, uint8_t mask) const;
+    int  firstInRow(int ty, int tx0, int tx1, uint8_t mask) const; // en soldaki sutun, yoksa -1
+    int  lastInRow(int ty, int tx0, int tx1, uint8_t mask) const;  // en sagdaki sutun, yoksa -1
+    bool anyInCol(int tx, int ty0, int ty1, uint8_t mask) const;
+    // tyFrom'dan tyTo'ya (iki yonde de) ilerle: span'da hucre olan ilk satir, yoksa -1
+    int  scanRows(int tx0, int tx1, int tyFrom, int tyTo, uint8_t mask) const;
+    size_t collisionBytes() const { return (m_solid.size() + m_oneWay.size() + m_shaped.size()) * sizeof(uint64_t); }
+    // Runtime edit: tek hucreyi -1/0/1 (ya da CSV tile index) yap. Birlesik dikdortgenler
+    // kirli kalir; bakeDirtyRects() (TMJMap::flushEdits) sadece kirli satir bandini yeniler.
+    void setCell(int tx, int ty, int idx);
+    bool rectsDirty() const { return m_rectsDirty; }
+
+    // --- Sekilli solid hucreler (yarim blok, egimler) ---
+    // Tileset tile property'si "shape" ile gelir. Bu hucreler m_solid yerine m_shaped
+    // bitplane'indedir; yuzey yuksekligi sekil basina onceden hesaplanmis profil tablosundan
+    // (piksel sutunu -> alttan yukseklik) okunur. _R: saga dogru yukselir, _L: sola dogru.
+    // 22.5 derece egimler iki tile'a yayilir: _LO alt yari, _HI ust yari.
+    enum TileShape : uint8_t {
+        SHAPE_FULL = 0, SHAPE_HALF,
+        SHAPE_SLOPE45_R, SHAPE_SLOPE45_L,
+        SHAPE_SLOPE22_R_LO, SHAPE_SLOPE22_R_HI, SHAPE_SLOPE22_L_LO, SHAPE_SLOPE22_L_HI,
+        SHAPE_COUNT
+    };
+    static uint8_t shapeFromName(const std::string& name); // bilinmeyen -> SHAPE_FULL
+    static uint8_t mirrorShape(uint8_t shape);             // yatay flip (R <-> L)
+    // Solid hucrenin seklini degistir (SHAPE_FULL: tam bloga don). Bos/one-way hucrede etkisiz.
+    void setShape(int tx, int ty, uint8_t shape);
+    uint8_t shapeAt(int tx, int ty) const {
+        return (!m_shape.empty() && inside(tx, ty)) ? m_shape[(size_t)ty * m_cols + tx] : (uint8_t)SHAPE_FULL;
+    }
+    bool hasShapes() const { return !m_shape.empty(); }
+    // Sekilli hucrenin world x araliginda [x0,x1] en yuksek yuzeyi (world y). Profiller
+    // monoton oldugundan aralik uclarindaki iki tablo okumasi yeter.
+    float shapeTop(int tx, int ty, float x0, float x1) const;
+
+    // Greedy-merge edilmis collision dikdortgenleri (tile biriminde). Solid bloklar once
+    // yatay sonra dikey birlesir; one-way'ler her satir ayri bir ust yuzey oldugu icin
+    // sadece yatay. Sekilli hucreler kendi turunde, yatay kosular halinde (kaba kutu; dar
+    // faz profilden). bakeRects() bitplane'lerden uretir (buildCollision cagirir).
+    struct CollisionRect { int16_t tx, ty, tw, th; uint8_t kind; }; // kind: MASK_SOLID / MASK_ONEWAY / MASK_SHAPED
+    void bakeRects();
+    // Sadece kirli satirlar yeniden birlestirilir; bunlara tasan dikdortgenler kirpilir
+    void bakeDirtyRects();
+    const std::vector<CollisionRect>& rects() const { return m_rects; }
+    // [tx0,tx1]x[ty0,ty1] ile kesisen dikdortgen indeksleri (tekrarsiz, artan)
+    void rectsIn(int tx0, int ty0, int tx1, int ty1, uint8_t mask, std::vector<int>& out) const;
+    // Debug: gorunur dikdortgenler, dikdortgen basina bir fillRect
+    void drawCollisionDebug(Renderer2D& r2d) const;
+
+    // --- Sahne sorgulari (world px) ---
+    // One-way hucreler sadece yukaridan asagi girilirken (ny = -1) engeller. Sekilli hucreler
+    // (MASK_SHAPED) profil tablosuna karsi test edilir; normal egim yuzeyinden.
+    // Harita disi bos sayilir. Baslangicta zaten solid icindeyse t = 0, normal (0,0).
+    struct RayHit {
+        bool    hit = false;
+        float   t = 0.f;            // raycast: px mesafe, boxcast: [0,1] oran
+        float   x = 0.f, y = 0.f;   // temas noktasi (boxcast: kutu merkezi)
+        float   nx = 0.f, ny = 0.f; // yuzey normali
+        int     tx = -1, ty = -1;   // carpilan hucre (boxcast: -1)
+        uint8_t kind = 0;           // MASK_SOLID / MASK_ONEWAY / MASK_SHAPED
+    };
+    struct Ray { float x, y, dx, dy, maxDist; }; // dx,dy normalize edilmis olmali
+
+    // Satir satir span walk: her satirda gecilen sutunlar tek word-wide sorgu
+    bool raycast(float x, float y, float dx, float dy, float maxDist, uint8_t mask, RayHit& out) const;
+    // Kolaylik: isinlari sirayla raycast eder (ayri bir toplu cekirdek yok)
+    void raycastBatch(const Ray* rays, int count, uint8_t mask, RayHit* out) const;
+    // AABB'yi (cx,cy,halfW,halfH) (dx,dy) boyunca sweep et: ilk temas t in [0,1]
+    bool boxcast(float cx, float cy, float halfW, float halfH, float dx, float dy, uint8_t mask, RayHit& out) const;
+    // [x0,x1)x[y0,y1) bolgesinde maskeli hucre var mi / kesisen birlesik dikdortgenler
+    bool overlap(float x0, float y0, float x1, float y1, uint8_t mask) const;
+    void overlapRects(float x0, float y0, float x1, float y1, uint8_t mask, std::vector<int>& out) const;
+    // Toplu nokta sorgusu (partikuller): out[i] = (x[i],y[i]) hucresinin maskesi
+    // (MASK_SOLID / MASK_ONEWAY / MASK_SHAPED, bos ya da harita disi 0)
+    void pointMasks(const float* x, const float* y, int n, uint8_t* out) const;
 
 
 
 
 private:
+    bool inside(int tx, int ty) const { return (unsigned)tx < (unsigned)m_cols && (unsigned)ty < (unsigned)m_rows; }
+    bool bit(const std::vector<uint64_t>& plane, int tx, int ty) const {
+        return (plane[(size_t)ty * m_words + (size_t)(tx >> 6)] >> (tx & 63)) & 1u;
+    }
+    uint64_t rowWord(int ty, int w, uint8_t mask) const {
+        const size_t i = (size_t)ty * m_words + (size_t)w;
+        return ((mask & MASK_SOLID) ? m_solid[i] : 0u) | ((mask & MASK_ONEWAY) ? m_oneWay[i] : 0u)
+             | ((mask & MASK_SHAPED) ? m_shaped[i] : 0u);
+    }
+    void rebuildBits(const std::vector<int>& cells);
+    int spanFirst(int ty, int tx0, int tx1) const;   // solid, ty gecerli olmali
+    int spanLast(int ty, int tx0, int tx1) const;
+    uint8_t cellMask(int tx, int ty) const {
+        if (!inside(tx, ty)) return 0;
+        return bit(m_solid, tx, ty) ? MASK_SOLID : (bit(m_oneWay, tx, ty) ? MASK_ONEWAY
+             : (bit(m_shaped, tx, ty) ? MASK_SHAPED : 0));
+    }
+    // Sekilli hucre dar fazi. Isin: [ta,tb] (hucre icindeki parca) piksel sutunlari boyunca;
+    // ta'da zaten profilin altindaysa normal (enx,eny). Kutu: sweep t in [0,1].
+    bool shapeRayHit(int tx, int ty, float x, float y, float dx, float dy, float ta, float tb,
+        float enx, float eny, float& t, float& nx, float& ny) const;
+    bool shapeBoxHit(int tx, int ty, float cx, float cy, float halfW, float halfH, float dx, float dy,
+        float& t, float& nx, float& ny) const;
+    bool shapeBoxOverlaps(int tx, int ty, float x0, float y0, float x1, float y1) const;
+
     Texture m_tileset;
     int m_tile = 32;
     int m_margin = 0, m_spacing = 0;
     int m_cols = 0, m_rows = 0;
-    std::vector<int> m_data; // row-major
+    std::vector<int> m_data; // row-major (sadece CSV: cizim icin tile index)
+    int m_words = 0;                 // satir basina 64-bit word
+    std::vector<uint64_t> m_solid;   // rows*m_words
+    std::vector<uint64_t> m_oneWay;
+    std::vector<uint64_t> m_shaped;  // SHAPE_FULL olmayan solid hucreler
+    std::vector<uint8_t>  m_shape;   // cols*rows sekil; ilk setShape'te ayrilir
+    std::vector<uint16_t> m_profile; // SHAPE_COUNT * m_tile: sutun -> alttan yukseklik
+    void buildProfiles();
+
+    // bakeRects ciktisi + CSR grid index (RECT_CELL x RECT_CELL tile'lik hucreler)
+    static constexpr int RECT_CELL = 16;
+    std::vector<CollisionRect> m_rects;
+    int m_rectCols = 0, m_rectRows = 0;
+    std::vector<int> m_rectStart, m_rectItems;
+    bool m_rectsDirty = false;
+    std::vector<int> m_dirtyRows;      // setCell/setShape'in dokundugu satirlar (tekrarli)
+    void markRectsDirty(int ty) { m_dirtyRows.push_back(ty); m_rectsDirty = true; }
+    void bakeBand(int ty0, int ty1);   // [ty0,ty1] satirlarini m_rects'e ekler
+    void indexRects();                 // m_rects -> CSR grid
 };
 
 } // namespace Erlik
\ No newline at end of file
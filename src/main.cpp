@@ -1,8 +1,17 @@
 #include <SDL.h>
+#include <cstring>
 #include "engine/Application.h"
+#include "engine/Bench.h"
+#include "engine/TMJMap.h"
 
 int main(int argc, char** argv) {
-    (void)argc; (void)argv;
+    // Headless benchmark'lar: erlik --bench <name> [args...]
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+        return Erlik::runBench(argc - 2, argv + 2);
+    // Offline harita donusturucu: erlik --bake <map.tmj> [out.tmjb]
+    if (argc > 2 && std::strcmp(argv[1], "--bake") == 0)
+        return Erlik::TMJMap::bake(argv[2], argc > 3 ? argv[3] : "") ? 0 : 1;
+
     Erlik::Application app;
     return app.run();
-}
\ No newline at end of file
+}